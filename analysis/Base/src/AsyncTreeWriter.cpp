@@ -0,0 +1,209 @@
+///////////////////////////////////////////////////////////////////////////////////
+//
+//  Analysis package
+//
+// --------------------------------------------------------------------------------
+//
+//  AUTHOR: Miguel Ramos Pernas
+//  e-mail: miguel.ramos.pernas@cern.ch
+//
+//  Last update: 18/10/2026
+//
+// --------------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////////
+
+
+#include "AsyncTreeWriter.hpp"
+#include "Exceptions.hpp"
+#include "Messenger.hpp"
+
+#include "TObjArray.h"
+#include "TROOT.h"
+
+#include <algorithm>
+
+
+//_______________________________________________________________________________
+
+namespace isis {
+
+  //_______________________________________________________________________________
+  //
+  AsyncTreeWriter::AsyncTreeWriter( TTree *tree,
+				    const std::vector<TBranch*> &branches,
+				    const Variables &variables,
+				    const size_t &batchSize,
+				    const size_t &nbatches ) :
+    fTree( tree ),
+    fBranches( branches ),
+    fRow( variables.size() ),
+    fComplete( false ),
+    fBatchSize( batchSize ),
+    fBatches( nbatches ),
+    fCurrent( 0 ),
+    fBusy( false ),
+    fStop( false ) {
+
+    if ( !batchSize || !nbatches )
+      throw BaseException( "The number of batches and their size must be positive" );
+
+    // The branches take the values from the row written by the background
+    // thread, while the variables are modified by the calling thread
+    for ( size_t i = 0; i < variables.size(); ++i ) {
+
+      fSources.push_back( static_cast<Slot*>(variables[ i ].second) );
+
+      TBranch *branch = fTree->GetBranch( variables[ i ].first.c_str() );
+
+      if ( branch ) {
+	branch->SetAddress( &fRow[ i ] );
+	fBound.push_back( std::make_pair( branch, variables[ i ].second ) );
+      }
+    }
+
+    fComplete = ( int(fBound.size()) == fTree->GetListOfBranches()->GetEntries() );
+
+    for ( auto it = fBatches.begin(); it != fBatches.end(); ++it ) {
+      it->values.resize( batchSize*variables.size() );
+      it->branches.resize( batchSize );
+      it->size = 0;
+      fFree.push_back( &(*it) );
+    }
+
+    fCurrent = fFree.back();
+    fFree.pop_back();
+
+    // The tree is only accessed by the background thread, but Root may use
+    // global objects when writing to the file
+    ROOT::EnableThreadSafety();
+
+    fThread = std::thread( &AsyncTreeWriter::write, this );
+  }
+
+  //_______________________________________________________________________________
+  //
+  AsyncTreeWriter::~AsyncTreeWriter() {
+
+    // Exceptions can not be propagated from the destructor, so errors are only
+    // reported. Call < flush > before to handle them.
+    try {
+      this->flush();
+    }
+    catch ( std::exception &e ) {
+      IError << "Failed to write the pending events to the tree: " << e.what() << IEndMsg;
+    }
+    catch ( ... ) {
+      IError << "Failed to write the pending events to the tree" << IEndMsg;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock( fMutex );
+      fStop = true;
+    }
+    fCondition.notify_all();
+
+    fThread.join();
+
+    for ( auto it = fBound.begin(); it != fBound.end(); ++it )
+      it->first->SetAddress( it->second );
+  }
+
+  //_______________________________________________________________________________
+  //
+  void AsyncTreeWriter::flush() {
+
+    if ( fCurrent->size )
+      this->submit();
+
+    std::unique_lock<std::mutex> lock( fMutex );
+
+    fCondition.wait( lock, [this] { return fFull.empty() && !fBusy; } );
+
+    this->checkError();
+  }
+
+  //_______________________________________________________________________________
+  //
+  void AsyncTreeWriter::submit() {
+
+    std::unique_lock<std::mutex> lock( fMutex );
+
+    fFull.push_back( fCurrent );
+    fCondition.notify_all();
+
+    fCondition.wait( lock, [this] { return !fFree.empty(); } );
+
+    fCurrent = fFree.back();
+    fFree.pop_back();
+
+    this->checkError();
+  }
+
+  //_______________________________________________________________________________
+  //
+  void AsyncTreeWriter::checkError() {
+
+    if ( fError ) {
+
+      std::exception_ptr error = fError;
+      fError = std::exception_ptr();
+
+      std::rethrow_exception( error );
+    }
+  }
+
+  //_______________________________________________________________________________
+  //
+  void AsyncTreeWriter::write() {
+
+    std::unique_lock<std::mutex> lock( fMutex );
+
+    while ( true ) {
+
+      fCondition.wait( lock, [this] { return fStop || !fFull.empty(); } );
+
+      if ( fFull.empty() )
+	break;
+
+      Batch *batch = fFull.front();
+      fFull.pop_front();
+
+      fBusy = true;
+
+      lock.unlock();
+
+      try {
+
+	const size_t nvars = fRow.size();
+
+	const Slot *values = batch->values.data();
+
+	for ( size_t i = 0; i < batch->size; ++i, values += nvars ) {
+
+	  std::copy( values, values + nvars, fRow.begin() );
+
+	  if ( batch->branches[ i ] )
+	    for ( auto it = fBranches.begin(); it != fBranches.end(); ++it )
+	      (*it)->Fill();
+	  else
+	    fTree->Fill();
+	}
+      }
+      catch ( ... ) {
+
+	std::lock_guard<std::mutex> guard( fMutex );
+	fError = std::current_exception();
+      }
+
+      batch->size = 0;
+
+      lock.lock();
+
+      fFree.push_back( batch );
+      fBusy = false;
+
+      fCondition.notify_all();
+    }
+  }
+
+}
@@ -0,0 +1,200 @@
+///////////////////////////////////////////////////////////////////////////////////
+//
+//  Analysis package
+//
+// --------------------------------------------------------------------------------
+//
+//  AUTHOR: Miguel Ramos Pernas
+//  e-mail: miguel.ramos.pernas@cern.ch
+//
+//  Last update: 18/10/2026
+//
+// --------------------------------------------------------------------------------
+//
+//  Description:
+//
+//  Defines the class to fill a Root tree on a background thread. The values of
+//  the variables are copied for each event to a batch, and the full batches are
+//  given to the background thread, which sets the values in the addresses of
+//  the branches and fills the tree (or the given branches) event by event. The
+//  order and the values of the entries are hence the same as if the tree was
+//  filled on the calling thread. If the implicit multi-threading of Root is
+//  enabled, the baskets are also compressed in parallel by < TTree::Fill >. The
+//  number of batches is fixed, so the calling thread waits for the background
+//  thread if all of them are full. The tree must not be accessed from other
+//  threads until the writer is flushed.
+//
+// --------------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef ASYNC_TREE_WRITER
+#define ASYNC_TREE_WRITER
+
+#include "BufferArena.hpp"
+#include "Exceptions.hpp"
+
+#include "TBranch.h"
+#include "TTree.h"
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+//_______________________________________________________________________________
+
+namespace isis {
+
+  class AsyncTreeWriter {
+
+  public:
+
+    // Definition of internal variables
+    typedef BufferArena::Slot Slot;
+    typedef std::vector<std::pair<std::string, void*> > Variables;
+
+    // Constructor given the tree, the branches to fill when calling
+    // < fillBranches >, the names and addresses of the variables (as given by
+    // a BufferArena), the number of events in each batch and the number of
+    // batches. The addresses of the branches of the variables are modified
+    // until the writer is destroyed.
+    AsyncTreeWriter( TTree *tree,
+		     const std::vector<TBranch*> &branches,
+		     const Variables &variables,
+		     const size_t &batchSize = 1000,
+		     const size_t &nbatches = 4 );
+
+    // Destructor. The pending events are written and the addresses of the
+    // branches are restored. Errors found while writing the events are only
+    // reported, so < flush > must be called before to handle them.
+    ~AsyncTreeWriter();
+
+    // Stores the current values of the variables to fill the tree
+    inline void fill();
+
+    // Stores the current values of the variables to fill the branches
+    inline void fillBranches();
+
+    // Waits until all the stored events are written. Errors raised on the
+    // background thread are propagated.
+    void flush();
+
+  protected:
+
+    // Batch of events
+    struct Batch {
+
+      // Values of the variables for each event
+      std::vector<Slot> values;
+
+      // Whether to fill the branches or the tree for each event
+      std::vector<char> branches;
+
+      // Number of events
+      size_t size;
+    };
+
+    // Tree to fill
+    TTree *fTree;
+
+    // Branches to fill when calling < fillBranches >
+    std::vector<TBranch*> fBranches;
+
+    // Addresses of the values of the variables
+    std::vector<Slot*> fSources;
+
+    // Branches of the variables and their original addresses
+    std::vector<std::pair<TBranch*, void*> > fBound;
+
+    // Values of the variables for the entry being written by the background
+    // thread, which are the addresses of the branches
+    std::vector<Slot> fRow;
+
+    // Whether all the branches of the tree are bound to the variables
+    bool fComplete;
+
+    // Number of events in each batch
+    size_t fBatchSize;
+
+    // Pool of batches
+    std::vector<Batch> fBatches;
+
+    // Batch being filled on the calling thread
+    Batch *fCurrent;
+
+    // Batches waiting to be written, and those that can be filled
+    std::deque<Batch*> fFull;
+    std::vector<Batch*> fFree;
+
+    // Whether the background thread is writing a batch
+    bool fBusy;
+
+    // Whether the background thread must finish
+    bool fStop;
+
+    // Error raised in the background thread
+    std::exception_ptr fError;
+
+    // Synchronization of the threads
+    std::mutex fMutex;
+    std::condition_variable fCondition;
+
+    // Background thread
+    std::thread fThread;
+
+  private:
+
+    // Stores the values of the variables, filling the tree or the branches
+    inline void push( const char &branches );
+
+    // Gives the current batch to the background thread and takes a free one
+    void submit();
+
+    // Rethrows the error raised on the background thread, if any. The mutex
+    // must be locked.
+    void checkError();
+
+    // Function executed by the background thread
+    void write();
+
+  };
+
+  //_______________________________________________________________________________
+  //
+  inline void AsyncTreeWriter::fill() {
+
+    if ( !fComplete )
+      throw BaseException( "Unable to fill the tree asynchronously; "
+			   "some of its branches are not booked" );
+
+    this->push( false );
+  }
+
+  //_______________________________________________________________________________
+  //
+  inline void AsyncTreeWriter::fillBranches() { this->push( true ); }
+
+  //_______________________________________________________________________________
+  //
+  inline void AsyncTreeWriter::push( const char &branches ) {
+
+    Slot *row = fCurrent->values.data() + fCurrent->size*fSources.size();
+
+    for ( auto it = fSources.begin(); it != fSources.end(); ++it, ++row )
+      *row = **it;
+
+    fCurrent->branches[ fCurrent->size ] = branches;
+
+    if ( ++fCurrent->size == fBatchSize )
+      this->submit();
+  }
+
+}
+
+#endif
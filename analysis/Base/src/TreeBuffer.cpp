@@ -7,13 +7,14 @@
 //  AUTHOR: Miguel Ramos Pernas
 //  e-mail: miguel.ramos.pernas@cern.ch
 //
-//  Last update: 10/04/2017
+//  Last update: 18/10/2026
 //
 // --------------------------------------------------------------------------------
 ///////////////////////////////////////////////////////////////////////////////////
 
 
 #include "Definitions.hpp"
+#include "Exceptions.hpp"
 #include "TreeBuffer.hpp"
 #include "TreeManagement.hpp"
 #include "Utils.hpp"
@@ -40,18 +41,32 @@ namespace isis {
   //
   void TreeBuffer::attachTree( TTree *tree ) {
 
-    for ( auto it = fVarMap.begin(); it != fVarMap.end(); ++it )
-      delete it->second;
-  
-    fVarMap.clear();
+    this->stopAsync();
+
+    this->clear();
 
     fTree = tree;
   }
 
+  //_______________________________________________________________________________
+  //
+  void TreeBuffer::clear() {
+
+    if ( fWriter )
+      throw BaseException( "Unable to remove the variables while filling the tree "
+			   "asynchronously" );
+
+    BufferArray::clear();
+  }
+
   //_______________________________________________________________________________
   //
   BufferVariable* TreeBuffer::createVariable( const std::string &name, const char &type ) {
 
+    if ( fWriter )
+      throw BaseException( "Unable to create variable < " + name +
+			   " > while filling the tree asynchronously" );
+
     BufferVariable *var = this->addVariable( name, type );
     void *path      = var->pathToValue();
     TBranch *branch = fTree->Branch( name.c_str(), path, (name + '/' + type).c_str() );
@@ -67,6 +82,8 @@ namespace isis {
     Strings variables;
     getBranchNames( variables, fTree, expr );
 
+    this->reserve( variables.size() );
+
     for ( auto it = variables.begin(); it != variables.end(); ++it )
       this->loadVariable( *it );
   }
@@ -75,6 +92,14 @@ namespace isis {
   //
   BufferVariable* TreeBuffer::loadVariable( const std::string &name ) {
 
+    if ( fWriter )
+      throw BaseException( "Unable to load variable < " + name +
+			   " > while filling the tree asynchronously" );
+
+    // The buffer variables hold a single value
+    if ( !isScalarBranch( fTree, name ) )
+      throw BaseException( "Branch < " + name + " > does not hold a single value" );
+    
     BufferVariable *var = this ->
       addVariable( name, getVarType( fTree, name ) );
     void *path = var->pathToValue();
@@ -102,4 +127,31 @@ namespace isis {
     }
   }
 
+  //_______________________________________________________________________________
+  //
+  void TreeBuffer::startAsync( const size_t &batchSize, const size_t &nbatches ) {
+
+    if ( fWriter )
+      throw BaseException( "The tree is already being filled asynchronously" );
+
+    AsyncTreeWriter::Variables variables;
+    variables.reserve( fVarMap.size() );
+
+    for ( auto it = fVarMap.begin(); it != fVarMap.end(); ++it )
+      variables.push_back( std::make_pair( it->first, it->second->pathToValue() ) );
+
+    fWriter.reset( new AsyncTreeWriter( fTree, fBranchVector, variables,
+					batchSize, nbatches ) );
+  }
+
+  //_______________________________________________________________________________
+  //
+  void TreeBuffer::stopAsync() {
+
+    if ( fWriter ) {
+      fWriter->flush();
+      fWriter.reset();
+    }
+  }
+
 }
@@ -7,7 +7,7 @@
 //  AUTHOR: Miguel Ramos Pernas
 //  e-mail: miguel.ramos.pernas@cern.ch
 //
-//  Last update: 10/04/2017
+//  Last update: 18/10/2026
 //
 // --------------------------------------------------------------------------------
 //
@@ -15,7 +15,16 @@
 //
 //  Defines the class to help when performing input/output operations from Root
 //  TTree objects. It is meant to be used to allow the user to work with the
-//  variables that are present in the tree without knowing its type.
+//  variables that are present in the tree without knowing its type. If the type
+//  is known, the variables can be created or loaded as < TypedBuffer > handles,
+//  to access the values in event loops without any run-time dispatch.
+//  The tree can be filled asynchronously, delegating the calls to
+//  < TTree::Fill > and < TBranch::Fill > to a background thread (see
+//  < AsyncTreeWriter >). In that case, the tree must not be used until the
+//  buffer is flushed or the asynchronous mode is stopped, and the variables can
+//  not be added or removed. The errors found while writing the events are
+//  raised by < flush > and < stopAsync >, so one of them must be called before
+//  destroying the buffer to handle them.
 //
 // --------------------------------------------------------------------------------
 ///////////////////////////////////////////////////////////////////////////////////
@@ -24,11 +33,18 @@
 #ifndef TREE_BUFFER
 #define TREE_BUFFER
 
+#include "AsyncTreeWriter.hpp"
 #include "BufferArray.hpp"
+#include "Exceptions.hpp"
+#include "TreeManagement.hpp"
+#include "TypedBuffer.hpp"
+#include "ValueTypeDef.hpp"
 
 #include "TBranch.h"
 #include "TTree.h"
 
+#include <memory>
+
 
 //_______________________________________________________________________________
 
@@ -57,9 +73,18 @@ namespace isis {
     // removed.
     void attachTree( TTree *tree );
 
+    // Removes the variables booked in this class. It can not be called while
+    // filling the tree asynchronously.
+    virtual void clear();
+
     // Creates a new variable in the attached tree given the name and its type
     BufferVariable* createVariable( const std::string &name, const char &type );
 
+    // Creates a new variable in the attached tree with the given type, returning
+    // the handle to its value
+    template<class type>
+    inline TypedBuffer<type> createVariable( const std::string &name );
+
     // Loads the variables satisfying the requirements in the given expression
     void load( const std::string &expr );
 
@@ -68,21 +93,41 @@ namespace isis {
     // address to.
     BufferVariable* loadVariable( const std::string &name );
 
+    // Loads a variable from the attached tree, returning the handle to its value.
+    // The type of the branch must correspond to that requested. If the variable
+    // is already booked, the handle to it is returned.
+    template<class type>
+    inline TypedBuffer<type> loadVariable( const std::string &name );
+
     // Changes the status of the branches in the attached tree to that given to the
     // function
     void setBranchStatus( const bool &dec );
 
+    // Starts filling the tree asynchronously, given the number of events in each
+    // batch and the number of batches. The variables must be booked before.
+    void startAsync( const size_t &batchSize = 1000, const size_t &nbatches = 4 );
+
+    // Writes the pending events and goes back to fill the tree on the calling
+    // thread. Errors found while writing the events are propagated.
+    void stopAsync();
+
     // Fills the attached tree
     inline void fill();
 
     // Fills the branches stored in the class
     inline void fillBranches();
 
+    // Waits until the events filled asynchronously are written to the tree
+    inline void flush();
+
     // Returns the vector with the branches attached to this class
     inline BranchVector& getBranchVector();
 
     // Returns the attached tree
     inline TTree* getTree();
+
+    // Returns whether the tree is being filled asynchronously
+    inline bool isAsync() const;
     
   protected:
     
@@ -91,19 +136,66 @@ namespace isis {
 
     // Vector of branches
     BranchVector fBranchVector;
+
+    // Writer used to fill the tree asynchronously
+    std::unique_ptr<AsyncTreeWriter> fWriter;
     
   };
 
   //_______________________________________________________________________________
   //
-  inline void TreeBuffer::fill() { fTree->Fill(); }
+  template<class type>
+  inline TypedBuffer<type> TreeBuffer::createVariable( const std::string &name ) {
+
+    this->createVariable( name, typeCode<type>() );
+
+    return this->getBuffer<type>( name );
+  }
+
+  //_______________________________________________________________________________
+  //
+  template<class type>
+  inline TypedBuffer<type> TreeBuffer::loadVariable( const std::string &name ) {
+
+    if ( !this->contains( name ) ) {
+
+      if ( getVarType( fTree, name ) != typeCode<type>() )
+	throw BaseException( "Branch < " + name + " > does not have type < " +
+			     typeCode<type>() + " >" );
+
+      this->loadVariable( name );
+    }
+
+    return this->getBuffer<type>( name );
+  }
+
+  //_______________________________________________________________________________
+  //
+  inline void TreeBuffer::fill() {
+
+    if ( fWriter )
+      fWriter->fill();
+    else
+      fTree->Fill();
+  }
 
   //_______________________________________________________________________________
   //
   inline void TreeBuffer::fillBranches() {
-    
-    for ( auto it = fBranchVector.begin(); it != fBranchVector.end(); ++it )
-      (*it)->Fill();
+
+    if ( fWriter )
+      fWriter->fillBranches();
+    else
+      for ( auto it = fBranchVector.begin(); it != fBranchVector.end(); ++it )
+	(*it)->Fill();
+  }
+
+  //_______________________________________________________________________________
+  //
+  inline void TreeBuffer::flush() {
+
+    if ( fWriter )
+      fWriter->flush();
   }
 
   //_______________________________________________________________________________
@@ -115,6 +207,10 @@ namespace isis {
   //_______________________________________________________________________________
   //
   inline TTree* TreeBuffer::getTree() { return fTree; }
+
+  //_______________________________________________________________________________
+  //
+  inline bool TreeBuffer::isAsync() const { return bool(fWriter); }
   
 }
 
@@ -7,7 +7,7 @@
 //  AUTHOR: Miguel Ramos Pernas
 //  e-mail: miguel.ramos.pernas@cern.ch
 //
-//  Last update: 19/10/2017
+//  Last update: 18/10/2026
 //
 // ------------------------------------------------------
 /////////////////////////////////////////////////////////
@@ -19,6 +19,7 @@
 #include "Utils.hpp"
 
 #include "TBranch.h"
+#include "TBranchElement.h"
 #include "TDirectory.h"
 #include "TLeaf.h"
 #include "TObjArray.h"
@@ -123,11 +124,38 @@ namespace isis {
     
     if ( !obj )
       throw NotFound("branch", var);
+
+    // The type follows the first slash in the title, after the name and
+    // the dimensions of the leaf (e.g. "x/D" or "x[n]/D")
+    std::string title = obj->GetTitle();
+
+    size_t pos = title.find('/');
+    if ( pos == std::string::npos || pos + 1 == title.size() )
+      throw BaseException("Unable to determine the type of branch < " + var + " >");
     
-    std::string type = obj->GetTitle();
-    type.replace(0, var.length(), "");
+    return title[pos + 1];
+  }
+
+  //_______________________________________________________________________________
+  //
+  bool isScalarBranch( TTree *inputTree, const std::string &var ) {
+
+    TBranch *branch = inputTree->GetBranch(var.c_str());
+
+    if ( !branch )
+      throw NotFound("branch", var);
+
+    // Branches holding objects (like std::vector) are not scalars
+    if ( dynamic_cast<TBranchElement*>(branch) )
+      return false;
     
-    return type[1];
+    TObjArray *leaves = branch->GetListOfLeaves();
+    if ( leaves->GetEntries() != 1 )
+      return false;
+
+    TLeaf *leaf = static_cast<TLeaf*>(leaves->At(0));
+
+    return !leaf->GetLeafCount() && leaf->GetLenStatic() == 1;
   }
 
 }
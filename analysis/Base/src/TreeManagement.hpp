@@ -7,7 +7,7 @@
 //  AUTHOR: Miguel Ramos Pernas
 //  e-mail: miguel.ramos.pernas@cern.ch
 //
-//  Last update: 18/09/2017
+//  Last update: 18/10/2026
 //
 // -------------------------------------------------------
 //
@@ -63,6 +63,10 @@ namespace isis {
   // Gets the type of a variable in a tree
   char getVarType( TTree *inputTree, const std::string &var );
 
+  // Return whether the given branch holds a single value per entry. Arrays,
+  // leaf lists and objects are not considered as scalars.
+  bool isScalarBranch( TTree *inputTree, const std::string &var );
+
 }
 
 #endif
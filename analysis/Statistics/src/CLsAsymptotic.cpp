@@ -0,0 +1,226 @@
+///////////////////////////////////////////////////////////////////////////////////
+//
+//  Analysis package
+//
+// --------------------------------------------------------------------------------
+//
+//  AUTHOR: Miguel Ramos Pernas
+//  e-mail: miguel.ramos.pernas@cern.ch
+//
+//  Last update: 18/10/2026
+//
+// --------------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////////
+
+
+#include "CLsAsymptotic.hpp"
+#include "CLsFactory.hpp"
+#include "CLsHypothesis.hpp"
+#include "CLsResult.hpp"
+#include "CLsScanResult.hpp"
+#include "Definitions.hpp"
+#include "Exceptions.hpp"
+
+#include "Math/ProbFuncMathCore.h"
+
+#include <cmath>
+#include <string>
+
+
+//_______________________________________________________________________________
+
+namespace isis {
+
+  //_______________________________________________________________________________
+  //
+  CLsAsymptotic::CLsAsymptotic( CLsFactory &factory ) : fFactory( &factory ) { }
+
+  //_______________________________________________________________________________
+  //
+  CLsAsymptotic::~CLsAsymptotic() { }
+
+  //_______________________________________________________________________________
+  //
+  double CLsAsymptotic::alpha( const double &t ) const {
+
+    double mean, sigma;
+    this->nullDistribution(mean, sigma);
+
+    // Probability to obtain a greater value of the test statistic
+    if ( sigma == 0 )
+      return t < mean;
+
+    return ROOT::Math::normal_cdf_c(t, sigma, mean);
+  }
+
+  //_______________________________________________________________________________
+  //
+  double CLsAsymptotic::beta( const double &t ) const {
+
+    double mean, sigma;
+    this->sigDistribution(mean, sigma);
+
+    // Probability to obtain a lower or equal value of the test statistic
+    if ( sigma == 0 )
+      return t >= mean;
+
+    return ROOT::Math::normal_cdf(t, sigma, mean);
+  }
+
+  //_______________________________________________________________________________
+  //
+  CLsResult CLsAsymptotic::calculate( const double &tstat ) const {
+
+    double alpha = this->alpha(tstat);
+    double beta  = this->beta(tstat);
+    double CLb   = 1. - alpha;
+    double CLs   = beta/CLb;
+
+    return CLsResult(CLs, CLb, alpha, beta, tstat);
+  }
+
+  //_______________________________________________________________________________
+  //
+  CLsResult CLsAsymptotic::expected( const double &nsigma ) const {
+
+    double mean, sigma;
+    this->nullDistribution(mean, sigma);
+
+    return this->calculate(mean + nsigma*sigma);
+  }
+
+  //_______________________________________________________________________________
+  //
+  void CLsAsymptotic::nullDistribution( double &mean, double &sigma ) const {
+
+    this->asimov(*fFactory->getNullHyp(), mean, sigma);
+  }
+
+  //_______________________________________________________________________________
+  //
+  void CLsAsymptotic::sigDistribution( double &mean, double &sigma ) const {
+
+    this->asimov(*fFactory->getSigHyp(), mean, sigma);
+  }
+
+  //_______________________________________________________________________________
+  //
+  double CLsAsymptotic::validate( const double &tstat,
+				  const size_t &n,
+				  const size_t &nthreads,
+				  const uint64_t &seed ) {
+
+    fFactory->generate(n, nthreads, seed);
+
+    return fFactory->CLs(tstat) - this->CLs(tstat);
+  }
+
+  //_______________________________________________________________________________
+  //
+  CLsScanResult CLsAsymptotic::scan( const Doubles &bkg,
+				     const Doubles &sig,
+				     const Doubles &mu,
+				     const Doubles &obs ) {
+
+    std::vector<std::vector<CLsResult> > results;
+    results.reserve(mu.size());
+
+    for ( auto it = mu.cbegin(); it != mu.cend(); ++it )
+      results.push_back(scanPoint(bkg, sig, *it, obs));
+
+    return CLsScanResult(mu, results);
+  }
+
+  //_______________________________________________________________________________
+  //
+  double CLsAsymptotic::upperLimit( const Doubles &bkg,
+				    const Doubles &sig,
+				    const double &mumin,
+				    const double &mumax,
+				    const Doubles &obs,
+				    const double &cl,
+				    const int &nsigma,
+				    const double &precision ) {
+
+    if ( nsigma < -CLsScanResult::MaxSigma || nsigma > CLsScanResult::MaxSigma )
+      throw BaseException("The number of standard deviations must be in [" +
+			  std::to_string(-CLsScanResult::MaxSigma) + ", " +
+			  std::to_string(CLsScanResult::MaxSigma) + "]");
+
+    if ( precision <= 0 )
+      throw BaseException("The precision must be greater than zero");
+
+    const double alpha = 1. - cl;
+
+    // Index of the result to use (see < CLsScanResult >)
+    const size_t idx = obs.empty() ?
+      nsigma + CLsScanResult::MaxSigma : 2*CLsScanResult::MaxSigma + 1;
+
+    auto cls = [&] ( const double &mu ) {
+      return scanPoint(bkg, sig, mu, obs)[idx].CLs();
+    };
+
+    double lo = mumin, hi = mumax;
+
+    if ( cls(lo) < alpha )
+      throw BaseException("The upper limit is below the given range");
+
+    if ( cls(hi) >= alpha )
+      throw BaseException("The upper limit is above the given range");
+
+    while ( hi - lo > precision ) {
+
+      const double mid = 0.5*(lo + hi);
+
+      if ( cls(mid) < alpha )
+	hi = mid;
+      else
+	lo = mid;
+    }
+
+    return 0.5*(lo + hi);
+  }
+
+  //_______________________________________________________________________________
+  //
+  void CLsAsymptotic::asimov( const CLsHypothesis &hyp,
+			      double &mean,
+			      double &sigma ) const {
+
+    // If the hypotheses are equal, the distribution is a delta at zero
+    mean  = fFactory->testStat(hyp.getHyp());
+    sigma = 2*std::sqrt(std::abs(mean));
+  }
+
+  //_______________________________________________________________________________
+  //
+  std::vector<CLsResult> CLsAsymptotic::scanPoint( const Doubles &bkg,
+						   const Doubles &sig,
+						   const double &mu,
+						   const Doubles &obs ) {
+
+    if ( bkg.size() != sig.size() )
+      throw BaseException("Background and signal arrays do not have the same sizes");
+
+    Doubles sigmu(bkg);
+    for ( size_t i = 0; i < sigmu.size(); ++i )
+      sigmu[i] += mu*sig[i];
+
+    CLsHypothesis h0(bkg), h1(sigmu);
+    CLsFactory factory(h0, h1);
+
+    CLsAsymptotic calc(factory);
+
+    std::vector<CLsResult> results;
+    results.reserve(2*CLsScanResult::MaxSigma + 2);
+
+    for ( int ns = -CLsScanResult::MaxSigma; ns <= CLsScanResult::MaxSigma; ++ns )
+      results.push_back(calc.expected(ns));
+
+    if ( !obs.empty() )
+      results.push_back(calc.calculate(obs));
+
+    return results;
+  }
+
+}
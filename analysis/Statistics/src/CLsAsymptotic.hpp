@@ -0,0 +1,162 @@
+///////////////////////////////////////////////////////////////////////////////////
+//
+//  Analysis package
+//
+// --------------------------------------------------------------------------------
+//
+//  AUTHOR: Miguel Ramos Pernas
+//  e-mail: miguel.ramos.pernas@cern.ch
+//
+//  Last update: 18/10/2026
+//
+// --------------------------------------------------------------------------------
+//
+//  Description:
+//
+//  Class to calculate the CLs values using asymptotic formulae instead of toys.
+//  Following G. Cowan, K. Cranmer, E. Gross and O. Vitells, Eur. Phys. J. C 71
+//  (2011) 1554, the test statistic of < CLsFactory > follows a normal
+//  distribution under each hypothesis. Its mean is the value obtained for the
+//  Asimov data set of the hypothesis (the data equal to the expected values),
+//  t_A, and its standard deviation is 2*sqrt(|t_A|). The fluctuators of the
+//  hypotheses are not taken into account.
+//
+// --------------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef CLS_ASYMPTOTIC
+#define CLS_ASYMPTOTIC
+
+#include "CLsFactory.hpp"
+#include "CLsResult.hpp"
+#include "CLsScanResult.hpp"
+#include "Definitions.hpp"
+
+#include <cstdint>
+
+
+//_______________________________________________________________________________
+
+namespace isis {
+
+  class CLsAsymptotic {
+
+  public:
+
+    // Constructor given the factory holding the hypotheses. Changes in the
+    // hypotheses are taken into account in the following calculations.
+    CLsAsymptotic( CLsFactory &factory );
+
+    // Destructor
+    ~CLsAsymptotic();
+
+    // Return the p-value of the null hypothesis
+    double alpha( const double &t ) const;
+
+    // Return the p-value of the signal hypothesis
+    double beta( const double &t ) const;
+
+    // Return information concerning the CLs method given the test statistics value
+    CLsResult calculate( const double &tstat ) const;
+
+    // Return information concerning the CLs method given an array
+    inline CLsResult calculate( const Doubles &array ) const;
+
+    // Calculate CLb
+    inline double CLb( const double &t ) const;
+
+    // Calculate CLs
+    inline double CLs( const double &t ) const;
+
+    // Calculate CLsb
+    inline double CLsb( const double &t ) const;
+
+    // Return the expected result for the value of the test statistic located at
+    // < nsigma > standard deviations from the median of the null hypothesis
+    CLsResult expected( const double &nsigma = 0 ) const;
+
+    // Return the median and the standard deviation of the test statistic for the
+    // null hypothesis
+    void nullDistribution( double &mean, double &sigma ) const;
+
+    // Return the median and the standard deviation of the test statistic for the
+    // signal hypothesis
+    void sigDistribution( double &mean, double &sigma ) const;
+
+    // Generate < n > toys with the factory (see < CLsFactory::generate >) and
+    // return the difference between the CLs value obtained from them and the
+    // asymptotic value for the given test statistic. The toys are kept in the
+    // factory, so further comparisons can be done.
+    double validate( const double &tstat,
+		     const size_t &n = 10000,
+		     const size_t &nthreads = 0,
+		     const uint64_t &seed = 0 );
+
+    // Equivalent to < CLsFactory::scan >, using the asymptotic formulae
+    static CLsScanResult scan( const Doubles &bkg,
+			       const Doubles &sig,
+			       const Doubles &mu,
+			       const Doubles &obs = {} );
+
+    // Equivalent to < CLsFactory::upperLimit >, using the asymptotic formulae
+    static double upperLimit( const Doubles &bkg,
+			      const Doubles &sig,
+			      const double &mumin,
+			      const double &mumax,
+			      const Doubles &obs = {},
+			      const double &cl = 0.95,
+			      const int &nsigma = 0,
+			      const double &precision = 1e-6 );
+
+  protected:
+
+    // Factory holding the hypotheses
+    CLsFactory *fFactory;
+
+  private:
+
+    // Calculate the distribution of the test statistic for the Asimov data set
+    // of the given hypothesis
+    void asimov( const CLsHypothesis &hyp, double &mean, double &sigma ) const;
+
+    // Calculate the expected and observed results for the signal strength
+    // < mu >, in the format expected by < CLsScanResult >
+    static std::vector<CLsResult> scanPoint( const Doubles &bkg,
+					     const Doubles &sig,
+					     const double &mu,
+					     const Doubles &obs );
+
+  };
+
+  //_______________________________________________________________________________
+  //
+  inline CLsResult CLsAsymptotic::calculate( const Doubles &array ) const {
+
+    return this->calculate(fFactory->testStat(array));
+  }
+
+  //_______________________________________________________________________________
+  //
+  inline double CLsAsymptotic::CLb( const double &t ) const {
+
+    return 1. - this->alpha(t);
+  }
+
+  //_______________________________________________________________________________
+  //
+  inline double CLsAsymptotic::CLs( const double &t ) const {
+
+    return this->CLsb(t)/this->CLb(t);
+  }
+
+  //_______________________________________________________________________________
+  //
+  inline double CLsAsymptotic::CLsb( const double &t ) const {
+
+    return this->beta(t);
+  }
+
+}
+
+#endif
@@ -7,22 +7,28 @@
 //  AUTHOR: Miguel Ramos Pernas
 //  e-mail: miguel.ramos.pernas@cern.ch
 //
-//  Last update: 19/10/2017
+//  Last update: 18/10/2026
 //
 // --------------------------------------------------------------------------------
 ///////////////////////////////////////////////////////////////////////////////////
 
 
+#include "BinaryIO.hpp"
 #include "CLsFactory.hpp"
 #include "CLsResult.hpp"
 #include "Definitions.hpp"
 #include "Exceptions.hpp"
+#include "Parallel.hpp"
 #include "Utils.hpp"
 
+#include "Math/ProbFuncMathCore.h"
 #include "TMath.h"
 
 #include <algorithm>
 #include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <memory>
 
 
 //_______________________________________________________________________________
@@ -59,6 +65,29 @@ namespace isis {
     return CLsResult(CLs, CLb, alpha, beta, tstat);
   }
 
+  //_______________________________________________________________________________
+  //
+  std::vector<CLsResult> CLsFactory::calculateMany( const double *tstats,
+						    const size_t &n ) const {
+
+    Doubles alphas(n), betas(n);
+
+    fNullHyp->pValues(tstats, n, alphas.data());
+    fSigHyp->pValues(tstats, n, betas.data());
+
+    std::vector<CLsResult> results;
+    results.reserve(n);
+
+    for ( size_t i = 0; i < n; ++i ) {
+
+      const double CLb = 1. - alphas[i];
+
+      results.push_back(CLsResult(betas[i]/CLb, CLb, alphas[i], betas[i], tstats[i]));
+    }
+
+    return results;
+  }
+
   //_______________________________________________________________________________
   //
   void CLsFactory::generate( const size_t &n ) {
@@ -71,15 +100,508 @@ namespace isis {
     fSigHyp->generate(n);
   }
 
+  //_______________________________________________________________________________
+  //
+  void CLsFactory::generate( const size_t &n,
+			     const size_t &nthreads,
+			     const uint64_t &seed ) {
+
+    if ( fNullHyp->getHyp().size() != fSigHyp->getHyp().size() )
+      throw BaseException("Input hypotheses do not have the same sizes");
+    
+    RandomEngine engine(seed);
+
+    fNullHyp->generate(n, nthreads, engine);
+
+    fSigHyp->generate(n, nthreads, engine);
+  }
+
+  //_______________________________________________________________________________
+  //
+  void CLsFactory::generate( const size_t &n,
+			     const size_t &nthreads,
+			     const uint64_t &seed,
+			     const std::string &path,
+			     const size_t &batch ) {
+
+    if ( fNullHyp->getHyp().size() != fSigHyp->getHyp().size() )
+      throw BaseException("Input hypotheses do not have the same sizes");
+
+    if ( !batch )
+      throw BaseException("The size of the batches must be greater than zero");
+
+    std::vector<RandomEngine> nullEngines, sigEngines;
+
+    uint64_t ntoys = 0;
+
+    // Position where the next batch is written
+    std::streampos end;
+
+    std::ifstream ifile(path, std::ios::binary);
+
+    if ( ifile ) {
+
+      uint64_t fseed, fbatch;
+      this->readToysHeader(ifile, path, fseed, fbatch, ntoys, nullEngines, sigEngines);
+
+      if ( fseed != seed || fbatch != batch )
+	throw BaseException("The file \"" + path + "\" was generated with a different "
+			    "seed or size of the batches");
+
+      // Any batch after the last one registered in the header is overwritten
+      this->readToysPositions(ifile, path, ntoys);
+
+      end = ifile.tellg();
+
+      ifile.close();
+    }
+    else {
+
+      const size_t nt = getNthreads(nthreads, n);
+
+      // The streams of the signal hypothesis follow those of the null
+      // hypothesis, so files generated with different seeds never share them
+      RandomEngine engine(seed);
+
+      nullEngines = engine.split(nt);
+      sigEngines  = engine.split(nt);
+
+      std::ofstream ofile(path, std::ios::binary);
+      if ( !ofile )
+	throw BaseException("Unable to open file \"" + path + "\" for writing");
+
+      this->writeToysHeader(ofile, seed, batch, ntoys, nullEngines, sigEngines);
+
+      end = ofile.tellp();
+
+      ofile.close();
+
+      if ( !ofile )
+	throw BaseException("Error writing to file \"" + path + "\"");
+    }
+
+    if ( ntoys < n ) {
+
+      std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+      if ( !file )
+	throw BaseException("Unable to open file \"" + path + "\" for writing");
+
+      // Each batch is generated in copies of the hypotheses, so only its toys
+      // are written to the file
+      CLsHypothesis h0(*fNullHyp), h1(*fSigHyp);
+
+      while ( ntoys < n ) {
+
+	const uint64_t nb = std::min<uint64_t>(batch, n - ntoys);
+
+	h0.clearToys();
+	h1.clearToys();
+
+	h0.generate(nb, nullEngines);
+	h1.generate(nb, sigEngines);
+
+	// The batch is written before updating the header, so the file remains
+	// valid if the process is interrupted
+	file.seekp(end);
+
+	binio::write(file, nb);
+	binio::write(file, uint64_t(0));
+
+	const std::streampos first = file.tellp();
+
+	h0.writeToys(file);
+	h1.writeToys(file);
+
+	const std::streampos last = file.tellp();
+
+	file.seekp(first - std::streamoff(sizeof(uint64_t)));
+	binio::write(file, uint64_t(last - first));
+	file.flush();
+
+	ntoys += nb;
+	end    = last;
+
+	file.seekp(0);
+	this->writeToysHeader(file, seed, batch, ntoys, nullEngines, sigEngines);
+	file.flush();
+
+	if ( !file )
+	  throw BaseException("Error writing to file \"" + path + "\"");
+      }
+    }
+
+    this->merge(Strings(1, path));
+  }
+
+  //_______________________________________________________________________________
+  //
+  double CLsFactory::logLikelihoodRatio( const double *values ) const {
+
+    const Doubles &lmu0 = fNullHyp->getLogHyp();
+    const Doubles &lmu1 = fSigHyp->getLogHyp();
+
+    const double *l0 = lmu0.data();
+    const double *l1 = lmu1.data();
+
+    const size_t n = lmu0.size();
+
+    // Independent partial sums are used so the loop can be vectorised. Channels
+    // without observed entries do not contribute, which also avoids evaluating
+    // 0*log(0) for null means.
+    double s[4] = {0, 0, 0, 0};
+
+    size_t i = 0;
+    for ( ; i + 4 <= n; i += 4 )
+      for ( size_t j = 0; j < 4; ++j )
+	s[j] += values[i + j] > 0 ? values[i + j]*(l1[i + j] - l0[i + j]) : 0.;
+
+    for ( ; i < n; ++i )
+      s[0] += values[i] > 0 ? values[i]*(l1[i] - l0[i]) : 0.;
+
+    return (s[0] + s[1]) + (s[2] + s[3]) - (fSigHyp->getHypSum() - fNullHyp->getHypSum());
+  }
+
+  //_______________________________________________________________________________
+  //
+  void CLsFactory::merge( const Strings &paths ) {
+
+    std::vector<uint64_t> seeds;
+
+    // All the batches are read at once, so the values of each hypothesis are
+    // merged in a single step
+    std::vector<std::unique_ptr<std::ifstream> > files;
+    std::vector<std::istream*> streams;
+    std::vector<std::streampos> positions;
+
+    for ( auto it = paths.cbegin(); it != paths.cend(); ++it ) {
+
+      files.emplace_back(new std::ifstream(*it, std::ios::binary));
+
+      std::ifstream &ifile = *files.back();
+      if ( !ifile )
+	throw NotFound("file", *it);
+
+      uint64_t seed, batch, ntoys;
+      std::vector<RandomEngine> nullEngines, sigEngines;
+
+      this->readToysHeader(ifile, *it, seed, batch, ntoys, nullEngines, sigEngines);
+
+      if ( std::find(seeds.cbegin(), seeds.cend(), seed) != seeds.cend() )
+	throw BaseException("The file \"" + *it + "\" was generated with the same "
+			    "seed as a previous one");
+
+      seeds.push_back(seed);
+
+      std::vector<std::streampos> pos = this->readToysPositions(ifile, *it, ntoys);
+
+      streams.insert(streams.end(), pos.size(), &ifile);
+      positions.insert(positions.end(), pos.cbegin(), pos.cend());
+    }
+
+    // The toys of the signal hypothesis follow those of the null hypothesis in
+    // each batch
+    fNullHyp->readToys(streams, positions);
+    fSigHyp->readToys(streams, positions);
+  }
+
   //_______________________________________________________________________________
   //
   double CLsFactory::testStat( const Doubles &values ) const {
 
-    double t0 = fNullHyp->poissonProb(values);
+    if ( values.size() != fNullHyp->getHyp().size() ||
+	 values.size() != fSigHyp->getHyp().size() )
+      throw BaseException("Input values do not have the same size as the hypotheses");
+
+    double llr = this->logLikelihoodRatio(values.data());
+
+    if ( this->hasPriors() )
+      llr += fSigHyp->logPrior(values.data()) - fNullHyp->logPrior(values.data());
+
+    // The values are sorted, so they must be comparable
+    if ( std::isnan(llr) )
+      throw BaseException("The test statistics is not a number; the priors can not "
+			  "be evaluated for the given values");
+
+    return 2.*llr;
+  }
+
+  //_______________________________________________________________________________
+  //
+  CLsScanResult CLsFactory::scan( const Doubles &bkg,
+				  const Doubles &sig,
+				  const Doubles &mu,
+				  const Doubles &obs,
+				  const size_t &n,
+				  const size_t &nthreads,
+				  const uint64_t &seed,
+				  CLsFluctuator *nullFluct,
+				  CLsPrior *nullPrior,
+				  CLsFluctuator *sigFluct,
+				  CLsPrior *sigPrior ) {
+
+    if ( bkg.size() != sig.size() )
+      throw BaseException("Background and signal arrays do not have the same sizes");
+
+    // Each point is generated in a single thread, so a single stream is used
+    // for each hypothesis
+    std::vector<RandomEngine> engines = RandomEngine(seed).split(2);
+
+    std::vector<RandomEngine> nullEngines(1, engines[0]), sigEngines(1, engines[1]);
+
+    Doubles nullSamples;
+    CLsHypothesis(bkg, nullFluct, nullPrior).generateSamples(n, nullEngines, nullSamples);
+
+    std::vector<std::vector<CLsResult> > results(mu.size());
+
+    const size_t nt = areThreadSafe(nullFluct, nullPrior, sigFluct, sigPrior) ? nthreads : 1;
+
+    parallelFor(mu.size(), nt, [&] ( size_t, size_t first, size_t last ) {
+
+	for ( size_t i = first; i < last; ++i )
+	  results[i] = scanPoint(bkg, sig, mu[i], obs, n, 1, nullSamples, sigEngines,
+				 nullFluct, nullPrior, sigFluct, sigPrior);
+      });
+
+    return CLsScanResult(mu, results);
+  }
+
+  //_______________________________________________________________________________
+  //
+  double CLsFactory::upperLimit( const Doubles &bkg,
+				 const Doubles &sig,
+				 const double &mumin,
+				 const double &mumax,
+				 const Doubles &obs,
+				 const double &cl,
+				 const int &nsigma,
+				 const double &precision,
+				 const size_t &n,
+				 const size_t &nthreads,
+				 const uint64_t &seed,
+				 CLsFluctuator *nullFluct,
+				 CLsPrior *nullPrior,
+				 CLsFluctuator *sigFluct,
+				 CLsPrior *sigPrior ) {
+
+    if ( bkg.size() != sig.size() )
+      throw BaseException("Background and signal arrays do not have the same sizes");
+
+    if ( nsigma < -CLsScanResult::MaxSigma || nsigma > CLsScanResult::MaxSigma )
+      throw BaseException("The number of standard deviations must be in [" +
+			  std::to_string(-CLsScanResult::MaxSigma) + ", " +
+			  std::to_string(CLsScanResult::MaxSigma) + "]");
+
+    if ( precision <= 0 )
+      throw BaseException("The precision must be greater than zero");
+
+    const double alpha = 1. - cl;
+
+    // Index of the result to use (see < CLsScanResult >)
+    const size_t idx = obs.empty() ?
+      nsigma + CLsScanResult::MaxSigma : 2*CLsScanResult::MaxSigma + 1;
+
+    // The first half of the streams is used by the null hypothesis, whose values
+    // are generated once, and the second by the signal hypothesis. A single
+    // thread is used if any of the fluctuators or priors is not thread-safe.
+    const size_t nt = areThreadSafe(nullFluct, nullPrior, sigFluct, sigPrior) ?
+      getNthreads(nthreads, n) : 1;
+
+    std::vector<RandomEngine> engines = RandomEngine(seed).split(2*nt);
+
+    std::vector<RandomEngine>
+      nullEngines(engines.begin(), engines.begin() + nt),
+      sigEngines(engines.begin() + nt, engines.end());
+
+    Doubles nullSamples;
+    CLsHypothesis(bkg, nullFluct, nullPrior).generateSamples(n, nullEngines, nullSamples);
+
+    auto cls = [&] ( const double &mu ) {
+      return scanPoint(bkg, sig, mu, obs, n, nt, nullSamples, sigEngines,
+		       nullFluct, nullPrior, sigFluct, sigPrior)[idx].CLs();
+    };
+
+    double lo = mumin, hi = mumax;
+
+    if ( cls(lo) < alpha )
+      throw BaseException("The upper limit is below the given range");
+
+    if ( cls(hi) >= alpha )
+      throw BaseException("The upper limit is above the given range");
+
+    while ( hi - lo > precision ) {
+
+      const double mid = 0.5*(lo + hi);
+
+      if ( cls(mid) < alpha )
+	hi = mid;
+      else
+	lo = mid;
+    }
+
+    return 0.5*(lo + hi);
+  }
+
+  //_______________________________________________________________________________
+  //
+  bool CLsFactory::areThreadSafe( CLsFluctuator *nullFluct,
+				  CLsPrior *nullPrior,
+				  CLsFluctuator *sigFluct,
+				  CLsPrior *sigPrior ) {
+
+    for ( CLsFluctuator *fluct : {nullFluct, sigFluct} )
+      if ( fluct && !fluct->isThreadSafe() )
+	return false;
+
+    for ( CLsPrior *prior : {nullPrior, sigPrior} )
+      if ( prior && !prior->isThreadSafe() )
+	return false;
+
+    return true;
+  }
+
+  //_______________________________________________________________________________
+  //
+  void CLsFactory::readToysHeader( std::istream &is,
+				   const std::string &path,
+				   uint64_t &seed,
+				   uint64_t &batch,
+				   uint64_t &ntoys,
+				   std::vector<RandomEngine> &nullEngines,
+				   std::vector<RandomEngine> &sigEngines ) const {
+
+    const uint32_t version = binio::readHeader(is, "ISISCLS");
+    if ( version != 1 )
+      throw BaseException("The file \"" + path + "\" has version " +
+			  std::to_string(version) + ", but only version 1 is supported");
+
+    binio::read(is, seed);
+    binio::read(is, batch);
+    binio::read(is, ntoys);
+
+    Doubles nullHyp, sigHyp;
+    binio::read(is, nullHyp);
+    binio::read(is, sigHyp);
+
+    if ( nullHyp != fNullHyp->getHyp() || sigHyp != fSigHyp->getHyp() )
+      throw BaseException("The file \"" + path + "\" was generated with different hypotheses");
+
+    uint64_t nstreams;
+    binio::read(is, nstreams);
+
+    std::vector<uint64_t> states;
+    binio::read(is, states);
+
+    if ( states.size() != 8*nstreams )
+      throw BaseException("Wrong number of states in file \"" + path + "\"");
+
+    nullEngines.resize(nstreams);
+    sigEngines.resize(nstreams);
+    for ( size_t i = 0; i < nstreams; ++i ) {
+      nullEngines[i].setState(&states[4*i]);
+      sigEngines[i].setState(&states[4*(nstreams + i)]);
+    }
+  }
+
+  //_______________________________________________________________________________
+  //
+  std::vector<std::streampos> CLsFactory::readToysPositions( std::istream &is,
+							     const std::string &path,
+							     const uint64_t &ntoys ) const {
+
+    std::vector<std::streampos> positions;
+
+    for ( uint64_t n = 0; n < ntoys; ) {
+
+      uint64_t nb, size;
+      binio::read(is, nb);
+      binio::read(is, size);
+
+      if ( !nb || n + nb > ntoys )
+	throw BaseException("Wrong number of toys in file \"" + path + "\"");
+
+      positions.push_back(is.tellg());
+
+      if ( !is.seekg(size, std::ios::cur) )
+	throw BaseException("Unable to read the toys from file \"" + path + "\"");
+
+      n += nb;
+    }
+
+    return positions;
+  }
+
+  //_______________________________________________________________________________
+  //
+  void CLsFactory::writeToysHeader( std::ostream &os,
+				    const uint64_t &seed,
+				    const uint64_t &batch,
+				    const uint64_t &ntoys,
+				    const std::vector<RandomEngine> &nullEngines,
+				    const std::vector<RandomEngine> &sigEngines ) const {
+
+    binio::writeHeader(os, "ISISCLS", 1);
+
+    binio::write(os, seed);
+    binio::write(os, batch);
+    binio::write(os, ntoys);
+
+    binio::write(os, fNullHyp->getHyp());
+    binio::write(os, fSigHyp->getHyp());
+
+    std::vector<uint64_t> states;
+    states.reserve(4*(nullEngines.size() + sigEngines.size()));
+    for ( auto it = nullEngines.cbegin(); it != nullEngines.cend(); ++it )
+      states.insert(states.end(), it->getState(), it->getState() + 4);
+    for ( auto it = sigEngines.cbegin(); it != sigEngines.cend(); ++it )
+      states.insert(states.end(), it->getState(), it->getState() + 4);
+
+    binio::write(os, uint64_t(nullEngines.size()));
+    binio::write(os, states);
+  }
+
+  //_______________________________________________________________________________
+  //
+  std::vector<CLsResult> CLsFactory::scanPoint( const Doubles &bkg,
+						const Doubles &sig,
+						const double &mu,
+						const Doubles &obs,
+						const size_t &n,
+						const size_t &nthreads,
+						const Doubles &nullSamples,
+						const std::vector<RandomEngine> &sigEngines,
+						CLsFluctuator *nullFluct,
+						CLsPrior *nullPrior,
+						CLsFluctuator *sigFluct,
+						CLsPrior *sigPrior ) {
+
+    Doubles sigmu(bkg);
+    for ( size_t i = 0; i < sigmu.size(); ++i )
+      sigmu[i] += mu*sig[i];
+
+    CLsHypothesis h0(bkg, nullFluct, nullPrior), h1(sigmu, sigFluct, sigPrior);
+    CLsFactory factory(h0, h1);
+
+    h0.evaluateSamples(nullSamples, nthreads);
+
+    std::vector<RandomEngine> engines(sigEngines);
+    h1.generate(n, engines);
+
+    std::vector<CLsResult> results;
+    results.reserve(2*CLsScanResult::MaxSigma + 2);
+
+    // The expected values are calculated at the quantiles of the test statistic
+    // of the null hypothesis
+    for ( int ns = -CLsScanResult::MaxSigma; ns <= CLsScanResult::MaxSigma; ++ns ) {
+
+      double t = h0.testStatFromProb(ROOT::Math::normal_cdf(ns, 1, 0));
+
+      results.push_back(factory.calculate(t));
+    }
 
-    double t1 = fSigHyp->poissonProb(values);
+    if ( !obs.empty() )
+      results.push_back(factory.calculate(obs));
 
-    return -2.*std::log(t0/t1);
+    return results;
   }
 
 }
@@ -7,7 +7,7 @@
 //  AUTHOR: Miguel Ramos Pernas
 //  e-mail: miguel.ramos.pernas@cern.ch
 //
-//  Last update: 10/04/2017
+//  Last update: 18/10/2026
 //
 // --------------------------------------------------------------------------------
 //
@@ -22,10 +22,17 @@
 #ifndef CLS_FACTORY
 #define CLS_FACTORY
 
+#include "CLsFluctuator.hpp"
 #include "CLsHypothesis.hpp"
 #include "CLsPrior.hpp"
 #include "CLsResult.hpp"
+#include "CLsScanResult.hpp"
 #include "Definitions.hpp"
+#include "RandomEngine.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
 
 
 //_______________________________________________________________________________
@@ -57,6 +64,10 @@ namespace isis {
     // Return information concerning the CLs method given an array
     inline CLsResult calculate( const Doubles &array ) const;
 
+    // Return information concerning the CLs method for each of the < n >
+    // test-statistics values in < tstats >
+    std::vector<CLsResult> calculateMany( const double *tstats, const size_t &n ) const;
+
     // Calculate CLb
     inline double CLb( const double &t ) const;
 
@@ -68,6 +79,31 @@ namespace isis {
 
     // Generate < n > events for each of the hypotheses
     void generate( const size_t &n = 10000 );
+
+    // Generate < n > events for each of the hypotheses in parallel (see
+    // < CLsHypothesis::generate >). The streams of random numbers of both
+    // hypotheses are obtained from the given seed, those of the signal
+    // hypothesis following those of the null hypothesis.
+    void generate( const size_t &n, const size_t &nthreads, const uint64_t &seed );
+
+    // Generate < n > events for each of the hypotheses in steps of < batch >
+    // events. The toys of each batch are appended to the file < path >, and then
+    // its header, storing the number of events and the state of the generators,
+    // is updated, so every toy is written only once. If the file exists, the
+    // generation is resumed from the state stored in it, and continues until
+    // the file contains < n > events, so an interrupted job can be restarted
+    // with the same arguments. At the end, the toys of all the batches are read
+    // (see < merge >). The events are generated using < nthreads > streams of
+    // random numbers (0 uses the number of available threads) on the first
+    // call, and the same number is used when resuming. The results only depend
+    // on the seed, the size of the batches and the number of streams. The file
+    // can be combined with others generated with different seeds using
+    // < merge >.
+    void generate( const size_t &n,
+		   const size_t &nthreads,
+		   const uint64_t &seed,
+		   const std::string &path,
+		   const size_t &batch = 100000 );
     
     // Return the null hypothesis
     inline CLsHypothesis* getNullHyp();
@@ -75,15 +111,80 @@ namespace isis {
     // Return the signal hypothesis
     inline CLsHypothesis* getSigHyp();
 
+    // Return whether any of the hypotheses has a prior
+    inline bool hasPriors() const;
+
+    // Return whether the priors of the hypotheses, if any, are thread-safe
+    inline bool hasThreadSafePriors() const;
+
     // Set the null hypothesis
     inline void setNullHyp( CLsHypothesis &hyp );
 
     // Set the signal hypothesis
     inline void setSigHyp( CLsHypothesis &hyp );
 
-    // Return the test statistics for a given array of values
+    // Replace the toys of the hypotheses by the union of those stored in the
+    // given files (see < generate >). The files must have been generated with
+    // the same hypotheses and with different seeds.
+    void merge( const Strings &paths );
+
+    // Return the logarithm of the ratio between the likelihoods of the signal and
+    // the null hypotheses for the given observed values, computed as
+    // sum_i [ n_i*log(mu1_i/mu0_i) - (mu1_i - mu0_i) ]. The terms depending only
+    // on the observed values cancel, so they are not computed. The priors are
+    // not included.
+    double logLikelihoodRatio( const double *values ) const;
+
+    // Return the test statistics for a given array of values, defined as
+    // -2*log(L0/L1), including the priors
     double testStat( const Doubles &values ) const;
 
+    // Calculate the CLs values for a set of signal strengths < mu >, where the
+    // null hypothesis is defined by < bkg > and the signal hypothesis by
+    // < bkg + mu*sig >. The observed values are calculated if < obs > is not
+    // empty. For each point < n > events are generated for each hypothesis. The
+    // values of the null hypothesis do not depend on the signal strength, so
+    // they are generated once and evaluated at each point. The points are
+    // distributed among < nthreads > threads (0 uses all the available), and
+    // all of them use the same streams of random numbers, so the statistical
+    // fluctuations are correlated among points and the results do not depend on
+    // the number of threads. Optionally, fluctuators and priors can be given
+    // for each hypothesis. If any of them is not thread-safe (see
+    // CLsFluctuators.hpp and CLsPriors.hpp) a single thread is used.
+    static CLsScanResult scan( const Doubles &bkg,
+			       const Doubles &sig,
+			       const Doubles &mu,
+			       const Doubles &obs = {},
+			       const size_t &n = 10000,
+			       const size_t &nthreads = 0,
+			       const uint64_t &seed = 0,
+			       CLsFluctuator *nullFluct = 0,
+			       CLsPrior *nullPrior = 0,
+			       CLsFluctuator *sigFluct = 0,
+			       CLsPrior *sigPrior = 0 );
+
+    // Calculate the upper limit on the signal strength at the given confidence
+    // level, using bisection in [mumin, mumax] until the interval is smaller than
+    // < precision >. If < obs > is empty, the expected upper limit for the given
+    // number of standard deviations is calculated. The rest of the arguments are
+    // the same as for < scan >, but the events are generated in parallel for
+    // each point, and the results depend on the number of threads.
+    static double upperLimit( const Doubles &bkg,
+			      const Doubles &sig,
+			      const double &mumin,
+			      const double &mumax,
+			      const Doubles &obs = {},
+			      const double &cl = 0.95,
+			      const int &nsigma = 0,
+			      const double &precision = 1e-3,
+			      const size_t &n = 10000,
+			      const size_t &nthreads = 0,
+			      const uint64_t &seed = 0,
+			      CLsFluctuator *nullFluct = 0,
+			      CLsPrior *nullPrior = 0,
+			      CLsFluctuator *sigFluct = 0,
+			      CLsPrior *sigPrior = 0 );
+
   protected:
 
     // Null hypothesis
@@ -92,6 +193,61 @@ namespace isis {
     // Signal hypothesis
     CLsHypothesis *fSigHyp;
 
+  private:
+
+    // Return whether the given fluctuators and priors can be used from several
+    // threads at the same time
+    static bool areThreadSafe( CLsFluctuator *nullFluct,
+			       CLsPrior *nullPrior,
+			       CLsFluctuator *sigFluct,
+			       CLsPrior *sigPrior );
+
+    // Read the header of a file with toys, checking that the hypotheses match.
+    // The seed, the size of the batches, the number of generated events and the
+    // states of the generators are returned.
+    void readToysHeader( std::istream &is,
+			 const std::string &path,
+			 uint64_t &seed,
+			 uint64_t &batch,
+			 uint64_t &ntoys,
+			 std::vector<RandomEngine> &nullEngines,
+			 std::vector<RandomEngine> &sigEngines ) const;
+
+    // Return the positions of the toys of the batches stored after the header
+    // of a file, up to < ntoys > events. The stream is left at the end of the
+    // last batch.
+    std::vector<std::streampos> readToysPositions( std::istream &is,
+						   const std::string &path,
+						   const uint64_t &ntoys ) const;
+
+    // Write the header of a file with toys, containing the seed, the size of the
+    // batches, the number of generated events and the states of the generators.
+    // Its size only depends on the hypotheses and on the number of generators,
+    // so it can be overwritten after each batch.
+    void writeToysHeader( std::ostream &os,
+			  const uint64_t &seed,
+			  const uint64_t &batch,
+			  const uint64_t &ntoys,
+			  const std::vector<RandomEngine> &nullEngines,
+			  const std::vector<RandomEngine> &sigEngines ) const;
+
+    // Calculate the expected and observed results for the signal strength
+    // < mu >, in the format expected by < CLsScanResult >. The toys of the null
+    // hypothesis are evaluated from the given samples, and those of the signal
+    // hypothesis are generated with copies of the given generators.
+    static std::vector<CLsResult> scanPoint( const Doubles &bkg,
+					     const Doubles &sig,
+					     const double &mu,
+					     const Doubles &obs,
+					     const size_t &n,
+					     const size_t &nthreads,
+					     const Doubles &nullSamples,
+					     const std::vector<RandomEngine> &sigEngines,
+					     CLsFluctuator *nullFluct,
+					     CLsPrior *nullPrior,
+					     CLsFluctuator *sigFluct,
+					     CLsPrior *sigPrior );
+
   };
   
   //_______________________________________________________________________________
@@ -152,6 +308,23 @@ namespace isis {
     return fSigHyp;
   }
 
+  //_______________________________________________________________________________
+  //
+  inline bool CLsFactory::hasPriors() const {
+
+    return fNullHyp->getPrior() || fSigHyp->getPrior();
+  }
+
+  //_______________________________________________________________________________
+  //
+  inline bool CLsFactory::hasThreadSafePriors() const {
+
+    CLsPrior *p0 = fNullHyp->getPrior();
+    CLsPrior *p1 = fSigHyp->getPrior();
+
+    return (!p0 || p0->isThreadSafe()) && (!p1 || p1->isThreadSafe());
+  }
+
   //_______________________________________________________________________________
   //
   inline void CLsFactory::setNullHyp( CLsHypothesis &hyp ) {
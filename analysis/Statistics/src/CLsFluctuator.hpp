@@ -7,13 +7,15 @@
 //  AUTHOR: Miguel Ramos Pernas
 //  e-mail: miguel.ramos.pernas@cern.ch
 //
-//  Last update: 10/04/2017
+//  Last update: 18/10/2026
 //
 // --------------------------------------------------------------------------------
 //
 //  Description:
 //
-//  Abstract class to fluctuate the means of the CLs hypotheses
+//  Abstract class to fluctuate the means of the CLs hypotheses. Classes which
+//  can be used from several threads at once must override < fluctuateAll > and
+//  < isThreadSafe >. Some implementations are provided in CLsFluctuators.hpp.
 //
 // --------------------------------------------------------------------------------
 ///////////////////////////////////////////////////////////////////////////////////
@@ -22,6 +24,8 @@
 #ifndef CLS_FLUCTUATOR
 #define CLS_FLUCTUATOR
 
+#include "RandomEngine.hpp"
+
 #include <iostream>
 
 
@@ -42,6 +46,18 @@ namespace isis {
     // Given the position and the value, fluctuate it using an user-defined function
     virtual double fluctuate( const size_t &pos, const double &value ) = 0;
 
+    // Fluctuate the < n > means of a hypothesis at once, using the given random
+    // number generator. By default < fluctuate > is called for each of them, so
+    // the generator is not used.
+    virtual void fluctuateAll( double *means, const size_t &n, RandomEngine & ) {
+
+      for ( size_t i = 0; i < n; ++i )
+	means[i] = this->fluctuate(i, means[i]);
+    }
+
+    // Return whether < fluctuateAll > can be called from several threads at once
+    virtual bool isThreadSafe() const { return false; }
+
   };
   
 }
@@ -0,0 +1,183 @@
+///////////////////////////////////////////////////////////////////////////////////
+//
+//  Analysis package
+//
+// --------------------------------------------------------------------------------
+//
+//  AUTHOR: Miguel Ramos Pernas
+//  e-mail: miguel.ramos.pernas@cern.ch
+//
+//  Last update: 18/10/2026
+//
+// --------------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////////
+
+
+#include "CLsFluctuators.hpp"
+#include "Definitions.hpp"
+#include "Exceptions.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+
+//_______________________________________________________________________________
+
+namespace isis {
+
+  //_______________________________________________________________________________
+  //
+  CLsNativeFluctuator::CLsNativeFluctuator( const size_t &size, const uint64_t &seed ) :
+    CLsFluctuator(), fRndm( seed ), fSize( size ) { }
+
+  //_______________________________________________________________________________
+  //
+  CLsNativeFluctuator::~CLsNativeFluctuator() { }
+
+  //_______________________________________________________________________________
+  //
+  double CLsNativeFluctuator::fluctuate( const size_t &pos, const double &value ) {
+
+    if ( pos >= fSize )
+      throw BaseException("Position " + std::to_string(pos) + " is out of range");
+
+    return this->shift(pos, value, fRndm);
+  }
+
+  //_______________________________________________________________________________
+  //
+  void CLsNativeFluctuator::fluctuateAll( double *means,
+					  const size_t &n,
+					  RandomEngine &rndm ) {
+
+    if ( n != fSize )
+      throw BaseException("The number of means does not match the number of channels");
+
+    for ( size_t i = 0; i < n; ++i )
+      means[i] = this->shift(i, means[i], rndm);
+  }
+
+  //_______________________________________________________________________________
+  //
+  void CLsNativeFluctuator::checkSigmas( const Doubles &sigmas ) {
+
+    for ( auto it = sigmas.cbegin(); it != sigmas.cend(); ++it )
+      if ( *it < 0 )
+	throw BaseException("Uncertainties must be positive or zero");
+  }
+
+  //_______________________________________________________________________________
+  //
+  CLsGaussFluct::CLsGaussFluct( const Doubles &sigmas, const uint64_t &seed ) :
+    CLsNativeFluctuator(sigmas.size(), seed), fSigmas( sigmas ) {
+
+    checkSigmas(sigmas);
+  }
+
+  //_______________________________________________________________________________
+  //
+  CLsGaussFluct::~CLsGaussFluct() { }
+
+  //_______________________________________________________________________________
+  //
+  double CLsGaussFluct::shift( const size_t &pos,
+			       const double &mean,
+			       RandomEngine &rndm ) const {
+
+    return std::max(mean*(1. + fSigmas[pos]*rndm.gaussian()), 0.);
+  }
+
+  //_______________________________________________________________________________
+  //
+  CLsLogNormFluct::CLsLogNormFluct( const Doubles &sigmas, const uint64_t &seed ) :
+    CLsNativeFluctuator(sigmas.size(), seed), fLogSigmas( sigmas.size() ) {
+
+    checkSigmas(sigmas);
+
+    for ( size_t i = 0; i < sigmas.size(); ++i )
+      fLogSigmas[i] = std::sqrt(std::log(1. + sigmas[i]*sigmas[i]));
+  }
+
+  //_______________________________________________________________________________
+  //
+  CLsLogNormFluct::~CLsLogNormFluct() { }
+
+  //_______________________________________________________________________________
+  //
+  double CLsLogNormFluct::shift( const size_t &pos,
+				 const double &mean,
+				 RandomEngine &rndm ) const {
+
+    const double &s = fLogSigmas[pos];
+
+    return mean*std::exp(s*rndm.gaussian() - 0.5*s*s);
+  }
+
+  //_______________________________________________________________________________
+  //
+  CLsAsymGaussFluct::CLsAsymGaussFluct( const Doubles &siglo,
+					const Doubles &sighi,
+					const uint64_t &seed ) :
+    CLsNativeFluctuator(siglo.size(), seed),
+    fHalfDiff( siglo.size() ),
+    fHalfSum( siglo.size() ) {
+
+    if ( siglo.size() != sighi.size() )
+      throw BaseException("Lower and upper uncertainties do not have the same sizes");
+
+    checkSigmas(siglo);
+    checkSigmas(sighi);
+
+    for ( size_t i = 0; i < siglo.size(); ++i ) {
+      fHalfDiff[i] = 0.5*(sighi[i] - siglo[i]);
+      fHalfSum[i]  = 0.5*(sighi[i] + siglo[i]);
+    }
+  }
+
+  //_______________________________________________________________________________
+  //
+  CLsAsymGaussFluct::~CLsAsymGaussFluct() { }
+
+  //_______________________________________________________________________________
+  //
+  double CLsAsymGaussFluct::shift( const size_t &pos,
+				   const double &mean,
+				   RandomEngine &rndm ) const {
+
+    const double r = rndm.gaussian();
+
+    return std::max(mean*(1. + r*fHalfSum[pos] + r*r*fHalfDiff[pos]), 0.);
+  }
+
+  //_______________________________________________________________________________
+  //
+  CLsGammaFluct::CLsGammaFluct( const Doubles &sigmas, const uint64_t &seed ) :
+    CLsNativeFluctuator(sigmas.size(), seed), fShapes( sigmas.size() ) {
+
+    checkSigmas(sigmas);
+
+    // A null uncertainty is represented by a null shape
+    for ( size_t i = 0; i < sigmas.size(); ++i )
+      fShapes[i] = sigmas[i] > 0 ? 1./(sigmas[i]*sigmas[i]) : 0;
+  }
+
+  //_______________________________________________________________________________
+  //
+  CLsGammaFluct::~CLsGammaFluct() { }
+
+  //_______________________________________________________________________________
+  //
+  double CLsGammaFluct::shift( const size_t &pos,
+			       const double &mean,
+			       RandomEngine &rndm ) const {
+
+    const double &k = fShapes[pos];
+
+    if ( k == 0 )
+      return mean;
+
+    return mean*rndm.gamma(k)/k;
+  }
+
+}
@@ -0,0 +1,206 @@
+///////////////////////////////////////////////////////////////////////////////////
+//
+//  Analysis package
+//
+// --------------------------------------------------------------------------------
+//
+//  AUTHOR: Miguel Ramos Pernas
+//  e-mail: miguel.ramos.pernas@cern.ch
+//
+//  Last update: 18/10/2026
+//
+// --------------------------------------------------------------------------------
+//
+//  Description:
+//
+//  Native implementations of fluctuators for the CLs hypotheses. The widths are
+//  given as relative uncertainties on the means, one per channel. All of them
+//  are thread-safe when used through < fluctuateAll >, so they can be used to
+//  generate in parallel. Calls to < fluctuate > use an internal generator.
+//
+// --------------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef CLS_FLUCTUATORS
+#define CLS_FLUCTUATORS
+
+#include "CLsFluctuator.hpp"
+#include "Definitions.hpp"
+#include "RandomEngine.hpp"
+
+#include <cstdint>
+
+
+//_______________________________________________________________________________
+
+namespace isis {
+
+  // Base class for the native fluctuators
+  class CLsNativeFluctuator : public CLsFluctuator {
+
+  public:
+
+    // Constructor given the number of channels and the seed of the internal
+    // generator
+    CLsNativeFluctuator( const size_t &size, const uint64_t &seed = 0 );
+
+    // Destructor
+    virtual ~CLsNativeFluctuator();
+
+    // Fluctuate the value in the given position using the internal generator
+    double fluctuate( const size_t &pos, const double &value );
+
+    // Fluctuate all the means using the given generator
+    void fluctuateAll( double *means, const size_t &n, RandomEngine &rndm );
+
+    // Return the number of channels
+    inline size_t getSize() const;
+
+    // The class is thread-safe when used through < fluctuateAll >
+    inline bool isThreadSafe() const;
+
+    // Set the seed of the internal generator
+    inline void setSeed( const uint64_t &seed );
+
+  protected:
+
+    // Internal generator
+    RandomEngine fRndm;
+
+    // Number of channels
+    size_t fSize;
+
+    // Check that all the uncertainties are positive or zero
+    static void checkSigmas( const Doubles &sigmas );
+
+    // Return the fluctuated mean in the given position
+    virtual double shift( const size_t &pos,
+			  const double &mean,
+			  RandomEngine &rndm ) const = 0;
+
+  };
+
+  //_______________________________________________________________________________
+  //
+  inline size_t CLsNativeFluctuator::getSize() const {
+
+    return fSize;
+  }
+
+  //_______________________________________________________________________________
+  //
+  inline bool CLsNativeFluctuator::isThreadSafe() const {
+
+    return true;
+  }
+
+  //_______________________________________________________________________________
+  //
+  inline void CLsNativeFluctuator::setSeed( const uint64_t &seed ) {
+
+    fRndm.setSeed(seed);
+  }
+
+
+  // Fluctuate following a normal distribution, as mean*(1 + s*r), being < r >
+  // a normal random number. Negative values are set to zero.
+  class CLsGaussFluct : public CLsNativeFluctuator {
+
+  public:
+
+    // Constructor given the relative uncertainties
+    CLsGaussFluct( const Doubles &sigmas, const uint64_t &seed = 0 );
+
+    // Destructor
+    ~CLsGaussFluct();
+
+  protected:
+
+    // Relative uncertainties
+    Doubles fSigmas;
+
+    // Return the fluctuated mean
+    double shift( const size_t &pos, const double &mean, RandomEngine &rndm ) const;
+
+  };
+
+
+  // Fluctuate following a log-normal distribution whose mean is the value to
+  // fluctuate and whose relative standard deviation is the given uncertainty
+  class CLsLogNormFluct : public CLsNativeFluctuator {
+
+  public:
+
+    // Constructor given the relative uncertainties
+    CLsLogNormFluct( const Doubles &sigmas, const uint64_t &seed = 0 );
+
+    // Destructor
+    ~CLsLogNormFluct();
+
+  protected:
+
+    // Standard deviations of the logarithm of the values
+    Doubles fLogSigmas;
+
+    // Return the fluctuated mean
+    double shift( const size_t &pos, const double &mean, RandomEngine &rndm ) const;
+
+  };
+
+
+  // Fluctuate using asymmetric uncertainties, as
+  // mean*(1 + 0.5*r*(hi + lo) + 0.5*r^2*(hi - lo)), being < r > a normal random
+  // number. Values at -1 and +1 standard deviations correspond to
+  // mean*(1 - lo) and mean*(1 + hi). Negative values are set to zero.
+  class CLsAsymGaussFluct : public CLsNativeFluctuator {
+
+  public:
+
+    // Constructor given the lower and upper relative uncertainties
+    CLsAsymGaussFluct( const Doubles &siglo,
+		       const Doubles &sighi,
+		       const uint64_t &seed = 0 );
+
+    // Destructor
+    ~CLsAsymGaussFluct();
+
+  protected:
+
+    // Half of the difference between the upper and lower uncertainties
+    Doubles fHalfDiff;
+
+    // Half of the sum of the upper and lower uncertainties
+    Doubles fHalfSum;
+
+    // Return the fluctuated mean
+    double shift( const size_t &pos, const double &mean, RandomEngine &rndm ) const;
+
+  };
+
+
+  // Fluctuate following a gamma distribution whose mean is the value to
+  // fluctuate and whose relative standard deviation is the given uncertainty
+  class CLsGammaFluct : public CLsNativeFluctuator {
+
+  public:
+
+    // Constructor given the relative uncertainties
+    CLsGammaFluct( const Doubles &sigmas, const uint64_t &seed = 0 );
+
+    // Destructor
+    ~CLsGammaFluct();
+
+  protected:
+
+    // Shapes of the distributions (the inverse of the squared uncertainties)
+    Doubles fShapes;
+
+    // Return the fluctuated mean
+    double shift( const size_t &pos, const double &mean, RandomEngine &rndm ) const;
+
+  };
+
+}
+
+#endif
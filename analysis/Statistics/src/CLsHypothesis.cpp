@@ -7,23 +7,30 @@
 //  AUTHOR: Miguel Ramos Pernas
 //  e-mail: miguel.ramos.pernas@cern.ch
 //
-//  Last update: 19/10/2017
+//  Last update: 18/10/2026
 //
 // --------------------------------------------------------------------------------
 ///////////////////////////////////////////////////////////////////////////////////
 
 
+#include "BinaryIO.hpp"
 #include "CLsFactory.hpp"
 #include "CLsFluctuator.hpp"
 #include "CLsHypothesis.hpp"
 #include "CLsPrior.hpp"
 #include "Definitions.hpp"
 #include "Exceptions.hpp"
+#include "Parallel.hpp"
+#include "PoissonSampler.hpp"
+#include "RandomEngine.hpp"
 
 #include "TMath.h"
 #include "TRandom3.h"
 
 #include <algorithm>
+#include <cmath>
+#include <memory>
+#include <numeric>
 
 
 //_______________________________________________________________________________
@@ -37,46 +44,95 @@ namespace isis {
 				CLsPrior *prior ) :
     fFactory( 0 ),
     fFluct( fluct ),
-    fHyp( array ),
+    fHyp( std::make_shared<Doubles>(array) ),
     fPrior( prior ),
     fRndm( 0 ),
-    fType( CLsHypTypes::aNone ) { }
+    fTSLogWgts( std::make_shared<Doubles>() ),
+    fTSVals( std::make_shared<Doubles>() ),
+    fUseTSDist( false ),
+    fType( CLsHypTypes::aNone ) {
+
+    this->cacheHyp();
+    this->checkPrior();
+  }
 
   //_______________________________________________________________________________
   //
   CLsHypothesis::~CLsHypothesis() { }
 
+  //_______________________________________________________________________________
+  //
+  double CLsHypothesis::getEffectiveSize() const {
+
+    if ( fUseTSDist )
+      return fTSDist.getEntries();
+
+    if ( fTSLogWgts->empty() )
+      return fTSVals->size();
+
+    const double mx = *std::max_element(fTSLogWgts->cbegin(), fTSLogWgts->cend());
+
+    double sw = 0, sw2 = 0;
+    for ( auto it = fTSLogWgts->cbegin(); it != fTSLogWgts->cend(); ++it ) {
+
+      const double w = std::exp(*it - mx);
+
+      sw  += w;
+      sw2 += w*w;
+    }
+
+    return sw*sw/sw2;
+  }
+
   //_______________________________________________________________________________
   //
   void CLsHypothesis::generate( const size_t &n ) {
 
     if ( fFactory ) {
 
-      fTSVals.clear();
+      this->clearToys();
+
+      const bool weighted = !fProposal.empty();
+
+      Doubles means(fHyp->size());
     
       for ( size_t i = 0; i < n; ++i ) {
 
-	Doubles vec(fHyp);
+	Doubles vec(*fHyp);
 
 	// Randomize vector
 	for ( auto it = vec.begin(); it != vec.end(); ++it ) {
 
+	  const size_t pos = it - vec.begin();
+
 	  double mean = *it;
 	  
 	  // Fluctuate the values
 	  if ( fFluct )
-	    mean = fFluct->fluctuate(it - vec.begin(), mean);
+	    mean = fFluct->fluctuate(pos, mean);
+
+	  means[pos] = mean;
+
+	  // Move to the proposal
+	  if ( weighted )
+	    mean *= fPropRatio[pos];
 
 	  *it = fRndm.Poisson(mean);
 	}
 
 	double tst = fFactory->testStat(vec);
 
-	fTSVals.push_back(tst);
+	if ( fUseTSDist )
+	  fTSDist.fill(tst);
+	else
+	  fTSVals->push_back(tst);
+
+	if ( weighted )
+	  fTSLogWgts->push_back(this->logWeight(means.data(), vec));
       }
 
       // It is very important to sort the vector
-      std::sort(fTSVals.begin(), fTSVals.end());
+      this->sortToys();
       
     }
     else
@@ -85,24 +141,271 @@ namespace isis {
 
   //_______________________________________________________________________________
   //
-  double CLsHypothesis::poissonProb( const Doubles &values ) const {
+  void CLsHypothesis::generate( const size_t &n,
+				const size_t &nthreads,
+				const uint64_t &seed ) {
 
-    double prob = 1.;
+    RandomEngine engine(seed);
 
-    auto itv = values.cbegin();
-    auto itt = fHyp.cbegin();
-    
-    // Calculate the probability from a poisson distribution
-    while ( itt != fHyp.cend() ) {
-      prob *= TMath::Poisson(*itv++, *itt++);
+    this->generate(n, nthreads, engine);
+  }
+
+  //_______________________________________________________________________________
+  //
+  void CLsHypothesis::generate( const size_t &n,
+				const size_t &nthreads,
+				RandomEngine &engine ) {
+
+    const size_t nt = getNthreads(nthreads, n);
+
+    this->checkParallel(nt);
+
+    std::vector<RandomEngine> engines = engine.split(nt);
+
+    this->clearToys();
+
+    if ( fUseTSDist ) {
+
+      // The first values define the bins of the histogram, so they are
+      // generated before the rest. Each thread then fills a copy of the
+      // distribution with the same bins, so they can be merged exactly.
+      const size_t nfirst = std::min(n, fTSDist.getNexact() + 1);
+
+      std::vector<Doubles> buffers(nt);
+
+      parallelFor(nfirst, nt, [&] ( size_t it, size_t first, size_t last ) {
+	  this->generateToys(engines[it], last - first, buffers[it]);
+	});
+
+      for ( auto it = buffers.begin(); it != buffers.end(); ++it )
+	fTSDist.fill(*it);
+
+      if ( n == nfirst )
+	return;
+
+      std::vector<CLsTSDistribution> dists(nt, fTSDist);
+      for ( auto it = dists.begin(); it != dists.end(); ++it )
+	it->reset(true);
+
+      parallelFor(n - nfirst, nt, [&] ( size_t it, size_t first, size_t last ) {
+
+	  const size_t blocksize = 4096;
+
+	  Doubles &block = buffers[it];
+
+	  for ( size_t i = first; i < last; i += blocksize ) {
+
+	    block.clear();
+
+	    this->generateToys(engines[it], std::min(blocksize, last - i), block);
+
+	    dists[it].fill(block);
+	  }
+	});
+
+      for ( auto it = dists.cbegin(); it != dists.cend(); ++it )
+	fTSDist.merge(*it);
+
+      return;
+    }
+
+    if ( !fProposal.empty() ) {
+
+      // The values and the weights are joined in the order of the threads, so
+      // the result does not depend on the scheduling, and sorted together
+      std::vector<Doubles> buffers(nt), wbuffers(nt);
+
+      parallelFor(n, nt, [&] ( size_t it, size_t first, size_t last ) {
+
+	  buffers[it].reserve(last - first);
+	  wbuffers[it].reserve(last - first);
+
+	  this->generateToys(engines[it], last - first, buffers[it], &wbuffers[it]);
+	});
 
-      // Include the prior
-      if ( fPrior ) {
+      fTSVals->reserve(n);
+      fTSLogWgts->reserve(n);
+      for ( size_t it = 0; it < nt; ++it ) {
 
-	size_t pos = itt - fHyp.cbegin();
+	fTSVals->insert(fTSVals->end(), buffers[it].cbegin(), buffers[it].cend());
+	fTSLogWgts->insert(fTSLogWgts->end(), wbuffers[it].cbegin(), wbuffers[it].cend());
 
-	prob *= fPrior->evaluate(pos, *itt, *itv);
+	Doubles().swap(buffers[it]);
+	Doubles().swap(wbuffers[it]);
       }
+
+      this->sortToys();
+
+      return;
+    }
+
+    // Each thread fills and sorts its own buffer, and they are merged at the end
+    std::vector<Doubles> buffers(nt);
+
+    parallelFor(n, nt, [&] ( size_t it, size_t first, size_t last ) {
+
+	Doubles &tsvals = buffers[it];
+	tsvals.reserve(last - first);
+
+	this->generateToys(engines[it], last - first, tsvals);
+
+	std::sort(tsvals.begin(), tsvals.end());
+      });
+
+    mergeSorted(buffers, *fTSVals);
+  }
+
+  //_______________________________________________________________________________
+  //
+  void CLsHypothesis::generate( const size_t &n, std::vector<RandomEngine> &engines ) {
+
+    if ( engines.empty() )
+      throw BaseException("At least one generator must be provided");
+
+    const size_t nt = engines.size();
+
+    this->checkParallel(nt);
+
+    const bool weighted = !fProposal.empty();
+
+    std::vector<Doubles> buffers(nt), wbuffers(nt);
+
+    parallelFor(nt, nt, [&] ( size_t, size_t first, size_t last ) {
+
+	for ( size_t i = first; i < last; ++i ) {
+
+	  const size_t ni = n/nt + (i < n % nt);
+
+	  buffers[i].reserve(ni);
+
+	  this->generateToys(engines[i], ni, buffers[i], weighted ? &wbuffers[i] : 0);
+	}
+      });
+
+    // The values are added following the order of the generators
+    if ( fUseTSDist ) {
+
+      Doubles tsvals;
+      tsvals.reserve(n);
+
+      for ( size_t i = 0; i < nt; ++i ) {
+	tsvals.insert(tsvals.end(), buffers[i].cbegin(), buffers[i].cend());
+	Doubles().swap(buffers[i]);
+      }
+
+      fTSDist.fill(tsvals);
+    }
+    else
+      this->addToys(buffers, wbuffers);
+  }
+
+  //_______________________________________________________________________________
+  //
+  void CLsHypothesis::generateSamples( const size_t &n,
+				       std::vector<RandomEngine> &engines,
+				       Doubles &samples ) const {
+
+    if ( engines.empty() )
+      throw BaseException("At least one generator must be provided");
+
+    const size_t nt = engines.size();
+
+    if ( nt > 1 && fFluct && !fFluct->isThreadSafe() )
+      throw BaseException("The fluctuator can not be used to generate in parallel");
+
+    std::vector<Doubles> buffers(nt);
+
+    parallelFor(nt, nt, [&] ( size_t, size_t first, size_t last ) {
+
+	for ( size_t i = first; i < last; ++i ) {
+
+	  const size_t ni = n/nt + (i < n % nt);
+
+	  buffers[i].reserve(ni*fHyp->size());
+
+	  this->generateValues(engines[i], ni, buffers[i]);
+	}
+      });
+
+    // The values are added following the order of the generators
+    samples.reserve(samples.size() + n*fHyp->size());
+    for ( size_t i = 0; i < nt; ++i ) {
+
+      samples.insert(samples.end(), buffers[i].cbegin(), buffers[i].cend());
+
+      Doubles().swap(buffers[i]);
+    }
+  }
+
+  //_______________________________________________________________________________
+  //
+  void CLsHypothesis::evaluateSamples( const Doubles &samples, const size_t &nthreads ) {
+
+    if ( !fFactory )
+      throw BaseException("CLs factory is not set");
+
+    if ( !fProposal.empty() )
+      throw BaseException("The toys can not be evaluated from samples if a proposal is used");
+
+    const size_t nch = fHyp->size();
+
+    if ( !nch || samples.size() % nch )
+      throw BaseException("The size of the samples does not match that of the hypothesis");
+
+    const size_t n  = samples.size()/nch;
+    const size_t nt = getNthreads(nthreads, n);
+
+    if ( nt > 1 && !fFactory->hasThreadSafePriors() )
+      throw BaseException("The priors can not be used to evaluate in parallel");
+
+    Doubles tsvals(n);
+
+    parallelFor(n, nt, [&] ( size_t, size_t first, size_t last ) {
+
+	Doubles vec(nch);
+
+	for ( size_t i = first; i < last; ++i ) {
+
+	  std::copy(samples.cbegin() + i*nch, samples.cbegin() + (i + 1)*nch, vec.begin());
+
+	  tsvals[i] = fFactory->testStat(vec);
+	}
+      });
+
+    this->clearToys();
+
+    if ( fUseTSDist )
+      fTSDist.fill(tsvals);
+    else {
+      fTSVals->swap(tsvals);
+      this->sortToys();
+    }
+  }
+
+  //_______________________________________________________________________________
+  //
+  double CLsHypothesis::logPrior( const double *values ) const {
+
+    if ( !fPrior )
+      return 0;
+
+    return fPrior->logEvaluateAll(fHyp->data(), values, fHyp->size());
+  }
+
+  //_______________________________________________________________________________
+  //
+  double CLsHypothesis::poissonProb( const Doubles &values ) const {
+
+    double prob = 1.;
+
+    // Calculate the probability from a poisson distribution, including the
+    // prior
+    for ( size_t i = 0; i < fHyp->size(); ++i ) {
+
+      prob *= TMath::Poisson(values[i], (*fHyp)[i]);
+
+      if ( fPrior )
+	prob *= fPrior->evaluate(i, (*fHyp)[i], values[i]);
     }
   
     return prob;
@@ -112,22 +415,33 @@ namespace isis {
   //
   double CLsHypothesis::pValue( const double &t ) const {
     
-    double n;
-
-    // Return the first element greater than < t >. This comes from the definition
-    // of CLsb and CLb, which are probabilities with respect to measuring less or
-    // equal events as the observed.
-    Doubles::const_iterator it =
-      std::upper_bound(fTSVals.cbegin(), fTSVals.cend(), t);
+    double n, nbelow, ntot;
+
+    // Number of elements lower or equal than < t >. This comes from the
+    // definition of CLsb and CLb, which are probabilities with respect to
+    // measuring less or equal events as the observed.
+    if ( fUseTSDist ) {
+      ntot   = fTSDist.getEntries();
+      nbelow = fTSDist.countBelow(t);
+    }
+    else if ( !fTSCumWgts.empty() ) {
+      ntot   = fTSCumWgts.back();
+      nbelow = fTSCumWgts[std::upper_bound(fTSVals->cbegin(), fTSVals->cend(), t) -
+			  fTSVals->cbegin()];
+    }
+    else {
+      ntot   = fTSVals->size();
+      nbelow = std::upper_bound(fTSVals->cbegin(), fTSVals->cend(), t) - fTSVals->cbegin();
+    }
 
     switch ( fType ) {
 
     case CLsHypTypes::aNull:
-      n = fTSVals.cend() - it;
+      n = ntot - nbelow;
       break;
       
     case CLsHypTypes::aSignal:
-      n = it - fTSVals.cbegin();
+      n = nbelow;
       break;
       
     case CLsHypTypes::aNone:
@@ -138,25 +452,499 @@ namespace isis {
 			  std::to_string(fType) + "\"");
     }
 
-    return n/fTSVals.size();
+    return n/ntot;
+  }
+
+  //_______________________________________________________________________________
+  //
+  void CLsHypothesis::pValues( const double *tstats,
+			       const size_t &n,
+			       double *pvalues ) const {
+
+    for ( size_t i = 0; i < n; ++i )
+      pvalues[i] = this->pValue(tstats[i]);
+  }
+
+  //_______________________________________________________________________________
+  //
+  void CLsHypothesis::readToys( std::istream &is, const bool &add ) {
+
+    this->readToys(std::vector<std::istream*>(1, &is), add);
+  }
+
+  //_______________________________________________________________________________
+  //
+  void CLsHypothesis::readToys( const std::vector<std::istream*> &streams, const bool &add ) {
+
+    // The vectors of values are merged at once, once all of them are read
+    std::vector<Doubles> tsvals, logwgts;
+
+    bool append = add;
+
+    for ( auto it = streams.cbegin(); it != streams.cend(); ++it ) {
+
+      this->readToysBlock(**it, append, tsvals, logwgts);
+
+      append = true;
+    }
+
+    if ( !tsvals.empty() )
+      this->addToys(tsvals, logwgts);
+  }
+
+  //_______________________________________________________________________________
+  //
+  void CLsHypothesis::readToys( const std::vector<std::istream*> &streams,
+				std::vector<std::streampos> &positions,
+				const bool &add ) {
+
+    if ( streams.size() != positions.size() )
+      throw BaseException("The number of streams and positions must be the same");
+
+    std::vector<Doubles> tsvals, logwgts;
+
+    bool append = add;
+
+    for ( size_t i = 0; i < streams.size(); ++i ) {
+
+      std::istream &is = *streams[i];
+
+      if ( !is.seekg(positions[i]) )
+	throw BaseException("Unable to access the toys in the stream");
+
+      this->readToysBlock(is, append, tsvals, logwgts);
+
+      positions[i] = is.tellg();
+
+      append = true;
+    }
+
+    if ( !tsvals.empty() )
+      this->addToys(tsvals, logwgts);
+  }
+
+  //_______________________________________________________________________________
+  //
+  void CLsHypothesis::setProposal( const Doubles &means ) {
+
+    if ( fUseTSDist )
+      throw BaseException("A proposal can not be used with a distribution of the test statistics");
+
+    if ( means.size() != fHyp->size() )
+      throw BaseException("The proposal and the hypothesis do not have the same sizes");
+
+    Doubles ratio(means.size()), logratio(means.size());
+    for ( size_t i = 0; i < means.size(); ++i ) {
+
+      if ( means[i] < 0 )
+	throw BaseException("The means of the proposal must be positive or zero");
+
+      if ( (means[i] == 0) != ((*fHyp)[i] == 0) )
+	throw BaseException("The proposal must be zero only where the hypothesis is");
+
+      if ( (*fHyp)[i] != 0 ) {
+	ratio[i]    = means[i]/(*fHyp)[i];
+	logratio[i] = std::log(ratio[i]);
+      }
+      else {
+	ratio[i]    = 1;
+	logratio[i] = 0;
+      }
+    }
+
+    fProposal     = means;
+    fPropRatio    = ratio;
+    fPropLogRatio = logratio;
+  }
+
+  //_______________________________________________________________________________
+  //
+  void CLsHypothesis::setProposal( const CLsHypothesis &target, const double &tilt ) {
+
+    const Doubles &thyp = target.getHyp();
+
+    if ( thyp.size() != fHyp->size() )
+      throw BaseException("The hypotheses do not have the same sizes");
+
+    // Channels where the hypothesis is zero do not contribute to the weights
+    Doubles means(fHyp->size());
+    for ( size_t i = 0; i < fHyp->size(); ++i )
+      if ( (*fHyp)[i] != 0 )
+	means[i] = std::pow((*fHyp)[i], 1. - tilt)*std::pow(thyp[i], tilt);
+
+    this->setProposal(means);
+  }
+
+  //_______________________________________________________________________________
+  //
+  void CLsHypothesis::setTSDistribution( const CLsTSDistribution &dist ) {
+
+    if ( !fProposal.empty() )
+      throw BaseException("A distribution of the test statistics can not be used with a proposal");
+
+    fTSDist = dist;
+
+    this->clearToys();
+
+    fUseTSDist = true;
   }
 
   //_______________________________________________________________________________
   //
   double CLsHypothesis::testStatFromProb( const double &prob ) {
 
-    size_t np  = fTSVals.size();
-    size_t pos = prob*np;
+    if ( fUseTSDist )
+      return fTSDist.quantile(prob);
 
-    if ( np == pos )
-      return fTSVals.back();
+    if ( !fTSCumWgts.empty() ) {
+
+      auto it = std::lower_bound(fTSCumWgts.cbegin() + 1, fTSCumWgts.cend(),
+				 prob*fTSCumWgts.back());
+
+      return fTSVals->at(std::min<size_t>(it - fTSCumWgts.cbegin() - 1,
+					 fTSVals->size() - 1));
+    }
+
+    const size_t np = fTSVals->size();
+
+    if ( !np )
+      throw BaseException("No test-statistics values are available");
+
+    // The values are interpolated linearly using the fractional position
+    const double x = std::min(std::max(prob, 0.), 1.)*np;
+
+    const size_t pos = x;
+
+    if ( pos + 1 >= np )
+      return fTSVals->back();
+
+    const double val  = (*fTSVals)[pos];
+    const double step = (*fTSVals)[pos + 1] - val;
+
+    return val + (x - pos)*step;
+  }
+
+  //_______________________________________________________________________________
+  //
+  void CLsHypothesis::writeToys( std::ostream &os ) const {
+
+    binio::write(os, uint8_t(fUseTSDist));
+
+    if ( fUseTSDist )
+      fTSDist.write(os);
     else {
+      binio::write(os, *fTSVals);
+      binio::write(os, *fTSLogWgts);
+    }
+  }
 
-      double val  = fTSVals.at(pos);
-      double step = fTSVals.at(pos + 1) - val;
-      
-      return val + prob*step;
+  //_______________________________________________________________________________
+  //
+  void CLsHypothesis::addToys( std::vector<Doubles> &tsvals, std::vector<Doubles> &logwgts ) {
+
+    // All the toys must be either weighted or unweighted (-1 if not known yet)
+    int weighted = fTSVals->empty() ? -1 : !fTSLogWgts->empty();
+
+    for ( size_t i = 0; i < tsvals.size(); ++i ) {
+
+      if ( tsvals[i].empty() )
+	continue;
+
+      const int w = !logwgts[i].empty();
+
+      if ( weighted < 0 )
+	weighted = w;
+      else if ( w != weighted )
+	throw BaseException("Unable to combine weighted and unweighted toys");
+    }
+
+    this->detachToys();
+
+    // Weighted values are sorted together with the previous
+    if ( weighted > 0 ) {
+
+      for ( size_t i = 0; i < tsvals.size(); ++i ) {
+
+	fTSVals->insert(fTSVals->end(), tsvals[i].cbegin(), tsvals[i].cend());
+	fTSLogWgts->insert(fTSLogWgts->end(), logwgts[i].cbegin(), logwgts[i].cend());
+
+	Doubles().swap(tsvals[i]);
+	Doubles().swap(logwgts[i]);
+      }
+
+      this->sortToys();
+
+      return;
+    }
+
+    // Unweighted values are sorted and merged with the previous
+    std::vector<Doubles> runs;
+    runs.reserve(tsvals.size() + 1);
+
+    runs.push_back(Doubles());
+    runs.back().swap(*fTSVals);
+
+    for ( auto it = tsvals.begin(); it != tsvals.end(); ++it ) {
+
+      std::sort(it->begin(), it->end());
+
+      runs.push_back(Doubles());
+      runs.back().swap(*it);
+    }
+
+    mergeSorted(runs, *fTSVals);
+  }
+
+  //_______________________________________________________________________________
+  //
+  void CLsHypothesis::cacheHyp() {
+
+    fLogHyp.resize(fHyp->size());
+    fHypSum = 0;
+
+    for ( size_t i = 0; i < fHyp->size(); ++i ) {
+      fLogHyp[i] = std::log((*fHyp)[i]);
+      fHypSum   += (*fHyp)[i];
+    }
+  }
+
+  //_______________________________________________________________________________
+  //
+  void CLsHypothesis::checkParallel( const size_t &nt ) const {
+
+    if ( !fFactory )
+      throw BaseException("CLs factory is not set");
+
+    if ( nt < 2 )
+      return;
+
+    if ( fFluct && !fFluct->isThreadSafe() )
+      throw BaseException("The fluctuator can not be used to generate in parallel");
+
+    if ( !fFactory->hasThreadSafePriors() )
+      throw BaseException("The priors can not be used to generate in parallel");
+  }
+
+  //_______________________________________________________________________________
+  //
+  void CLsHypothesis::generateToys( RandomEngine &rndm,
+				    const size_t &n,
+				    Doubles &tsvals,
+				    Doubles *logwgts ) const {
+
+    const bool weighted = !fProposal.empty();
+
+    Doubles means(*fHyp), vec(fHyp->size());
+
+    // If the means are not fluctuated, the values are generated from a sampler
+    // with precomputed tables
+    if ( !fFluct ) {
+
+      PoissonSampler sampler(weighted ? fProposal : *fHyp);
+
+      for ( size_t i = 0; i < n; ++i ) {
+
+	sampler.fill(rndm, vec.data());
+
+	if ( weighted )
+	  logwgts->push_back(this->logWeight(means.data(), vec));
+
+	tsvals.push_back(fFactory->testStat(vec));
+      }
+
+      return;
+    }
+
+    for ( size_t i = 0; i < n; ++i ) {
+
+      std::copy(fHyp->cbegin(), fHyp->cend(), means.begin());
+      fFluct->fluctuateAll(means.data(), means.size(), rndm);
+
+      if ( weighted ) {
+
+	for ( size_t j = 0; j < fHyp->size(); ++j )
+	  vec[j] = rndm.poisson(means[j]*fPropRatio[j]);
+
+	logwgts->push_back(this->logWeight(means.data(), vec));
+      }
+      else
+	for ( size_t j = 0; j < fHyp->size(); ++j )
+	  vec[j] = rndm.poisson(means[j]);
+
+      tsvals.push_back(fFactory->testStat(vec));
     }
   }
 
+  //_______________________________________________________________________________
+  //
+  void CLsHypothesis::generateValues( RandomEngine &rndm,
+				      const size_t &n,
+				      Doubles &samples ) const {
+
+    const size_t nch = fHyp->size();
+
+    if ( !fFluct ) {
+
+      PoissonSampler sampler(*fHyp);
+
+      const size_t pos = samples.size();
+
+      samples.resize(pos + n*nch);
+
+      sampler.fill(rndm, n, samples.data() + pos);
+
+      return;
+    }
+
+    Doubles means(nch);
+
+    for ( size_t i = 0; i < n; ++i ) {
+
+      std::copy(fHyp->cbegin(), fHyp->cend(), means.begin());
+      fFluct->fluctuateAll(means.data(), nch, rndm);
+
+      for ( size_t j = 0; j < nch; ++j )
+	samples.push_back(rndm.poisson(means[j]));
+    }
+  }
+
+  //_______________________________________________________________________________
+  //
+  double CLsHypothesis::logWeight( const double *means, const Doubles &values ) const {
+
+    // Logarithm of the ratio of the poisson probabilities with means < m > and
+    // < m*r >, being < r > the ratio between the proposal and the hypothesis
+    double lw = 0;
+    for ( size_t i = 0; i < values.size(); ++i )
+      lw -= values[i]*fPropLogRatio[i] + means[i]*(1. - fPropRatio[i]);
+
+    return lw;
+  }
+
+  //_______________________________________________________________________________
+  //
+  void CLsHypothesis::mergeSorted( std::vector<Doubles> &runs, Doubles &output ) {
+
+    runs.erase(std::remove_if(runs.begin(), runs.end(),
+			      [] ( const Doubles &v ) { return v.empty(); }), runs.end());
+
+    // Each pass merges the vectors in pairs, halving their number
+    while ( runs.size() > 1 ) {
+
+      std::vector<Doubles> merged((runs.size() + 1)/2);
+
+      for ( size_t i = 0; i + 1 < runs.size(); i += 2 ) {
+
+	Doubles &out = merged[i/2];
+	out.resize(runs[i].size() + runs[i + 1].size());
+
+	std::merge(runs[i].cbegin(), runs[i].cend(),
+		   runs[i + 1].cbegin(), runs[i + 1].cend(), out.begin());
+
+	Doubles().swap(runs[i]);
+	Doubles().swap(runs[i + 1]);
+      }
+
+      if ( runs.size() % 2 )
+	merged.back().swap(runs.back());
+
+      runs.swap(merged);
+    }
+
+    output.clear();
+
+    if ( !runs.empty() ) {
+      output.swap(runs.front());
+      runs.clear();
+    }
+  }
+
+  //_______________________________________________________________________________
+  //
+  void CLsHypothesis::readToysBlock( std::istream &is,
+				     const bool &append,
+				     std::vector<Doubles> &tsvals,
+				     std::vector<Doubles> &logwgts ) {
+
+    uint8_t usedist;
+    binio::read(is, usedist);
+
+    if ( usedist ) {
+
+      CLsTSDistribution dist;
+      dist.read(is);
+
+      if ( append ) {
+
+	if ( !fUseTSDist )
+	  throw BaseException("Unable to add a distribution of the test statistics to a vector of values");
+
+	fTSDist.merge(dist);
+      }
+      else {
+
+	this->clearToys();
+
+	fTSDist    = dist;
+	fUseTSDist = true;
+      }
+    }
+    else {
+
+      tsvals.push_back(Doubles());
+      logwgts.push_back(Doubles());
+
+      binio::read(is, tsvals.back());
+      binio::read(is, logwgts.back());
+
+      if ( append ) {
+
+	if ( fUseTSDist )
+	  throw BaseException("Unable to add a vector of values to a distribution of the test statistics");
+      }
+      else {
+
+	this->clearToys();
+
+	fUseTSDist = false;
+      }
+    }
+  }
+
+  //_______________________________________________________________________________
+  //
+  void CLsHypothesis::sortToys() {
+
+    this->detachToys();
+
+    if ( fTSLogWgts->empty() ) {
+      std::sort(fTSVals->begin(), fTSVals->end());
+      return;
+    }
+
+    const size_t n = fTSVals->size();
+
+    Sizes idx(n);
+    std::iota(idx.begin(), idx.end(), 0);
+    std::stable_sort(idx.begin(), idx.end(), [this] ( const size_t &a, const size_t &b ) {
+	return (*fTSVals)[a] < (*fTSVals)[b];
+      });
+
+    Doubles vals(n), logwgts(n);
+    for ( size_t i = 0; i < n; ++i ) {
+      vals[i]    = (*fTSVals)[idx[i]];
+      logwgts[i] = (*fTSLogWgts)[idx[i]];
+    }
+
+    fTSVals->swap(vals);
+    fTSLogWgts->swap(logwgts);
+
+    const double mx = *std::max_element(fTSLogWgts->cbegin(), fTSLogWgts->cend());
+
+    fTSCumWgts.resize(n + 1);
+    fTSCumWgts[0] = 0;
+    for ( size_t i = 0; i < n; ++i )
+      fTSCumWgts[i + 1] = fTSCumWgts[i] + std::exp((*fTSLogWgts)[i] - mx);
+  }
+
 }
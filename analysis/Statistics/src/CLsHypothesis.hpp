@@ -7,13 +7,18 @@
 //  AUTHOR: Miguel Ramos Pernas
 //  e-mail: miguel.ramos.pernas@cern.ch
 //
-//  Last update: 10/04/2017
+//  Last update: 18/10/2026
 //
 // --------------------------------------------------------------------------------
 //
 //  Description:
 //
-//  Main class to perform analysis using the CLs method
+//  Main class to perform analysis using the CLs method. The toys can be
+//  generated from a proposal distribution different to that of the hypothesis
+//  (importance sampling), in which case each toy carries a weight equal to the
+//  ratio between the probabilities of the hypothesis and of the proposal. This
+//  allows to compute p-values in the far tails of the distributions with a small
+//  number of toys.
 //
 // --------------------------------------------------------------------------------
 ///////////////////////////////////////////////////////////////////////////////////
@@ -24,10 +29,17 @@
 
 #include "CLsFluctuator.hpp"
 #include "CLsPrior.hpp"
+#include "CLsTSDistribution.hpp"
 #include "Definitions.hpp"
+#include "RandomEngine.hpp"
 
 #include "TRandom3.h"
 
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <vector>
+
 
 //_______________________________________________________________________________
 
@@ -53,28 +65,136 @@ namespace isis {
     // Destructor
     ~CLsHypothesis();
 
-    // Return the vector containing the test-statistics values
+    // Stop using a proposal to generate the toys
+    inline void clearProposal();
+
+    // Remove the generated toys
+    inline void clearToys();
+
+    // Return the effective number of toys, (sum w)^2/(sum w^2). If no proposal
+    // is used it is equal to the number of toys.
+    double getEffectiveSize() const;
+
+    // Return the means of the proposal distribution. It is empty if no proposal
+    // is used.
+    inline const Doubles& getProposal() const;
+
+    // Return the vector containing the test-statistics values. It is empty if
+    // the values are stored in a distribution (see < setTSDistribution >).
     const Doubles& getTSVals() const;
 
+    // Return the distribution of the test-statistics values
+    inline const CLsTSDistribution& getTSDistribution() const;
+
+    // Return the logarithm of the weights of the toys, in the same order as the
+    // test-statistics values. It is empty if no proposal is used.
+    inline const Doubles& getTSLogWeights() const;
+
+    // Return shared pointers to the test-statistics values and to the logarithm
+    // of their weights. The vectors are never modified while they are shared:
+    // any function changing the toys replaces them by new vectors, so they
+    // remain valid as long as the pointers exist.
+    inline std::shared_ptr<const Doubles> shareTSVals() const;
+    inline std::shared_ptr<const Doubles> shareTSLogWeights() const;
+
     // Return the vector defining this hypothesis
     const Doubles& getHyp() const;
 
-    // Return the p-value for the given test-statistics value
+    // Return a shared pointer to the vector defining this hypothesis, which
+    // remains valid even if the hypothesis is changed afterwards
+    inline std::shared_ptr<const Doubles> shareHyp() const;
+
+    // Return the logarithm of the values defining this hypothesis
+    inline const Doubles& getLogHyp() const;
+
+    // Return the sum of the values defining this hypothesis
+    inline double getHypSum() const;
+
+    // Return the logarithm of the prior probability for the given values. If no
+    // prior is set, it returns zero.
+    double logPrior( const double *values ) const;
+
+    // Return the p-value for the given test-statistics value. If the toys are
+    // weighted, the sum of the weights of the toys is used instead of the number
+    // of toys (self-normalized estimator).
     double pValue( const double &t ) const;
 
+    // Calculate the p-values for the < n > test-statistics values in < tstats >,
+    // writing them in < pvalues >
+    void pValues( const double *tstats, const size_t &n, double *pvalues ) const;
+
     // Generate < n > events
     void generate( const size_t &n );
 
+    // Generate < n > events using < nthreads > threads (0 uses all the
+    // available). Each thread uses its own stream of random numbers, obtained
+    // from the given seed, so the results only depend on the seed and on the
+    // number of threads. The fluctuator and the priors must be thread-safe (see
+    // CLsFluctuators.hpp and CLsPriors.hpp) to use more than one thread.
+    void generate( const size_t &n, const size_t &nthreads, const uint64_t &seed );
+
+    // Same as above, but the streams of random numbers are obtained from the
+    // given generator, which is left in the state following the last of them.
+    // Calling this function again with the same generator uses new streams,
+    // which do not overlap with the previous ones.
+    void generate( const size_t &n, const size_t &nthreads, RandomEngine &engine );
+
+    // Generate < n > events using the given generators, each of them in a
+    // different thread, and add them to those already stored. As above, the
+    // fluctuator and the priors must be thread-safe to use more than one
+    // generator. The number of events per generator is fixed, so the results
+    // only depend on the state of the generators, which are advanced. This
+    // allows to generate the events in several steps (see
+    // < CLsFactory::generate >).
+    void generate( const size_t &n, std::vector<RandomEngine> &engines );
+
+    // Generate < n > sets of values of the hypothesis using the given
+    // generators, each of them in a different thread, and append them to
+    // < samples >, one set after the other. The number of sets per generator is
+    // fixed, as in < generate >, and the generators are advanced. The proposal
+    // is not used. The test-statistics values are not calculated, so the same
+    // sets can be evaluated for different factories (see < evaluateSamples >).
+    void generateSamples( const size_t &n,
+			  std::vector<RandomEngine> &engines,
+			  Doubles &samples ) const;
+
+    // Replace the toys by the test-statistics values of the given sets of values
+    // (see < generateSamples >), which are calculated using < nthreads > threads
+    // (0 uses all the available). The priors must be thread-safe to use more
+    // than one thread.
+    void evaluateSamples( const Doubles &samples, const size_t &nthreads = 1 );
+
+    // Return the fluctuator
+    inline CLsFluctuator* getFluctuator() const;
+
+    // Return the prior
+    inline CLsPrior* getPrior() const;
+
     // Return the poisson probability
     double poissonProb( const Doubles &values ) const;
 
+    // Read the toys from a binary stream (see < writeToys >). If < add > is true
+    // they are added to those already stored, otherwise they are replaced.
+    void readToys( std::istream &is, const bool &add = false );
+
+    // Read the toys from several binary streams, as above. The values read from
+    // all of them are merged at once.
+    void readToys( const std::vector<std::istream*> &streams, const bool &add = false );
+
+    // Same as above, but the toys are read from the given positions of the
+    // streams, which can appear several times. On return, the positions are
+    // those following the toys.
+    void readToys( const std::vector<std::istream*> &streams,
+		   std::vector<std::streampos> &positions,
+		   const bool &add = false );
+
     // Set the CLs factory class pointer
     inline void setFactory( const CLsFactory *factory );
 
     // Set the fluctuator class
     inline void setFluctuator( CLsFluctuator *fluct );
 
-    // Set the vector defining this hypothesis
+    // Set the vector defining this hypothesis. The proposal is removed.
     inline void setHyp( const Doubles &array,
 			CLsFluctuator *fluct = 0,
 			CLsPrior *prior = 0 );
@@ -82,11 +202,33 @@ namespace isis {
     // Set the prior
     inline void setPrior( CLsPrior *prior );
 
+    // Generate the toys from poisson distributions with the given means instead
+    // of those of the hypothesis. The means must be zero only where those of the
+    // hypothesis are. If a fluctuator is set, the fluctuated means are scaled by
+    // the ratio between the proposal and the hypothesis.
+    void setProposal( const Doubles &means );
+
+    // Generate the toys from the exponentially tilted distribution
+    // hyp^(1 - tilt)*target^tilt, which moves the toys towards the given
+    // hypothesis. A value of one generates directly from < target >.
+    void setProposal( const CLsHypothesis &target, const double &tilt = 1 );
+
     // Set the type
     inline void setType( const int &type );
 
+    // Store the test-statistics values in a copy of the given distribution
+    // instead of in a vector, so the memory needed does not grow with the number
+    // of generated values. The p-values and the test-statistics values obtained
+    // from a probability are then computed from it. It can not be used together
+    // with a proposal.
+    void setTSDistribution( const CLsTSDistribution &dist );
+
     // Get the test-statistics value associated to the given probability
     double testStatFromProb( const double &prob );
+
+    // Write the toys to a binary stream. Either the distribution of the
+    // test-statistics values or the values and their weights are written.
+    void writeToys( std::ostream &os ) const;
     
   protected:
 
@@ -96,33 +238,234 @@ namespace isis {
     // Class to fluctuate the means in the hypothesis
     CLsFluctuator *fFluct;
     
-    // Vector defining the hypothesis
-    Doubles fHyp;
+    // Vector defining the hypothesis. It is replaced, and never modified, when
+    // the hypothesis changes, so it can be shared (see < shareHyp >).
+    std::shared_ptr<Doubles> fHyp;
+
+    // Sum of the values defining the hypothesis
+    double fHypSum;
+
+    // Logarithm of the values defining the hypothesis
+    Doubles fLogHyp;
 
     // Prior for the probability
     CLsPrior *fPrior;
 
+    // Means of the proposal distribution
+    Doubles fProposal;
+
+    // Logarithm of the ratio between the proposal and the hypothesis
+    Doubles fPropLogRatio;
+
+    // Ratio between the proposal and the hypothesis
+    Doubles fPropRatio;
+
     // Random number generator
     TRandom3 fRndm;
 
+    // Cumulative sum of the weights of the toys, starting from zero. The weights
+    // are scaled by the maximum to avoid overflows.
+    Doubles fTSCumWgts;
+
+    // Distribution of the test-statistics values
+    CLsTSDistribution fTSDist;
+
+    // Logarithm of the weights of the toys
+    std::shared_ptr<Doubles> fTSLogWgts;
+
     // Vector with the values of the test-statistics
-    Doubles fTSVals;
+    std::shared_ptr<Doubles> fTSVals;
+
+    // Whether the test-statistics values are stored in < fTSDist >
+    bool fUseTSDist;
 
     // Type of the hypothesis
     int fType;
+
+  private:
+
+    // Add the given sets of test-statistics values and the logarithms of their
+    // weights to those stored. The input vectors are left in an unspecified
+    // state.
+    void addToys( std::vector<Doubles> &tsvals, std::vector<Doubles> &logwgts );
+
+    // Calculate the logarithm and the sum of the values defining the hypothesis
+    void cacheHyp();
+
+    // Check that the events can be generated using the given number of threads
+    void checkParallel( const size_t &nt ) const;
+
+    // Check that the prior, if any, can be evaluated for this hypothesis
+    inline void checkPrior() const;
+
+    // Make sure that the vectors with the toys are not shared before modifying
+    // them, copying them if needed (see < shareTSVals >)
+    inline void detachToys();
+
+    // Generate < n > sets of values of the hypothesis using the given generator,
+    // appending them to < samples >
+    void generateValues( RandomEngine &rndm, const size_t &n, Doubles &samples ) const;
+
+    // Generate < n > values of the test statistics using the given generator,
+    // appending them to < tsvals >. If a proposal is used, the logarithms of the
+    // weights are appended to < logwgts >.
+    void generateToys( RandomEngine &rndm,
+		       const size_t &n,
+		       Doubles &tsvals,
+		       Doubles *logwgts = 0 ) const;
+
+    // Return the logarithm of the weight of a toy, given the fluctuated means of
+    // the hypothesis and the generated values
+    double logWeight( const double *means, const Doubles &values ) const;
+
+    // Merge the given sorted vectors into < output >, merging them in pairs so
+    // the number of operations grows as n*log(k) for k vectors. The input
+    // vectors are left empty.
+    static void mergeSorted( std::vector<Doubles> &runs, Doubles &output );
+
+    // Read the toys from the current position of the stream. If < append > is
+    // false the stored toys are removed first. Distributions are merged
+    // directly, whilst the values and the logarithms of their weights are
+    // appended to < tsvals > and < logwgts >, so they can be added at once.
+    void readToysBlock( std::istream &is,
+			const bool &append,
+			std::vector<Doubles> &tsvals,
+			std::vector<Doubles> &logwgts );
+
+    // Sort the test-statistics values together with their weights, and calculate
+    // the cumulative sum of the weights
+    void sortToys();
+
   };
 
+  //_______________________________________________________________________________
+  //
+  inline void CLsHypothesis::checkPrior() const {
+
+    if ( fPrior )
+      fPrior->checkMeans(fHyp->data(), fHyp->size());
+  }
+
+  //_______________________________________________________________________________
+  //
+  inline void CLsHypothesis::clearProposal() {
+
+    fProposal.clear();
+    fPropLogRatio.clear();
+    fPropRatio.clear();
+  }
+
+  //_______________________________________________________________________________
+  //
+  inline void CLsHypothesis::clearToys() {
+
+    fTSDist.reset();
+    fTSCumWgts.clear();
+
+    // Shared vectors are replaced, so their owners keep the values
+    if ( fTSVals.use_count() == 1 )
+      fTSVals->clear();
+    else
+      fTSVals = std::make_shared<Doubles>();
+
+    if ( fTSLogWgts.use_count() == 1 )
+      fTSLogWgts->clear();
+    else
+      fTSLogWgts = std::make_shared<Doubles>();
+  }
+
+  //_______________________________________________________________________________
+  //
+  inline void CLsHypothesis::detachToys() {
+
+    if ( fTSVals.use_count() > 1 )
+      fTSVals = std::make_shared<Doubles>(*fTSVals);
+
+    if ( fTSLogWgts.use_count() > 1 )
+      fTSLogWgts = std::make_shared<Doubles>(*fTSLogWgts);
+  }
+
+  //_______________________________________________________________________________
+  //
+  inline CLsFluctuator* CLsHypothesis::getFluctuator() const {
+
+    return fFluct;
+  }
+
   //_______________________________________________________________________________
   //
   inline const Doubles& CLsHypothesis::getHyp() const {
 
-    return fHyp;
+    return *fHyp;
+  }
+
+  //_______________________________________________________________________________
+  //
+  inline const Doubles& CLsHypothesis::getLogHyp() const {
+
+    return fLogHyp;
+  }
+
+  //_______________________________________________________________________________
+  //
+  inline double CLsHypothesis::getHypSum() const {
+
+    return fHypSum;
+  }
+
+  //_______________________________________________________________________________
+  //
+  inline CLsPrior* CLsHypothesis::getPrior() const {
+
+    return fPrior;
+  }
+
+  //_______________________________________________________________________________
+  //
+  inline const Doubles& CLsHypothesis::getProposal() const {
+
+    return fProposal;
+  }
+
+  //_______________________________________________________________________________
+  //
+  inline const CLsTSDistribution& CLsHypothesis::getTSDistribution() const {
+
+    return fTSDist;
+  }
+
+  //_______________________________________________________________________________
+  //
+  inline const Doubles& CLsHypothesis::getTSLogWeights() const {
+
+    return *fTSLogWgts;
   }
 
   //_______________________________________________________________________________
   //
   inline const Doubles& CLsHypothesis::getTSVals() const {
     
+    return *fTSVals;
+  }
+
+  //_______________________________________________________________________________
+  //
+  inline std::shared_ptr<const Doubles> CLsHypothesis::shareTSLogWeights() const {
+
+    return fTSLogWgts;
+  }
+
+  //_______________________________________________________________________________
+  //
+  inline std::shared_ptr<const Doubles> CLsHypothesis::shareHyp() const {
+
+    return fHyp;
+  }
+
+  //_______________________________________________________________________________
+  //
+  inline std::shared_ptr<const Doubles> CLsHypothesis::shareTSVals() const {
+
     return fTSVals;
   }
 
@@ -145,10 +488,15 @@ namespace isis {
 				     CLsFluctuator *fluct,
 				     CLsPrior *prior ) {
     
-    fTSVals.clear();
+    this->clearToys();
+
     fFluct = fluct;
-    fHyp   = array;
+    fHyp   = std::make_shared<Doubles>(array);
     fPrior = prior;
+
+    this->clearProposal();
+    this->cacheHyp();
+    this->checkPrior();
   }
 
   //_______________________________________________________________________________
@@ -156,6 +504,8 @@ namespace isis {
   inline void CLsHypothesis::setPrior( CLsPrior *prior ) {
 
     fPrior = prior;
+
+    this->checkPrior();
   }
 
   //_______________________________________________________________________________
@@ -7,13 +7,15 @@
 //  AUTHOR: Miguel Ramos Pernas
 //  e-mail: miguel.ramos.pernas@cern.ch
 //
-//  Last update: 10/04/2017
+//  Last update: 18/10/2026
 //
 // --------------------------------------------------------------------------------
 //
 //  Description:
 //
-//  Abstract class to add priors to the CLs method
+//  Abstract class to add priors to the CLs method. Classes which can be used
+//  from several threads at once must override < logEvaluateAll > and
+//  < isThreadSafe >. Some implementations are provided in CLsPriors.hpp.
 //
 // --------------------------------------------------------------------------------
 ///////////////////////////////////////////////////////////////////////////////////
@@ -22,6 +24,7 @@
 #ifndef CLS_PRIOR
 #define CLS_PRIOR
 
+#include <cmath>
 #include <iostream>
 
 
@@ -45,6 +48,29 @@ namespace isis {
 			     const double &mean,
 			     const double &value ) = 0;
 
+    // Check that the prior can be evaluated for the < n > means of a
+    // hypothesis, throwing an exception otherwise. By default any mean is
+    // accepted.
+    virtual void checkMeans( const double *, const size_t & ) const { }
+
+    // Return whether < logEvaluateAll > can be called from several threads at
+    // once
+    virtual bool isThreadSafe() const { return false; }
+
+    // Return the sum of the logarithms of the prior for the < n > means and
+    // values of a hypothesis. By default < evaluate > is called for each of
+    // them.
+    virtual double logEvaluateAll( const double *means,
+				   const double *values,
+				   const size_t &n ) {
+
+      double lp = 0;
+      for ( size_t i = 0; i < n; ++i )
+	lp += std::log(this->evaluate(i, means[i], values[i]));
+
+      return lp;
+    }
+
   };
 
 }
@@ -0,0 +1,183 @@
+///////////////////////////////////////////////////////////////////////////////////
+//
+//  Analysis package
+//
+// --------------------------------------------------------------------------------
+//
+//  AUTHOR: Miguel Ramos Pernas
+//  e-mail: miguel.ramos.pernas@cern.ch
+//
+//  Last update: 18/10/2026
+//
+// --------------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////////
+
+
+#include "CLsPriors.hpp"
+#include "Definitions.hpp"
+#include "Exceptions.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+
+//_______________________________________________________________________________
+
+namespace isis {
+
+  //_______________________________________________________________________________
+  //
+  constexpr double CLsNativePrior::MinValue;
+
+  //_______________________________________________________________________________
+  //
+  CLsNativePrior::CLsNativePrior() : CLsPrior() { }
+
+  //_______________________________________________________________________________
+  //
+  CLsNativePrior::~CLsNativePrior() { }
+
+  //_______________________________________________________________________________
+  //
+  void CLsNativePrior::checkMeans( const double *means, const size_t &n ) const {
+
+    for ( size_t i = 0; i < n; ++i )
+      if ( means[i] <= 0 )
+	throw BaseException("The means of the hypothesis must be greater than "
+			    "zero to evaluate the prior");
+  }
+
+  //_______________________________________________________________________________
+  //
+  double CLsNativePrior::evaluate( const size_t &pos,
+				   const double &mean,
+				   const double &value ) {
+
+    return std::exp(this->logDensity(pos, mean, value));
+  }
+
+  //_______________________________________________________________________________
+  //
+  double CLsNativePrior::logEvaluateAll( const double *means,
+					 const double *values,
+					 const size_t &n ) {
+
+    double lp = 0;
+    for ( size_t i = 0; i < n; ++i )
+      lp += this->logDensity(i, means[i], values[i]);
+
+    return lp;
+  }
+
+  //_______________________________________________________________________________
+  //
+  CLsFlatPrior::CLsFlatPrior() : CLsNativePrior() { }
+
+  //_______________________________________________________________________________
+  //
+  CLsFlatPrior::~CLsFlatPrior() { }
+
+  //_______________________________________________________________________________
+  //
+  void CLsFlatPrior::checkMeans( const double *, const size_t & ) const { }
+
+  //_______________________________________________________________________________
+  //
+  double CLsFlatPrior::logDensity( const size_t &,
+				   const double &,
+				   const double & ) const {
+
+    return 0;
+  }
+
+  //_______________________________________________________________________________
+  //
+  CLsGaussPrior::CLsGaussPrior( const Doubles &sigmas ) :
+    CLsNativePrior(), fSigmas( sigmas ) {
+
+    for ( auto it = sigmas.cbegin(); it != sigmas.cend(); ++it )
+      if ( *it <= 0 )
+	throw BaseException("Uncertainties must be greater than zero");
+  }
+
+  //_______________________________________________________________________________
+  //
+  CLsGaussPrior::~CLsGaussPrior() { }
+
+  //_______________________________________________________________________________
+  //
+  double CLsGaussPrior::logDensity( const size_t &pos,
+				    const double &mean,
+				    const double &value ) const {
+
+    const double s = fSigmas.at(pos)*mean;
+    const double z = (value - mean)/s;
+
+    return -0.5*z*z - std::log(s) - 0.5*std::log(2*M_PI);
+  }
+
+  //_______________________________________________________________________________
+  //
+  CLsLogNormPrior::CLsLogNormPrior( const Doubles &sigmas ) :
+    CLsNativePrior(), fLogSigmas( sigmas.size() ) {
+
+    for ( size_t i = 0; i < sigmas.size(); ++i ) {
+
+      if ( sigmas[i] <= 0 )
+	throw BaseException("Uncertainties must be greater than zero");
+
+      fLogSigmas[i] = std::sqrt(std::log(1. + sigmas[i]*sigmas[i]));
+    }
+  }
+
+  //_______________________________________________________________________________
+  //
+  CLsLogNormPrior::~CLsLogNormPrior() { }
+
+  //_______________________________________________________________________________
+  //
+  double CLsLogNormPrior::logDensity( const size_t &pos,
+				      const double &mean,
+				      const double &value ) const {
+
+    const double x = std::max(value, MinValue);
+
+    const double s = fLogSigmas.at(pos);
+    const double z = (std::log(x/mean) + 0.5*s*s)/s;
+
+    return -0.5*z*z - std::log(s*x) - 0.5*std::log(2*M_PI);
+  }
+
+  //_______________________________________________________________________________
+  //
+  CLsGammaPrior::CLsGammaPrior( const Doubles &sigmas ) :
+    CLsNativePrior(), fShapes( sigmas.size() ) {
+
+    for ( size_t i = 0; i < sigmas.size(); ++i ) {
+
+      if ( sigmas[i] <= 0 )
+	throw BaseException("Uncertainties must be greater than zero");
+
+      fShapes[i] = 1./(sigmas[i]*sigmas[i]);
+    }
+  }
+
+  //_______________________________________________________________________________
+  //
+  CLsGammaPrior::~CLsGammaPrior() { }
+
+  //_______________________________________________________________________________
+  //
+  double CLsGammaPrior::logDensity( const size_t &pos,
+				    const double &mean,
+				    const double &value ) const {
+
+    const double x = std::max(value, MinValue);
+
+    const double k     = fShapes.at(pos);
+    const double theta = mean/k;
+
+    return (k - 1)*std::log(x) - x/theta - std::lgamma(k) - k*std::log(theta);
+  }
+
+}
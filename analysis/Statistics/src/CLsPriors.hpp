@@ -0,0 +1,174 @@
+///////////////////////////////////////////////////////////////////////////////////
+//
+//  Analysis package
+//
+// --------------------------------------------------------------------------------
+//
+//  AUTHOR: Miguel Ramos Pernas
+//  e-mail: miguel.ramos.pernas@cern.ch
+//
+//  Last update: 18/10/2026
+//
+// --------------------------------------------------------------------------------
+//
+//  Description:
+//
+//  Native implementations of priors for the CLs method. They evaluate the
+//  density of the observed value given the mean of the hypothesis, with a width
+//  given as a relative uncertainty on the mean for each channel. All of them
+//  are thread-safe, so they can be used to generate in parallel. The means
+//  must be greater than zero, except for the flat prior. Since the observed
+//  values are counts, the log-normal and gamma densities, which vanish or
+//  diverge at zero, are evaluated at < MinValue > for smaller values.
+//
+// --------------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef CLS_PRIORS
+#define CLS_PRIORS
+
+#include "CLsPrior.hpp"
+#include "Definitions.hpp"
+
+
+//_______________________________________________________________________________
+
+namespace isis {
+
+  // Base class for the native priors
+  class CLsNativePrior : public CLsPrior {
+
+  public:
+
+    // Values below this one are evaluated at it by the continuous densities
+    static constexpr double MinValue = 0.5;
+
+    // Constructor
+    CLsNativePrior();
+
+    // Destructor
+    virtual ~CLsNativePrior();
+
+    // Check that all the means are greater than zero
+    virtual void checkMeans( const double *means, const size_t &n ) const;
+
+    // Evaluate the prior for the given position, mean and value
+    double evaluate( const size_t &pos, const double &mean, const double &value );
+
+    // The class is thread-safe
+    inline bool isThreadSafe() const;
+
+    // Return the sum of the logarithms of the prior for all the channels
+    double logEvaluateAll( const double *means, const double *values, const size_t &n );
+
+  protected:
+
+    // Return the logarithm of the prior
+    virtual double logDensity( const size_t &pos,
+			       const double &mean,
+			       const double &value ) const = 0;
+
+  };
+
+  //_______________________________________________________________________________
+  //
+  inline bool CLsNativePrior::isThreadSafe() const {
+
+    return true;
+  }
+
+
+  // Flat prior
+  class CLsFlatPrior : public CLsNativePrior {
+
+  public:
+
+    // Constructor
+    CLsFlatPrior();
+
+    // Destructor
+    ~CLsFlatPrior();
+
+    // Any mean is accepted
+    void checkMeans( const double *means, const size_t &n ) const;
+
+  protected:
+
+    // Return zero
+    double logDensity( const size_t &pos, const double &mean, const double &value ) const;
+
+  };
+
+
+  // Normal density with the mean of the hypothesis and a standard deviation
+  // given by the relative uncertainty times the mean
+  class CLsGaussPrior : public CLsNativePrior {
+
+  public:
+
+    // Constructor given the relative uncertainties
+    CLsGaussPrior( const Doubles &sigmas );
+
+    // Destructor
+    ~CLsGaussPrior();
+
+  protected:
+
+    // Relative uncertainties
+    Doubles fSigmas;
+
+    // Return the logarithm of the density
+    double logDensity( const size_t &pos, const double &mean, const double &value ) const;
+
+  };
+
+
+  // Log-normal density with the mean of the hypothesis and a relative standard
+  // deviation given by the uncertainty
+  class CLsLogNormPrior : public CLsNativePrior {
+
+  public:
+
+    // Constructor given the relative uncertainties
+    CLsLogNormPrior( const Doubles &sigmas );
+
+    // Destructor
+    ~CLsLogNormPrior();
+
+  protected:
+
+    // Standard deviations of the logarithm of the values
+    Doubles fLogSigmas;
+
+    // Return the logarithm of the density
+    double logDensity( const size_t &pos, const double &mean, const double &value ) const;
+
+  };
+
+
+  // Gamma density with the mean of the hypothesis and a relative standard
+  // deviation given by the uncertainty
+  class CLsGammaPrior : public CLsNativePrior {
+
+  public:
+
+    // Constructor given the relative uncertainties
+    CLsGammaPrior( const Doubles &sigmas );
+
+    // Destructor
+    ~CLsGammaPrior();
+
+  protected:
+
+    // Shapes of the distributions (the inverse of the squared uncertainties)
+    Doubles fShapes;
+
+    // Return the logarithm of the density
+    double logDensity( const size_t &pos, const double &mean, const double &value ) const;
+
+  };
+
+}
+
+#endif
@@ -0,0 +1,112 @@
+///////////////////////////////////////////////////////////////////////////////////
+//
+//  Analysis package
+//
+// --------------------------------------------------------------------------------
+//
+//  AUTHOR: Miguel Ramos Pernas
+//  e-mail: miguel.ramos.pernas@cern.ch
+//
+//  Last update: 18/10/2026
+//
+// --------------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////////
+
+
+#include "CLsScanResult.hpp"
+#include "Definitions.hpp"
+#include "Exceptions.hpp"
+
+#include <string>
+
+
+//_______________________________________________________________________________
+
+namespace isis {
+
+  //_______________________________________________________________________________
+  //
+  CLsScanResult::CLsScanResult( const Doubles &mu,
+				const std::vector<std::vector<CLsResult> > &results ) :
+    fMu( mu ) {
+
+    if ( results.size() != mu.size() )
+      throw BaseException("The number of results does not match the number of points");
+
+    const size_t nrows = results.empty() ? 2*MaxSigma + 1 : results.front().size();
+
+    fCLb.assign(nrows, Doubles(mu.size()));
+    fCLs.assign(nrows, Doubles(mu.size()));
+    fCLsb.assign(nrows, Doubles(mu.size()));
+
+    for ( size_t i = 0; i < results.size(); ++i ) {
+
+      if ( results[i].size() != nrows )
+	throw BaseException("All the points must have the same number of results");
+
+      for ( size_t j = 0; j < nrows; ++j ) {
+	fCLb[j][i]  = results[i][j].CLb();
+	fCLs[j][i]  = results[i][j].CLs();
+	fCLsb[j][i] = results[i][j].CLsb();
+      }
+    }
+  }
+
+  //_______________________________________________________________________________
+  //
+  CLsScanResult::~CLsScanResult() { }
+
+  //_______________________________________________________________________________
+  //
+  double CLsScanResult::expectedUpperLimit( const int &nsigma, const double &cl ) const {
+
+    return this->upperLimit(this->expectedCLs(nsigma), cl);
+  }
+
+  //_______________________________________________________________________________
+  //
+  double CLsScanResult::observedUpperLimit( const double &cl ) const {
+
+    if ( !this->hasObserved() )
+      throw BaseException("The observed values have not been calculated");
+
+    return this->upperLimit(this->observedCLs(), cl);
+  }
+
+  //_______________________________________________________________________________
+  //
+  size_t CLsScanResult::band( const int &nsigma ) const {
+
+    if ( nsigma < -MaxSigma || nsigma > MaxSigma )
+      throw BaseException("The number of standard deviations must be in [" +
+			  std::to_string(-MaxSigma) + ", " +
+			  std::to_string(MaxSigma) + "]");
+
+    return nsigma + MaxSigma;
+  }
+
+  //_______________________________________________________________________________
+  //
+  double CLsScanResult::upperLimit( const Doubles &cls, const double &cl ) const {
+
+    const double alpha = 1. - cl;
+
+    // The CLs values decrease with the signal strength, so the first point below
+    // the threshold is looked for
+    for ( size_t i = 0; i < cls.size(); ++i ) {
+
+      if ( cls[i] >= alpha )
+	continue;
+
+      if ( i == 0 )
+	throw BaseException("The upper limit is below the scanned range");
+
+      const double f = (cls[i - 1] - alpha)/(cls[i - 1] - cls[i]);
+
+      return fMu[i - 1] + f*(fMu[i] - fMu[i - 1]);
+    }
+
+    throw BaseException("The upper limit is above the scanned range");
+  }
+
+}
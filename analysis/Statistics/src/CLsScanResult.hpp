@@ -0,0 +1,173 @@
+///////////////////////////////////////////////////////////////////////////////////
+//
+//  Analysis package
+//
+// --------------------------------------------------------------------------------
+//
+//  AUTHOR: Miguel Ramos Pernas
+//  e-mail: miguel.ramos.pernas@cern.ch
+//
+//  Last update: 18/10/2026
+//
+// --------------------------------------------------------------------------------
+//
+//  Description:
+//
+//  Class to store the results of a scan of the CLs values as a function of the
+//  signal strength. For each point, the expected values are calculated at the
+//  quantiles of the test statistic of the null hypothesis corresponding to -2,
+//  -1, 0, +1 and +2 standard deviations, and the observed values are calculated
+//  if an observation is given.
+//
+// --------------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef CLS_SCAN_RESULT
+#define CLS_SCAN_RESULT
+
+#include "CLsResult.hpp"
+#include "Definitions.hpp"
+
+#include <vector>
+
+
+//_______________________________________________________________________________
+
+namespace isis {
+
+  class CLsScanResult {
+
+  public:
+
+    // Number of standard deviations of the expected bands
+    static const int MaxSigma = 2;
+
+    // Constructor given the signal strengths and the results at each of them.
+    // For each point, the first < 2*MaxSigma + 1 > results correspond to the
+    // expected values, from -MaxSigma to +MaxSigma standard deviations. An
+    // additional result is provided if the observed values are calculated.
+    CLsScanResult( const Doubles &mu,
+		   const std::vector<std::vector<CLsResult> > &results );
+
+    // Destructor
+    ~CLsScanResult();
+
+    // Return the expected CLb values for the given number of standard deviations
+    inline const Doubles& expectedCLb( const int &nsigma = 0 ) const;
+
+    // Return the expected CLs values for the given number of standard deviations
+    inline const Doubles& expectedCLs( const int &nsigma = 0 ) const;
+
+    // Return the expected CLsb values for the given number of standard deviations
+    inline const Doubles& expectedCLsb( const int &nsigma = 0 ) const;
+
+    // Return the expected upper limit on the signal strength for the given number
+    // of standard deviations and confidence level. It is calculated by linear
+    // interpolation between the points of the scan.
+    double expectedUpperLimit( const int &nsigma = 0, const double &cl = 0.95 ) const;
+
+    // Return the signal strengths
+    inline const Doubles& getMu() const;
+
+    // Return whether the observed values have been calculated
+    inline bool hasObserved() const;
+
+    // Return the observed CLb values
+    inline const Doubles& observedCLb() const;
+
+    // Return the observed CLs values
+    inline const Doubles& observedCLs() const;
+
+    // Return the observed CLsb values
+    inline const Doubles& observedCLsb() const;
+
+    // Return the observed upper limit on the signal strength for the given
+    // confidence level. It is calculated by linear interpolation between the
+    // points of the scan.
+    double observedUpperLimit( const double &cl = 0.95 ) const;
+
+  protected:
+
+    // CLb values. The last row corresponds to the observed values.
+    std::vector<Doubles> fCLb;
+
+    // CLs values. The last row corresponds to the observed values.
+    std::vector<Doubles> fCLs;
+
+    // CLsb values. The last row corresponds to the observed values.
+    std::vector<Doubles> fCLsb;
+
+    // Signal strengths
+    Doubles fMu;
+
+  private:
+
+    // Return the index of the row associated to the given number of standard
+    // deviations
+    size_t band( const int &nsigma ) const;
+
+    // Return the signal strength where the given CLs values cross 1 - < cl >
+    double upperLimit( const Doubles &cls, const double &cl ) const;
+
+  };
+
+  //_______________________________________________________________________________
+  //
+  inline const Doubles& CLsScanResult::expectedCLb( const int &nsigma ) const {
+
+    return fCLb[this->band(nsigma)];
+  }
+
+  //_______________________________________________________________________________
+  //
+  inline const Doubles& CLsScanResult::expectedCLs( const int &nsigma ) const {
+
+    return fCLs[this->band(nsigma)];
+  }
+
+  //_______________________________________________________________________________
+  //
+  inline const Doubles& CLsScanResult::expectedCLsb( const int &nsigma ) const {
+
+    return fCLsb[this->band(nsigma)];
+  }
+
+  //_______________________________________________________________________________
+  //
+  inline const Doubles& CLsScanResult::getMu() const {
+
+    return fMu;
+  }
+
+  //_______________________________________________________________________________
+  //
+  inline bool CLsScanResult::hasObserved() const {
+
+    return fCLs.size() > size_t(2*MaxSigma + 1);
+  }
+
+  //_______________________________________________________________________________
+  //
+  inline const Doubles& CLsScanResult::observedCLb() const {
+
+    return fCLb.at(2*MaxSigma + 1);
+  }
+
+  //_______________________________________________________________________________
+  //
+  inline const Doubles& CLsScanResult::observedCLs() const {
+
+    return fCLs.at(2*MaxSigma + 1);
+  }
+
+  //_______________________________________________________________________________
+  //
+  inline const Doubles& CLsScanResult::observedCLsb() const {
+
+    return fCLsb.at(2*MaxSigma + 1);
+  }
+
+}
+
+#endif
@@ -0,0 +1,463 @@
+///////////////////////////////////////////////////////////////////////////////////
+//
+//  Analysis package
+//
+// --------------------------------------------------------------------------------
+//
+//  AUTHOR: Miguel Ramos Pernas
+//  e-mail: miguel.ramos.pernas@cern.ch
+//
+//  Last update: 18/10/2026
+//
+// --------------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////////
+
+
+#include "BinaryIO.hpp"
+#include "CLsTSDistribution.hpp"
+#include "Definitions.hpp"
+#include "Exceptions.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <numeric>
+
+
+//_______________________________________________________________________________
+
+namespace isis {
+
+  //_______________________________________________________________________________
+  //
+  CLsTSDistribution::CLsTSDistribution( const size_t &nbins,
+					const size_t &ntail,
+					const size_t &nexact ) :
+    fUpdated( false ),
+    fNbins( nbins ),
+    fNentries( 0 ),
+    fNexact( nexact ),
+    fNtail( ntail ) {
+
+    if ( !nbins )
+      throw BaseException("The number of bins must be greater than zero");
+
+    if ( nexact <= 2*ntail )
+      throw BaseException("The number of values stored exactly must be greater "
+			  "than the number of values in the two tails");
+  }
+
+  //_______________________________________________________________________________
+  //
+  CLsTSDistribution::~CLsTSDistribution() { }
+
+  //_______________________________________________________________________________
+  //
+  double CLsTSDistribution::countBelow( const double &t ) const {
+
+    this->update();
+
+    if ( this->isExact() )
+      return std::upper_bound(fExact.cbegin(), fExact.cend(), t) - fExact.cbegin();
+
+    double n =
+      (std::upper_bound(fLowSorted.cbegin(), fLowSorted.cend(), t) - fLowSorted.cbegin()) +
+      (std::upper_bound(fHighSorted.cbegin(), fHighSorted.cend(), t) - fHighSorted.cbegin());
+
+    return n + this->histCountBelow(t);
+  }
+
+  //_______________________________________________________________________________
+  //
+  void CLsTSDistribution::fill( const double &t ) {
+
+    ++fNentries;
+    fUpdated = false;
+
+    if ( this->isExact() ) {
+
+      fExact.push_back(t);
+
+      if ( fExact.size() > fNexact )
+	this->build();
+    }
+    else
+      this->fillHist(t);
+  }
+
+  //_______________________________________________________________________________
+  //
+  void CLsTSDistribution::fill( const Doubles &values ) {
+
+    for ( auto it = values.cbegin(); it != values.cend(); ++it )
+      this->fill(*it);
+  }
+
+  //_______________________________________________________________________________
+  //
+  void CLsTSDistribution::merge( const CLsTSDistribution &other ) {
+
+    if ( &other == this ) {
+      CLsTSDistribution copy(other);
+      this->merge(copy);
+      return;
+    }
+
+    if ( other.isExact() ) {
+      this->fill(other.fExact);
+      return;
+    }
+
+    // The binning of the other distribution is used
+    if ( this->isExact() ) {
+
+      Doubles values;
+      values.swap(fExact);
+
+      *this = other;
+
+      this->fill(values);
+
+      return;
+    }
+
+    fNentries += other.fNentries;
+    fUpdated   = false;
+
+    // The values in the tails of the other distribution are always more extreme
+    // than those in its histogram, so the tails must be filled first to keep the
+    // lowest and highest values in the tails of this one
+    for ( auto it = other.fLowTail.cbegin(); it != other.fLowTail.cend(); ++it )
+      this->fillHist(*it);
+    for ( auto it = other.fHighTail.cbegin(); it != other.fHighTail.cend(); ++it )
+      this->fillHist(*it);
+
+    other.update();
+
+    if ( other.fCumulative.empty() || other.fCumulative.back() <= 0 )
+      return;
+
+    if ( fEdges == other.fEdges ) {
+
+      for ( size_t i = 0; i < fCounts.size(); ++i )
+	if ( other.fCounts[i] > 0 )
+	  this->fillBin(i, other.fCounts[i], other.fBinMin[i], other.fBinMax[i]);
+    }
+    else {
+
+      // The content is redistributed using the cumulative distribution of the
+      // other histogram at the edges of this one
+      const double
+	vmin = *std::min_element(other.fBinMin.cbegin(), other.fBinMin.cend()),
+	vmax = *std::max_element(other.fBinMax.cbegin(), other.fBinMax.cend());
+
+      double prev = 0;
+      for ( size_t i = 0; i < fCounts.size(); ++i ) {
+
+	double cur = i < fEdges.size() ?
+	  other.histCountBelow(fEdges[i]) : other.fCumulative.back();
+
+	if ( cur > prev )
+	  this->fillBin(i, cur - prev,
+			i ? std::max(fEdges[i - 1], vmin) : vmin,
+			i < fEdges.size() ? std::min(fEdges[i], vmax) : vmax);
+
+	prev = cur;
+      }
+    }
+  }
+
+  //_______________________________________________________________________________
+  //
+  double CLsTSDistribution::quantile( const double &prob ) const {
+
+    if ( !fNentries )
+      throw BaseException("The distribution is empty");
+
+    if ( prob < 0 || prob > 1 )
+      throw BaseException("The probability must be in [0, 1]");
+
+    this->update();
+
+    if ( this->isExact() ) {
+
+      double pos = prob*(fExact.size() - 1);
+      size_t i   = pos;
+
+      if ( i + 1 >= fExact.size() )
+	return fExact.back();
+
+      return fExact[i] + (pos - i)*(fExact[i + 1] - fExact[i]);
+    }
+
+    // Index of the value in the tails associated to a given count
+    auto index = [] ( const double &c, const size_t &n ) -> size_t {
+      size_t i = c > 0 ? std::ceil(c) - 1 : 0;
+      return std::min(i, n - 1);
+    };
+
+    double c = prob*fNentries;
+
+    if ( !fLowSorted.empty() && c <= fLowSorted.size() )
+      return fLowSorted[index(c, fLowSorted.size())];
+
+    c -= fLowSorted.size();
+
+    const double nhist = fCumulative.empty() ? 0 : fCumulative.back();
+
+    if ( nhist > 0 && (c <= nhist || fHighSorted.empty()) ) {
+
+      c = std::min(c, nhist);
+
+      size_t ib = std::lower_bound(fCumulative.cbegin(), fCumulative.cend(), c) -
+	fCumulative.cbegin();
+
+      while ( fCounts[ib] <= 0 && ib + 1 < fCounts.size() )
+	++ib;
+
+      double below = ib ? fCumulative[ib - 1] : 0;
+
+      double frac = std::min(std::max((c - below)/fCounts[ib], 0.), 1.);
+
+      return fBinMin[ib] + frac*(fBinMax[ib] - fBinMin[ib]);
+    }
+
+    c -= nhist;
+
+    if ( fHighSorted.empty() )
+      return fLowSorted.back();
+
+    return fHighSorted[index(c, fHighSorted.size())];
+  }
+
+  //_______________________________________________________________________________
+  //
+  void CLsTSDistribution::read( std::istream &is ) {
+
+    uint64_t nbins, nentries, nexact, ntail;
+
+    binio::read(is, nbins);
+    binio::read(is, nentries);
+    binio::read(is, nexact);
+    binio::read(is, ntail);
+
+    fNbins    = nbins;
+    fNentries = nentries;
+    fNexact   = nexact;
+    fNtail    = ntail;
+
+    binio::read(is, fEdges);
+    binio::read(is, fCounts);
+    binio::read(is, fBinMin);
+    binio::read(is, fBinMax);
+    binio::read(is, fExact);
+    binio::read(is, fLowTail);
+    binio::read(is, fHighTail);
+
+    fCumulative.clear();
+    fHighSorted.clear();
+    fLowSorted.clear();
+
+    fUpdated = false;
+  }
+
+  //_______________________________________________________________________________
+  //
+  void CLsTSDistribution::reset( const bool &keepbins ) {
+
+    fCumulative.clear();
+    fExact.clear();
+    fHighSorted.clear();
+    fHighTail.clear();
+    fLowSorted.clear();
+    fLowTail.clear();
+
+    if ( !keepbins )
+      fEdges.clear();
+
+    const size_t nb = fEdges.empty() ? 0 : fEdges.size() + 1;
+
+    fBinMax.assign(nb, 0);
+    fBinMin.assign(nb, 0);
+    fCounts.assign(nb, 0);
+
+    fNentries = 0;
+    fUpdated  = false;
+  }
+
+  //_______________________________________________________________________________
+  //
+  void CLsTSDistribution::write( std::ostream &os ) const {
+
+    binio::write(os, uint64_t(fNbins));
+    binio::write(os, uint64_t(fNentries));
+    binio::write(os, uint64_t(fNexact));
+    binio::write(os, uint64_t(fNtail));
+
+    binio::write(os, fEdges);
+    binio::write(os, fCounts);
+    binio::write(os, fBinMin);
+    binio::write(os, fBinMax);
+    binio::write(os, fExact);
+    binio::write(os, fLowTail);
+    binio::write(os, fHighTail);
+  }
+
+  //_______________________________________________________________________________
+  //
+  double CLsTSDistribution::binCountBelow( const size_t &ib, const double &t ) const {
+
+    if ( fCounts[ib] <= 0 || t < fBinMin[ib] )
+      return 0;
+
+    if ( t >= fBinMax[ib] )
+      return fCounts[ib];
+
+    // The content is assumed to be uniformly distributed inside the bin
+    return fCounts[ib]*(t - fBinMin[ib])/(fBinMax[ib] - fBinMin[ib]);
+  }
+
+  //_______________________________________________________________________________
+  //
+  void CLsTSDistribution::build() {
+
+    Doubles values;
+    values.swap(fExact);
+
+    std::sort(values.begin(), values.end());
+
+    // If there are less different values than bins, they are used as edges
+    std::unique_copy(values.cbegin(), values.cend(), std::back_inserter(fEdges));
+
+    if ( fEdges.size() > fNbins ) {
+
+      // The edges are placed at quantiles equally spaced in log(p/(1 - p)), so
+      // the relative error on the fraction of values below or above an edge is
+      // the same for all of them
+      fEdges.clear();
+
+      const size_t n = values.size();
+
+      const double ymax = std::log(2.*n - 1);
+
+      for ( size_t i = 1; i <= fNbins; ++i ) {
+
+	double y = ymax*(2.*i/fNbins - 1);
+	double p = 1./(1. + std::exp(-y));
+
+	size_t idx = std::max(std::ceil(p*n), 1.) - 1;
+
+	fEdges.push_back(values[std::min(idx, n - 1)]);
+      }
+
+      fEdges.erase(std::unique(fEdges.begin(), fEdges.end()), fEdges.end());
+    }
+
+    fBinMax.assign(fEdges.size() + 1, 0);
+    fBinMin.assign(fEdges.size() + 1, 0);
+    fCounts.assign(fEdges.size() + 1, 0);
+
+    for ( auto it = values.cbegin(); it != values.cend(); ++it )
+      this->fillHist(*it);
+  }
+
+  //_______________________________________________________________________________
+  //
+  void CLsTSDistribution::fillBin( const size_t &ib,
+				   const double &n,
+				   const double &vmin,
+				   const double &vmax ) {
+
+    if ( fCounts[ib] > 0 ) {
+      fBinMin[ib] = std::min(fBinMin[ib], vmin);
+      fBinMax[ib] = std::max(fBinMax[ib], vmax);
+    }
+    else {
+      fBinMin[ib] = vmin;
+      fBinMax[ib] = vmax;
+    }
+
+    fCounts[ib] += n;
+  }
+
+  //_______________________________________________________________________________
+  //
+  void CLsTSDistribution::fillHist( const double &t ) {
+
+    double v = t;
+
+    // The lowest values are kept in a heap with the maximum on top
+    if ( fNtail ) {
+
+      if ( fLowTail.size() < fNtail ) {
+	fLowTail.push_back(v);
+	std::push_heap(fLowTail.begin(), fLowTail.end());
+	return;
+      }
+
+      if ( v < fLowTail.front() ) {
+	std::pop_heap(fLowTail.begin(), fLowTail.end());
+	std::swap(v, fLowTail.back());
+	std::push_heap(fLowTail.begin(), fLowTail.end());
+      }
+
+      // The highest values are kept in a heap with the minimum on top
+      if ( fHighTail.size() < fNtail ) {
+	fHighTail.push_back(v);
+	std::push_heap(fHighTail.begin(), fHighTail.end(), std::greater<double>());
+	return;
+      }
+
+      if ( v > fHighTail.front() ) {
+	std::pop_heap(fHighTail.begin(), fHighTail.end(), std::greater<double>());
+	std::swap(v, fHighTail.back());
+	std::push_heap(fHighTail.begin(), fHighTail.end(), std::greater<double>());
+      }
+    }
+
+    // Bins are closed on the right
+    size_t ib = std::lower_bound(fEdges.cbegin(), fEdges.cend(), v) - fEdges.cbegin();
+
+    this->fillBin(ib, 1, v, v);
+  }
+
+  //_______________________________________________________________________________
+  //
+  double CLsTSDistribution::histCountBelow( const double &t ) const {
+
+    if ( fCumulative.empty() )
+      return 0;
+
+    // All the values in the previous bins are lower than < t >
+    size_t ib = std::lower_bound(fEdges.cbegin(), fEdges.cend(), t) - fEdges.cbegin();
+
+    double below = ib ? fCumulative[ib - 1] : 0;
+
+    return below + this->binCountBelow(ib, t);
+  }
+
+  //_______________________________________________________________________________
+  //
+  void CLsTSDistribution::update() const {
+
+    if ( fUpdated )
+      return;
+
+    if ( this->isExact() )
+      std::sort(fExact.begin(), fExact.end());
+    else {
+
+      fLowSorted = fLowTail;
+      std::sort(fLowSorted.begin(), fLowSorted.end());
+
+      fHighSorted = fHighTail;
+      std::sort(fHighSorted.begin(), fHighSorted.end());
+
+      fCumulative.resize(fCounts.size());
+      std::partial_sum(fCounts.cbegin(), fCounts.cend(), fCumulative.begin());
+    }
+
+    fUpdated = true;
+  }
+
+}
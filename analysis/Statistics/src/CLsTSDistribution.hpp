@@ -0,0 +1,206 @@
+///////////////////////////////////////////////////////////////////////////////////
+//
+//  Analysis package
+//
+// --------------------------------------------------------------------------------
+//
+//  AUTHOR: Miguel Ramos Pernas
+//  e-mail: miguel.ramos.pernas@cern.ch
+//
+//  Last update: 18/10/2026
+//
+// --------------------------------------------------------------------------------
+//
+//  Description:
+//
+//  Class to store the distribution of a test statistic using a bounded amount of
+//  memory. The first values are stored exactly. Once their number exceeds a
+//  given threshold, the lowest and highest values are kept exactly in two tail
+//  buffers, and the rest are counted in a fine histogram whose edges are the
+//  quantiles of the values seen so far, equally spaced in log(p/(1 - p)), so
+//  the relative error of the p-values is similar in the center and in the
+//  tails. The minimum and maximum values in each bin are stored, and the
+//  cumulative distribution is linearly interpolated between them. If the test
+//  statistic takes less values than bins (as it happens with few channels),
+//  each value has its own bin and the distribution is still exact.
+//
+// --------------------------------------------------------------------------------
+///////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef CLS_TS_DISTRIBUTION
+#define CLS_TS_DISTRIBUTION
+
+#include "Definitions.hpp"
+
+#include <iostream>
+
+
+//_______________________________________________________________________________
+
+namespace isis {
+
+  class CLsTSDistribution {
+
+  public:
+
+    // Constructor given the number of bins of the histogram, the number of
+    // values stored in each tail and the number of values stored before
+    // building the histogram. The last must be greater than twice the number
+    // of values in the tails.
+    CLsTSDistribution( const size_t &nbins  = 100000,
+		       const size_t &ntail  = 100000,
+		       const size_t &nexact = 1000000 );
+
+    // Destructor
+    ~CLsTSDistribution();
+
+    // Return the estimated number of values lower or equal than < t >
+    double countBelow( const double &t ) const;
+
+    // Add a new value to the distribution. The edges of the histogram are
+    // calculated from the first values, so they must be given in random order.
+    void fill( const double &t );
+
+    // Add several values to the distribution
+    void fill( const Doubles &values );
+
+    // Return whether the values are stored exactly
+    inline bool isExact() const;
+
+    // Merge the content of another distribution. If both have a histogram with
+    // different edges, the content of the other is redistributed into the bins
+    // of this one.
+    void merge( const CLsTSDistribution &other );
+
+    // Return the value of the test statistic below which a fraction < prob > of
+    // the values is found
+    double quantile( const double &prob ) const;
+
+    // Read the content of the distribution from a binary stream (see < write >)
+    void read( std::istream &is );
+
+    // Remove all the values. If < keepbins > is true and the histogram has been
+    // built, its edges are kept, so several distributions filled in parallel can
+    // be merged without redistributing their content.
+    void reset( const bool &keepbins = false );
+
+    // Return the number of values
+    inline size_t getEntries() const;
+
+    // Return the number of values stored before building the histogram
+    inline size_t getNexact() const;
+
+    // Return the edges of the histogram. Each bin contains the values in
+    // (edges[i - 1], edges[i]]. The first bin has no lower limit, and an extra
+    // bin contains the values greater than the last edge.
+    inline const Doubles& getEdges() const;
+
+    // Write the content of the distribution to a binary stream
+    void write( std::ostream &os ) const;
+
+  protected:
+
+    // Cumulative sum of the counts in the bins (updated on demand)
+    mutable Doubles fCumulative;
+
+    // Whether < fCumulative > and the order of < fExact > are up to date
+    mutable bool fUpdated;
+
+    // Maximum value in each bin
+    Doubles fBinMax;
+
+    // Minimum value in each bin
+    Doubles fBinMin;
+
+    // Counts in each bin
+    Doubles fCounts;
+
+    // Edges of the bins
+    Doubles fEdges;
+
+    // Values stored exactly while the histogram is not built
+    mutable Doubles fExact;
+
+    // Sorted copy of < fHighTail > (updated on demand)
+    mutable Doubles fHighSorted;
+
+    // Highest values, stored as a heap with the minimum on top
+    Doubles fHighTail;
+
+    // Sorted copy of < fLowTail > (updated on demand)
+    mutable Doubles fLowSorted;
+
+    // Lowest values, stored as a heap with the maximum on top
+    Doubles fLowTail;
+
+    // Number of bins
+    size_t fNbins;
+
+    // Number of values
+    size_t fNentries;
+
+    // Number of values stored before building the histogram
+    size_t fNexact;
+
+    // Number of values in each tail
+    size_t fNtail;
+
+  private:
+
+    // Build the histogram from the values stored exactly. If edges are already
+    // defined they are used.
+    void build();
+
+    // Add a value to the tails, moving the values that do not fit in them to the
+    // histogram
+    void fillHist( const double &t );
+
+    // Add < n > values to the given bin, with the given minimum and maximum
+    void fillBin( const size_t &ib, const double &n, const double &vmin, const double &vmax );
+
+    // Return the estimated number of values in the given bin lower or equal than
+    // < t >
+    double binCountBelow( const size_t &ib, const double &t ) const;
+
+    // Return the estimated number of values in the histogram lower or equal than
+    // the given value
+    double histCountBelow( const double &t ) const;
+
+    // Update the cumulative counts and sort the exact values and the tails if
+    // needed
+    void update() const;
+
+  };
+
+  //_______________________________________________________________________________
+  //
+  inline bool CLsTSDistribution::isExact() const {
+
+    return fEdges.empty();
+  }
+
+  //_______________________________________________________________________________
+  //
+  inline size_t CLsTSDistribution::getEntries() const {
+
+    return fNentries;
+  }
+
+  //_______________________________________________________________________________
+  //
+  inline size_t CLsTSDistribution::getNexact() const {
+
+    return fNexact;
+  }
+
+  //_______________________________________________________________________________
+  //
+  inline const Doubles& CLsTSDistribution::getEdges() const {
+
+    return fEdges;
+  }
+
+}
+
+#endif
@@ -0,0 +1,626 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//  Analysis package
+//
+// ---------------------------------------------------------------------------------
+//
+//  AUTHOR: Miguel Ramos Pernas
+//  e-mail: miguel.ramos.pernas@cern.ch
+//
+//  Last update: 18/10/2026
+//
+// ---------------------------------------------------------------------------------
+////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "BDTWeighter.hpp"
+#include "Definitions.hpp"
+#include "Exceptions.hpp"
+#include "Parallel.hpp"
+#include "Utils.hpp"
+
+#include "TDirectory.h"
+#include "TLeaf.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+
+//_______________________________________________________________________________
+
+namespace isis {
+
+  //_______________________________________________________________________________
+  //
+  const uint16_t BDTWeighter::OutOfRange;
+
+  //_______________________________________________________________________________
+  //
+  const size_t BDTWeighter::MaxHistSize;
+
+  //_______________________________________________________________________________
+  //
+  BDTWeighter::BDTWeighter( TTree *rtree, TTree *wtree, const std::string &opts ) :
+    TreeWeighter( rtree, wtree ),
+    fLearningRate( 0.2 ),
+    fMaxRelErr( 1. ),
+    fMaxDepth( 3 ),
+    fMinLeafEntries( 100 ),
+    fNorm( 1. ),
+    fNormVar( 0. ),
+    fNtrees( 40 ),
+    fRegularization( 5. ) {
+
+    std::cout << "***************************************" << std::endl;
+    std::cout << "*** Initializing BDT weighter class ***" << std::endl;
+    std::cout << "***************************************" << std::endl;
+    std::cout << " - Reference tree:   " << rtree->GetName() << " ( " <<
+      rtree->GetDirectory()->GetName() << " )" << std::endl;
+    std::cout << " - Reweighting tree: " << wtree->GetName() << " ( " <<
+      wtree->GetDirectory()->GetName() << " )" << std::endl;
+
+    this->configure( opts );
+  }
+
+  //_______________________________________________________________________________
+  //
+  BDTWeighter::~BDTWeighter() { }
+
+  //_______________________________________________________________________________
+  //
+  void BDTWeighter::addVariable( const std::string &name,
+				 const size_t      &nbins,
+				 const double      &min,
+				 const double      &max,
+				 const std::string &unit ) {
+
+    if ( nbins == 0 || nbins >= OutOfRange )
+      throw BaseException("Number of bins for variable \"" + name +
+			  "\" must be in the range [1, " +
+			  std::to_string(OutOfRange) + ")");
+
+    this->bookVariable( name, unit );
+
+    std::cout << " - Number of bins: " << nbins << std::endl;
+    std::cout << " - Minimum value:  " << min << std::endl;
+    std::cout << " - Maximum value:  " << max << std::endl;
+
+    Axis axis;
+    axis.nbins = nbins;
+    axis.min   = min;
+    axis.max   = max;
+    fAxes.push_back( axis );
+
+    // The trees trained so far are no longer valid
+    fNodeFeatures.clear();
+    fNodeThresholds.clear();
+    fLeafValues.clear();
+    fLeafVariances.clear();
+  }
+
+  //_______________________________________________________________________________
+  //
+  void BDTWeighter::calculateWeights( const double &maxrelerr ) {
+
+    std::cout << "***************************" << std::endl;
+    std::cout << "*** Calculating weights ***" << std::endl;
+    std::cout << "***************************" << std::endl;
+
+    if ( fAxes.empty() )
+      throw BaseException("No variables have been added to the weighter");
+
+    fMaxRelErr = maxrelerr;
+    fNodeFeatures.clear();
+    fNodeThresholds.clear();
+    fLeafValues.clear();
+    fLeafVariances.clear();
+
+    // Reads and quantises the two samples
+    BDTWeighter::BinTable reftable, wgttable;
+    std::cout << "Reading the reference sample" << std::endl;
+    this->readSample( fRefTree, reftable );
+    std::cout << "Reading the sample to be weighted" << std::endl;
+    this->readSample( fWgtTree, wgttable );
+
+    const size_t nr = reftable.front().size();
+    const size_t nw = wgttable.front().size();
+    if ( !nr || !nw )
+      throw BaseException("No entries found inside the ranges of the variables");
+
+    // The reference sample is normalized to the number of entries of the sample
+    // to be weighted
+    Doubles refwgts( nr, double( nw )/nr );
+    Doubles wgtwgts( nw, 1. );
+
+    std::cout << "Training < " << fNtrees << " > trees with depth < " <<
+      fMaxDepth << " >" << std::endl;
+    for ( size_t it = 0; it < fNtrees; ++it )
+      this->boost( reftable, refwgts, wgttable, wgtwgts );
+
+    // The normalization ensures the sum of weights is equal to the number of
+    // entries in the weighted sample
+    double sw = 0;
+    for ( auto it = wgtwgts.cbegin(); it != wgtwgts.cend(); ++it )
+      sw += *it;
+    fNorm    = nw/sw;
+    fNormVar = 1./nr + 1./nw;
+
+    // Evaluates the final weights to display the results
+    Doubles weights( nw ), errors( nw );
+    parallelFor( nw, fNthreads, [&] ( size_t, size_t first, size_t last ) {
+	this->predict( wgttable, first, last, &weights[ first ], &errors[ first ] );
+      } );
+
+    size_t nnull = 0;
+    double sumw = 0;
+    for ( auto it = weights.cbegin(); it != weights.cend(); ++it ) {
+      if ( *it > 0. )
+	sumw += *it;
+      else
+	++nnull;
+    }
+
+    std::cout << "Results:" << std::endl;
+    std::cout << " - Number of entries (reference):   " <<
+      nr << " ( " << fRefTree->GetEntries() << " )" << std::endl;
+    std::cout << " - Number of entries (weighted):    " <<
+      nw << " ( " << fWgtTree->GetEntries() << " )" << std::endl;
+    std::cout << " - Total sum of weights:            " << sumw << std::endl;
+    std::cout << " - Number of null-weighted entries: " <<
+      nnull << " ( " << nw << " )" << std::endl;
+
+    std::cout << "**************************" << std::endl;
+    std::cout << "*** Weights calculated ***" << std::endl;
+    std::cout << "**************************" << std::endl;
+  }
+
+  //_______________________________________________________________________________
+  //
+  void BDTWeighter::configure( const std::string &opts ) {
+
+    // Checks that the given string is correctly written
+    if ( opts.size() )
+      checkParseOpts( opts,
+		      {   "nTrees",
+			  "MaxDepth",
+			  "LearningRate",
+			  "MinLeafEntries",
+			  "Regularization",
+			  "nThreads"       } );
+
+    if ( opts.find( "nTrees" ) != std::string::npos )
+      parseOpt( opts, "nTrees", fNtrees );
+
+    // The trees trained so far are not valid if the depth changes
+    if ( opts.find( "MaxDepth" ) != std::string::npos ) {
+      parseOpt( opts, "MaxDepth", fMaxDepth );
+      if ( fMaxDepth == 0 || fMaxDepth > 16 )
+	throw BaseException("The depth of the trees must be in the range [1, 16]");
+      fNodeFeatures.clear();
+      fNodeThresholds.clear();
+      fLeafValues.clear();
+      fLeafVariances.clear();
+    }
+
+    if ( opts.find( "LearningRate" ) != std::string::npos )
+      parseOpt( opts, "LearningRate", fLearningRate );
+
+    if ( opts.find( "MinLeafEntries" ) != std::string::npos )
+      parseOpt( opts, "MinLeafEntries", fMinLeafEntries );
+
+    if ( opts.find( "Regularization" ) != std::string::npos )
+      parseOpt( opts, "Regularization", fRegularization );
+
+    if ( opts.find( "nThreads" ) != std::string::npos )
+      parseOpt( opts, "nThreads", fNthreads );
+  }
+
+  //_______________________________________________________________________________
+  //
+  void BDTWeighter::display() {
+
+    std::cout << "*** BDT weighter configuration ***" << std::endl;
+    std::cout << " - Number of trees:        " << this->getNtrees() <<
+      " ( " << fNtrees << " )" << std::endl;
+    std::cout << " - Depth of the trees:     " << fMaxDepth << std::endl;
+    std::cout << " - Learning rate:          " << fLearningRate << std::endl;
+    std::cout << " - Minimum leaf entries:   " << fMinLeafEntries << std::endl;
+    std::cout << " - Regularization:         " << fRegularization << std::endl;
+    std::cout << " - Number of threads:      " <<
+      getNthreads( fNthreads, defaultNthreads() ) << std::endl;
+    std::cout << " - Variables:" << std::endl;
+    for ( auto it = fAxes.cbegin(); it != fAxes.cend(); ++it )
+      std::cout << "    " << fVarNames[ it - fAxes.cbegin() ] << " [ " << it->min << ", " << it->max <<
+	" ) ( " << it->nbins << " bins )" << std::endl;
+  }
+
+  //_______________________________________________________________________________
+  //
+  bool BDTWeighter::isTrained() const { return this->getNtrees() > 0; }
+
+  //_______________________________________________________________________________
+  //
+  void BDTWeighter::predict( const BinTable &table,
+			     const size_t   &first,
+			     const size_t   &last,
+			     double         *weights,
+			     double         *errors ) const {
+
+    const size_t nvars     = fAxes.size();
+    const size_t ntrees    = this->getNtrees();
+    const size_t ninternal = ( size_t( 1 ) << fMaxDepth ) - 1;
+    const size_t nleaves   = ninternal + 1;
+
+    std::vector<const uint16_t*> columns( nvars );
+    for ( size_t iv = 0; iv < nvars; ++iv )
+      columns[ iv ] = table[ iv ].data();
+
+    // The events are processed in small blocks so the buffers stay in cache. The
+    // trees are complete, so every event crosses the same number of nodes and
+    // the inner loops have no branches.
+    const size_t block = 256;
+    size_t node[ block ];
+    double logw[ block ], var[ block ];
+
+    for ( size_t ib = first; ib < last; ib += block ) {
+
+      const size_t n = std::min( block, last - ib );
+
+      std::fill( logw, logw + n, 0. );
+      std::fill( var, var + n, 0. );
+
+      for ( size_t it = 0; it < ntrees; ++it ) {
+
+	const uint16_t *features   = &fNodeFeatures[ it*ninternal ];
+	const uint16_t *thresholds = &fNodeThresholds[ it*ninternal ];
+	const double   *values     = &fLeafValues[ it*nleaves ];
+	const double   *variances  = &fLeafVariances[ it*nleaves ];
+
+	std::fill( node, node + n, 0 );
+
+	for ( size_t d = 0; d < fMaxDepth; ++d )
+	  for ( size_t i = 0; i < n; ++i ) {
+	    const size_t k = node[ i ];
+	    node[ i ] = 2*k + 1 + ( columns[ features[ k ] ][ ib + i ] > thresholds[ k ] );
+	  }
+
+	for ( size_t i = 0; i < n; ++i ) {
+	  const size_t l = node[ i ] - ninternal;
+	  logw[ i ] += values[ l ];
+	  var[ i ]  += variances[ l ];
+	}
+      }
+
+      // Events outside the ranges of the axes or with a large relative error are
+      // assigned a null weight
+      for ( size_t i = 0; i < n; ++i ) {
+
+	double *w = weights + ( ib - first ) + i;
+	double *s = errors + ( ib - first ) + i;
+
+	bool inside = true;
+	for ( size_t iv = 0; iv < nvars; ++iv )
+	  inside &= ( columns[ iv ][ ib + i ] != OutOfRange );
+
+	const double relerr = std::sqrt( var[ i ] + fNormVar );
+
+	if ( inside && relerr <= fMaxRelErr ) {
+	  *w = fNorm*std::exp( logw[ i ] );
+	  *s = ( *w )*relerr;
+	}
+	else {
+	  *w = 0;
+	  *s = 0;
+	}
+      }
+    }
+  }
+
+  //_______________________________________________________________________________
+  //
+  void BDTWeighter::evaluateTree( TTree                     *tree,
+				  const std::vector<TLeaf*> &leaves,
+				  TLeaf                     *extra,
+				  const BlockFunction       &func ) const {
+
+    BDTWeighter::BinTable table;
+    Doubles weights( BlockSize ), errors( BlockSize ), extravals;
+
+    const Long64_t nentries = tree->GetEntries();
+    for ( Long64_t first = 0; first < nentries; first += BlockSize ) {
+
+      const Long64_t last = std::min( first + Long64_t( BlockSize ), nentries );
+      const size_t   n    = last - first;
+
+      this->readBlock( tree, leaves, first, last, table, extra, &extravals );
+
+      parallelFor( n, fNthreads, [&] ( size_t, size_t f, size_t l ) {
+	  this->predict( table, f, l, &weights[ f ], &errors[ f ] );
+	} );
+
+      func( first, n, weights, errors, extravals );
+    }
+  }
+
+  //_______________________________________________________________________________
+  //
+  void BDTWeighter::boost( const BinTable &reftable,
+			   const Doubles  &refwgts,
+			   const BinTable &wgttable,
+			   Doubles        &wgtwgts ) {
+
+    const size_t nvars     = fAxes.size();
+    const size_t nr        = refwgts.size();
+    const size_t nw        = wgtwgts.size();
+    const size_t ninternal = ( size_t( 1 ) << fMaxDepth ) - 1;
+    const size_t nleaves   = ninternal + 1;
+
+    // Offsets of each variable in the histograms of a node
+    Sizes offsets( nvars + 1, 0 );
+    for ( size_t iv = 0; iv < nvars; ++iv )
+      offsets[ iv + 1 ] = offsets[ iv ] + fAxes[ iv ].nbins;
+    const size_t nbins = offsets.back();
+
+    // Node (inside the current level) where each event is placed
+    Sizes refnodes( nr, 0 ), wgtnodes( nw, 0 );
+
+    // By default the nodes send all the events to the left
+    std::vector<uint16_t> features( ninternal, 0 ), thresholds( ninternal, OutOfRange );
+
+    // Histograms of each thread, reused for all the levels
+    const size_t nt = getNthreads( fNthreads, std::max( nr, nw ) );
+    std::vector<Doubles> hists( nt );
+
+    // Symmetric chi-square of a set of weighted entries
+    auto chi2 = [] ( const double &wr, const double &ww ) {
+      return wr + ww > 0 ? ( wr - ww )*( wr - ww )/( wr + ww ) : 0.;
+    };
+
+    for ( size_t level = 0; level < fMaxDepth; ++level ) {
+
+      const size_t nnodes = size_t( 1 ) << level;
+      const size_t offset = nnodes - 1;
+
+      // Only the nodes with enough entries of both samples can be split, so the
+      // histograms are built just for them
+      Doubles counts( 2*nnodes, 0. );
+      for ( size_t i = 0; i < nr; ++i )
+	counts[ 2*refnodes[ i ] ] += 1;
+      for ( size_t i = 0; i < nw; ++i )
+	counts[ 2*wgtnodes[ i ] + 1 ] += 1;
+
+      const double minentries = std::max<double>( 2*fMinLeafEntries, 1 );
+
+      Sizes active;
+      for ( size_t in = 0; in < nnodes; ++in )
+	if ( counts[ 2*in ] >= minentries && counts[ 2*in + 1 ] >= minentries )
+	  active.push_back( in );
+
+      // Position of each node in the histograms (< nnodes > if it is not split)
+      Sizes slots( nnodes, nnodes );
+
+      Doubles gains( nnodes*nvars, 0. );
+      Sizes   cuts( nnodes*nvars, OutOfRange );
+
+      // The active nodes are processed in groups, so the size of the histograms
+      // is bounded. The histograms store, for each bin, the sum of weights and
+      // the number of entries of each sample.
+      const size_t group = std::max( MaxHistSize/( 4*nbins*nt ), size_t( 1 ) );
+
+      for ( size_t ga = 0; ga < active.size(); ga += group ) {
+
+	const size_t gl = std::min( ga + group, active.size() );
+	const size_t hsize = 4*( gl - ga )*nbins;
+
+	for ( size_t ia = ga; ia < gl; ++ia )
+	  slots[ active[ ia ] ] = ia - ga;
+
+	// Each thread fills its own histograms with a different set of events
+	for ( size_t it = 0; it < nt; ++it )
+	  hists[ it ].assign( hsize, 0. );
+
+	auto fill = [&] ( const BinTable &table, const Doubles &wgts,
+			  const Sizes &nodes, const size_t &isample ) {
+
+	  parallelFor( nodes.size(), nt, [&] ( size_t it, size_t f, size_t l ) {
+
+	      double *hist = hists[ it ].data();
+
+	      for ( size_t i = f; i < l; ++i ) {
+
+		const size_t slot = slots[ nodes[ i ] ];
+		if ( slot == nnodes )
+		  continue;
+
+		double *h = hist + 4*( slot*nbins ) + isample;
+		for ( size_t iv = 0; iv < nvars; ++iv ) {
+		  double *b = h + 4*( offsets[ iv ] + table[ iv ][ i ] );
+		  b[ 0 ] += wgts[ i ];
+		  b[ 2 ] += 1;
+		}
+	      }
+	    } );
+	};
+	fill( reftable, refwgts, refnodes, 0 );
+	fill( wgttable, wgtwgts, wgtnodes, 1 );
+
+	// Merges the histograms of the different threads
+	Doubles &hist = hists[ 0 ];
+	parallelFor( hsize, nt, [&] ( size_t, size_t f, size_t l ) {
+	    for ( size_t it = 1; it < nt; ++it )
+	      for ( size_t ib = f; ib < l; ++ib )
+		hist[ ib ] += hists[ it ][ ib ];
+	  } );
+
+	// Looks for the best split of each node and variable
+	parallelFor( nvars, nt, [&] ( size_t, size_t vf, size_t vl ) {
+
+	    for ( size_t iv = vf; iv < vl; ++iv )
+	      for ( size_t ia = ga; ia < gl; ++ia ) {
+
+		const size_t  in = active[ ia ];
+		const double *h  = &hist[ 4*( ( ia - ga )*nbins + offsets[ iv ] ) ];
+		const size_t  nb = fAxes[ iv ].nbins;
+
+		double tot[ 4 ] = { 0, 0, 0, 0 };
+		for ( size_t ib = 0; ib < nb; ++ib )
+		  for ( size_t k = 0; k < 4; ++k )
+		    tot[ k ] += h[ 4*ib + k ];
+
+		const double parent = chi2( tot[ 0 ], tot[ 1 ] );
+
+		double left[ 4 ] = { 0, 0, 0, 0 };
+		for ( size_t ib = 0; ib + 1 < nb; ++ib ) {
+
+		  for ( size_t k = 0; k < 4; ++k )
+		    left[ k ] += h[ 4*ib + k ];
+
+		  if ( left[ 2 ] < fMinLeafEntries || left[ 3 ] < fMinLeafEntries ||
+		       tot[ 2 ] - left[ 2 ] < fMinLeafEntries ||
+		       tot[ 3 ] - left[ 3 ] < fMinLeafEntries )
+		    continue;
+
+		  const double gain =
+		    chi2( left[ 0 ], left[ 1 ] ) +
+		    chi2( tot[ 0 ] - left[ 0 ], tot[ 1 ] - left[ 1 ] ) - parent;
+
+		  if ( gain > gains[ in*nvars + iv ] ) {
+		    gains[ in*nvars + iv ] = gain;
+		    cuts[ in*nvars + iv ]  = ib;
+		  }
+		}
+	      }
+	  } );
+
+	for ( size_t ia = ga; ia < gl; ++ia )
+	  slots[ active[ ia ] ] = nnodes;
+      }
+
+      for ( size_t in = 0; in < nnodes; ++in ) {
+
+	auto first = gains.cbegin() + in*nvars;
+	auto best  = std::max_element( first, first + nvars );
+
+	if ( *best > 0 ) {
+	  const size_t iv = best - first;
+	  features[ offset + in ]   = iv;
+	  thresholds[ offset + in ] = cuts[ in*nvars + iv ];
+	}
+      }
+
+      // Moves the events to the next level
+      auto move = [&] ( const BinTable &table, Sizes &nodes ) {
+
+	parallelFor( nodes.size(), fNthreads, [&] ( size_t, size_t f, size_t l ) {
+	    for ( size_t i = f; i < l; ++i ) {
+	      const size_t k = offset + nodes[ i ];
+	      nodes[ i ] = 2*nodes[ i ] + ( table[ features[ k ] ][ i ] > thresholds[ k ] );
+	    }
+	  } );
+      };
+      move( reftable, refnodes );
+      move( wgttable, wgtnodes );
+    }
+
+    // Calculates the values in the leaves
+    Doubles sums( 4*nleaves, 0. );
+    for ( size_t i = 0; i < nr; ++i ) {
+      sums[ 4*refnodes[ i ] ]     += refwgts[ i ];
+      sums[ 4*refnodes[ i ] + 2 ] += 1;
+    }
+    for ( size_t i = 0; i < nw; ++i ) {
+      sums[ 4*wgtnodes[ i ] + 1 ] += wgtwgts[ i ];
+      sums[ 4*wgtnodes[ i ] + 3 ] += 1;
+    }
+
+    Doubles values( nleaves, 0. ), variances( nleaves, 0. );
+    for ( size_t il = 0; il < nleaves; ++il ) {
+
+      const double *s = &sums[ 4*il ];
+
+      if ( s[ 2 ] + s[ 3 ] > 0 ) {
+	values[ il ] = fLearningRate*
+	  std::log( ( s[ 0 ] + fRegularization )/( s[ 1 ] + fRegularization ) );
+	variances[ il ] = fLearningRate*fLearningRate*
+	  ( 1./std::max( s[ 2 ], 1. ) + 1./std::max( s[ 3 ], 1. ) );
+      }
+    }
+
+    // Updates the weights of the sample to be weighted
+    parallelFor( nw, fNthreads, [&] ( size_t, size_t f, size_t l ) {
+	for ( size_t i = f; i < l; ++i )
+	  wgtwgts[ i ] *= std::exp( values[ wgtnodes[ i ] ] );
+      } );
+
+    fNodeFeatures.insert( fNodeFeatures.end(), features.begin(), features.end() );
+    fNodeThresholds.insert( fNodeThresholds.end(), thresholds.begin(), thresholds.end() );
+    fLeafValues.insert( fLeafValues.end(), values.begin(), values.end() );
+    fLeafVariances.insert( fLeafVariances.end(), variances.begin(), variances.end() );
+  }
+
+  //_______________________________________________________________________________
+  //
+  void BDTWeighter::readBlock( TTree                     *tree,
+			       const std::vector<TLeaf*> &leaves,
+			       const Long64_t            &first,
+			       const Long64_t            &last,
+			       BinTable                  &table,
+			       TLeaf                     *extra,
+			       Doubles                   *extravals ) const {
+
+    const size_t nvars = fAxes.size();
+    const size_t n     = last - first;
+
+    table.resize( nvars );
+    for ( auto it = table.begin(); it != table.end(); ++it )
+      it->resize( n );
+
+    if ( extra )
+      extravals->resize( n );
+
+    for ( Long64_t ievt = first; ievt < last; ++ievt ) {
+
+      tree->GetEntry( ievt );
+
+      const size_t i = ievt - first;
+      for ( size_t iv = 0; iv < nvars; ++iv )
+	table[ iv ][ i ] = fAxes[ iv ].quantise( leaves[ iv ]->GetValue() );
+
+      if ( extra )
+	( *extravals )[ i ] = extra->GetValue();
+    }
+  }
+
+  //_______________________________________________________________________________
+  //
+  void BDTWeighter::readSample( TTree *tree, BinTable &table ) const {
+
+    const size_t nvars = fAxes.size();
+
+    std::vector<TLeaf*> leaves = this->setupTree( tree );
+
+    table.assign( nvars, BinColumn() );
+    for ( auto it = table.begin(); it != table.end(); ++it )
+      it->reserve( tree->GetEntries() );
+
+    std::vector<uint16_t> bins( nvars );
+    for ( Long64_t ievt = 0; ievt < tree->GetEntries(); ++ievt ) {
+
+      tree->GetEntry( ievt );
+
+      bool inside = true;
+      for ( size_t iv = 0; iv < nvars; ++iv ) {
+	bins[ iv ] = fAxes[ iv ].quantise( leaves[ iv ]->GetValue() );
+	inside &= ( bins[ iv ] != OutOfRange );
+      }
+
+      if ( inside )
+	for ( size_t iv = 0; iv < nvars; ++iv )
+	  table[ iv ].push_back( bins[ iv ] );
+    }
+
+    tree->SetBranchStatus( "*", true );
+  }
+
+}
@@ -0,0 +1,221 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//  Analysis package
+//
+// ---------------------------------------------------------------------------------
+//
+//  AUTHOR: Miguel Ramos Pernas
+//  e-mail: miguel.ramos.pernas@cern.ch
+//
+//  Last update: 18/10/2026
+//
+// ---------------------------------------------------------------------------------
+//
+//  Description:
+//
+//  This class performs the weighting of the events of a tree to reproduce the
+//  shape of the events of another one, like < VarWeighter >, but using an
+//  ensemble of shallow regression trees instead of a multivariable bin map. The
+//  trees are fitted iteratively (gradient boosting) to the logarithm of the
+//  ratio between the reference and the weighted densities. The values of the
+//  variables are quantised before the training, so the splits are found from
+//  histograms, and the trees are complete so they can be evaluated without
+//  branches for blocks of events.
+//
+// ---------------------------------------------------------------------------------
+////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef BDT_WEIGHTER
+#define BDT_WEIGHTER
+
+#include "Definitions.hpp"
+#include "TreeWeighter.hpp"
+
+#include "TLeaf.h"
+#include "TList.h"
+#include "TTree.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+//_______________________________________________________________________________
+
+namespace isis {
+
+  class BDTWeighter : public TreeWeighter {
+
+  public:
+
+    // Quantised values of the events, stored by columns (one per variable)
+    typedef std::vector<uint16_t> BinColumn;
+    typedef std::vector<BinColumn> BinTable;
+
+    // Value assigned to the quantised variables outside the axis range
+    static const uint16_t OutOfRange = 0xFFFF;
+
+    // Maximum number of values in the histograms used to find the splits of the
+    // nodes of a level. The nodes are processed in groups to satisfy it.
+    static const size_t MaxHistSize = size_t( 1 ) << 24;
+
+    // Main constructor. The reference tree and the tree to be weighed have to be
+    // passed to the constructor, together with the configuration options. See
+    // < configure > for more information.
+    BDTWeighter( TTree *rtree, TTree *wtree, const std::string &opts = "" );
+
+    // Destructor
+    virtual ~BDTWeighter();
+
+    // Adds a new variable to this class. There have to be provided the name, number
+    // of bins used to quantise it, the minimum and maximum values and the unit for
+    // it. Events outside the range are not used in the training, and obtain null
+    // weights.
+    void addVariable( const std::string &name,
+		      const size_t      &nbins,
+		      const double      &min,
+		      const double      &max,
+		      const std::string &units = "" );
+
+    // Trains the trees using the two attached trees. Events whose weight has a
+    // relative error greater than < maxrelerr > are assigned a null weight.
+    void calculateWeights( const double &maxrelerr = 1. );
+
+    // Configures the class given a set of options. The format follows that of
+    // < parseOpt > in Utils.hpp. The available options are:
+    //  - nTrees         => Number of trees to train.
+    //  - MaxDepth       => Depth of the trees (the number of leaves is 2^MaxDepth).
+    //  - LearningRate   => Factor applied to the values in the leaves.
+    //  - MinLeafEntries => Minimum number of entries of each sample in a leaf.
+    //  - Regularization => Number of entries added to both samples when computing
+    //                      the ratio in a leaf.
+    //  - nThreads       => Number of threads (0 uses all the available).
+    void configure( const std::string &opts );
+
+    // Displays the configuration and the status of the class
+    void display();
+
+    // Evaluates the weights and their errors for the events in the range
+    // [first, last) of the given table of quantised values. The output vectors
+    // must have at least < last - first > elements.
+    void predict( const BinTable &table,
+		  const size_t   &first,
+		  const size_t   &last,
+		  double         *weights,
+		  double         *errors ) const;
+
+    // Returns the number of trees trained
+    inline size_t getNtrees() const;
+
+    // Returns whether the trees have been trained
+    virtual bool isTrained() const;
+
+  protected:
+
+    // Definition of an axis used to quantise a variable
+    struct Axis {
+
+      // Number of bins
+      size_t nbins;
+
+      // Minimum value
+      double min;
+
+      // Maximum value
+      double max;
+
+      // Returns the bin associated to the given value
+      inline uint16_t quantise( const double &value ) const {
+
+	if ( value < min || value >= max )
+	  return OutOfRange;
+
+	size_t bin = (value - min)/(max - min)*nbins;
+
+	return bin < nbins ? bin : nbins - 1;
+      }
+    };
+
+    // Axes associated to each variable
+    std::vector<Axis> fAxes;
+
+    // Feature used by each internal node of the trees
+    std::vector<uint16_t> fNodeFeatures;
+
+    // Threshold of each internal node. Events go to the right child if the value
+    // of the feature is greater than this.
+    std::vector<uint16_t> fNodeThresholds;
+
+    // Value of the logarithm of the weight for each leaf
+    Doubles fLeafValues;
+
+    // Variance of the logarithm of the weight for each leaf
+    Doubles fLeafVariances;
+
+    // Learning rate
+    double fLearningRate;
+
+    // Maximum relative error allowed for a weight
+    double fMaxRelErr;
+
+    // Depth of the trees
+    size_t fMaxDepth;
+
+    // Minimum number of entries per leaf
+    size_t fMinLeafEntries;
+
+    // Normalization of the weights
+    double fNorm;
+
+    // Relative variance of the normalization
+    double fNormVar;
+
+    // Number of trees to train
+    size_t fNtrees;
+
+    // Regularization of the ratios in the leaves
+    double fRegularization;
+
+  private:
+
+    // Evaluates the weights of all the events in a tree by blocks (see
+    // < TreeWeighter::evaluateTree >)
+    virtual void evaluateTree( TTree                     *tree,
+			       const std::vector<TLeaf*> &leaves,
+			       TLeaf                     *extra,
+			       const BlockFunction       &func ) const;
+
+    // Adds a new tree to the ensemble given the quantised values and weights of
+    // each sample. The weights of the sample to be weighted are updated.
+    void boost( const BinTable &reftable,
+		const Doubles  &refwgts,
+		const BinTable &wgttable,
+		Doubles        &wgtwgts );
+
+    // Reads the events in the range [first, last) of a tree, storing the
+    // quantised values of the variables in the table. The values of the leaf
+    // < extra > are also stored if it is provided.
+    void readBlock( TTree                     *tree,
+		    const std::vector<TLeaf*> &leaves,
+		    const Long64_t            &first,
+		    const Long64_t            &last,
+		    BinTable                  &table,
+		    TLeaf                     *extra = 0,
+		    Doubles                   *extravals = 0 ) const;
+
+    // Reads all the events of a tree inside the axes ranges
+    void readSample( TTree *tree, BinTable &table ) const;
+
+  };
+
+  //_______________________________________________________________________________
+  //
+  inline size_t BDTWeighter::getNtrees() const {
+
+    return fLeafValues.size() >> fMaxDepth;
+  }
+
+}
+
+#endif
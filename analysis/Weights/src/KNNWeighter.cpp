@@ -0,0 +1,375 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//  Analysis package
+//
+// ---------------------------------------------------------------------------------
+//
+//  AUTHOR: Miguel Ramos Pernas
+//  e-mail: miguel.ramos.pernas@cern.ch
+//
+//  Last update: 18/10/2026
+//
+// ---------------------------------------------------------------------------------
+////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "Definitions.hpp"
+#include "Exceptions.hpp"
+#include "KNNWeighter.hpp"
+#include "Parallel.hpp"
+#include "Utils.hpp"
+
+#include "TDirectory.h"
+#include "TLeaf.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+
+//_______________________________________________________________________________
+
+namespace isis {
+
+  //_______________________________________________________________________________
+  //
+  KNNWeighter::KNNWeighter( TTree *rtree, TTree *wtree, const std::string &opts ) :
+    TreeWeighter( rtree, wtree ),
+    fIndex( 0 ),
+    fLeafSize( 16 ),
+    fMaxRelErr( 1. ),
+    fNneighbours( 20 ),
+    fNref( 0 ),
+    fNwgt( 0 ) {
+
+    std::cout << "***************************************" << std::endl;
+    std::cout << "*** Initializing kNN weighter class ***" << std::endl;
+    std::cout << "***************************************" << std::endl;
+    std::cout << " - Reference tree:   " << rtree->GetName() << " ( " <<
+      rtree->GetDirectory()->GetName() << " )" << std::endl;
+    std::cout << " - Reweighting tree: " << wtree->GetName() << " ( " <<
+      wtree->GetDirectory()->GetName() << " )" << std::endl;
+
+    this->configure( opts );
+  }
+
+  //_______________________________________________________________________________
+  //
+  KNNWeighter::~KNNWeighter() { delete fIndex; }
+
+  //_______________________________________________________________________________
+  //
+  void KNNWeighter::addVariable( const std::string &name,
+				 const double      &min,
+				 const double      &max,
+				 const std::string &unit ) {
+
+    this->bookVariable( name, unit );
+
+    std::cout << " - Minimum value:  " << min << std::endl;
+    std::cout << " - Maximum value:  " << max << std::endl;
+
+    Axis axis;
+    axis.min   = min;
+    axis.max   = max;
+    axis.mean  = 0;
+    axis.scale = 1;
+    fAxes.push_back( axis );
+
+    // The index built so far is no longer valid
+    delete fIndex;
+    fIndex = 0;
+  }
+
+  //_______________________________________________________________________________
+  //
+  void KNNWeighter::calculateWeights( const double &maxrelerr ) {
+
+    std::cout << "***************************" << std::endl;
+    std::cout << "*** Calculating weights ***" << std::endl;
+    std::cout << "***************************" << std::endl;
+
+    if ( fAxes.empty() )
+      throw BaseException("No variables have been added to the weighter");
+
+    fMaxRelErr = maxrelerr;
+
+    delete fIndex;
+    fIndex = 0;
+
+    const size_t nvars = fAxes.size();
+
+    // Both samples are stored in the same array, the reference first
+    Doubles values;
+    std::cout << "Reading the reference sample" << std::endl;
+    const size_t nr = this->readSample( fRefTree, values );
+    std::cout << "Reading the sample to be weighted" << std::endl;
+    const size_t nw = this->readSample( fWgtTree, values );
+
+    if ( !nr || !nw )
+      throw BaseException("No entries found inside the ranges of the variables");
+
+    if ( fNneighbours < 2 )
+      throw BaseException("At least two neighbours are needed to calculate the weights");
+
+    // The variables are normalised using the reference sample
+    for ( size_t iv = 0; iv < nvars; ++iv ) {
+
+      double sum = 0, sum2 = 0;
+      for ( size_t i = 0; i < nr; ++i ) {
+	const double &v = values[ i*nvars + iv ];
+	sum  += v;
+	sum2 += v*v;
+      }
+
+      Axis &axis = fAxes[ iv ];
+      axis.mean  = sum/nr;
+      axis.scale = std::sqrt( std::max( sum2/nr - axis.mean*axis.mean, 0. ) );
+      if ( axis.scale == 0 )
+	axis.scale = 1;
+    }
+
+    Doubles wgtvalues( values.begin() + nr*nvars, values.end() );
+
+    for ( size_t i = 0; i < nr + nw; ++i )
+      for ( size_t iv = 0; iv < nvars; ++iv ) {
+	double &v = values[ i*nvars + iv ];
+	v = ( v - fAxes[ iv ].mean )/fAxes[ iv ].scale;
+      }
+
+    std::cout << "Building the index of neighbours" << std::endl;
+    fIndex = new KDTree( values, nvars, fLeafSize );
+    fNref  = nr;
+    fNwgt  = nw;
+
+    // Evaluates the weights of the sample to be weighted to display the results
+    Doubles weights( nw ), errors( nw );
+    parallelFor( nw, fNthreads, [&] ( size_t, size_t first, size_t last ) {
+	this->predict( &wgtvalues[ first*nvars ], last - first,
+		       &weights[ first ], &errors[ first ], aWeighted );
+      } );
+
+    size_t nnull = 0;
+    double sumw = 0;
+    for ( auto it = weights.cbegin(); it != weights.cend(); ++it ) {
+      if ( *it > 0. )
+	sumw += *it;
+      else
+	++nnull;
+    }
+
+    std::cout << "Results:" << std::endl;
+    std::cout << " - Number of entries (reference):   " <<
+      nr << " ( " << fRefTree->GetEntries() << " )" << std::endl;
+    std::cout << " - Number of entries (weighted):    " <<
+      nw << " ( " << fWgtTree->GetEntries() << " )" << std::endl;
+    std::cout << " - Total sum of weights:            " << sumw << std::endl;
+    std::cout << " - Number of null-weighted entries: " <<
+      nnull << " ( " << nw << " )" << std::endl;
+
+    std::cout << "**************************" << std::endl;
+    std::cout << "*** Weights calculated ***" << std::endl;
+    std::cout << "**************************" << std::endl;
+  }
+
+  //_______________________________________________________________________________
+  //
+  void KNNWeighter::configure( const std::string &opts ) {
+
+    // Checks that the given string is correctly written
+    if ( opts.size() )
+      checkParseOpts( opts,
+		      {   "nNeighbours",
+			  "LeafSize",
+			  "nThreads"    } );
+
+    if ( opts.find( "nNeighbours" ) != std::string::npos )
+      parseOpt( opts, "nNeighbours", fNneighbours );
+
+    // The index must be built again if the size of the leaves changes
+    if ( opts.find( "LeafSize" ) != std::string::npos ) {
+      parseOpt( opts, "LeafSize", fLeafSize );
+      delete fIndex;
+      fIndex = 0;
+    }
+
+    if ( opts.find( "nThreads" ) != std::string::npos )
+      parseOpt( opts, "nThreads", fNthreads );
+  }
+
+  //_______________________________________________________________________________
+  //
+  void KNNWeighter::display() {
+
+    std::cout << "*** kNN weighter configuration ***" << std::endl;
+    std::cout << " - Number of neighbours:   " << fNneighbours << std::endl;
+    std::cout << " - Size of the leaves:     " << fLeafSize << std::endl;
+    std::cout << " - Number of threads:      " <<
+      getNthreads( fNthreads, defaultNthreads() ) << std::endl;
+    std::cout << " - Points in the index:    " << fNref + fNwgt <<
+      " ( " << fNref << " reference, " << fNwgt << " weighted )" << std::endl;
+    std::cout << " - Variables:" << std::endl;
+    for ( auto it = fAxes.cbegin(); it != fAxes.cend(); ++it )
+      std::cout << "    " << fVarNames[ it - fAxes.cbegin() ] << " [ " << it->min << ", " << it->max <<
+	" )" << std::endl;
+  }
+
+  //_______________________________________________________________________________
+  //
+  bool KNNWeighter::isTrained() const { return fIndex != 0; }
+
+  //_______________________________________________________________________________
+  //
+  void KNNWeighter::predict( const double *values,
+			     const size_t &n,
+			     double       *weights,
+			     double       *errors,
+			     const Sample &sample ) const {
+
+    if ( !fIndex )
+      throw BaseException("The weights have not been calculated yet");
+
+    const size_t nvars = fAxes.size();
+
+    // Ratio between the sizes of the samples and its relative variance
+    const double ratio   = double( fNwgt )/fNref;
+    const double normvar = 1./fNref + 1./fNwgt;
+
+    Doubles point( nvars ), distances;
+    Sizes   indices;
+
+    for ( size_t i = 0; i < n; ++i ) {
+
+      const double *v = values + i*nvars;
+
+      weights[ i ] = 0;
+      errors[ i ]  = 0;
+
+      bool inside = true;
+      for ( size_t iv = 0; iv < nvars; ++iv ) {
+	const Axis &axis = fAxes[ iv ];
+	inside = inside && v[ iv ] >= axis.min && v[ iv ] < axis.max;
+	point[ iv ] = ( v[ iv ] - axis.mean )/axis.scale;
+      }
+
+      if ( !inside )
+	continue;
+
+      // Events in the index find themselves at null distance, so an additional
+      // neighbour is requested and the match removed (leave-one-out)
+      if ( sample != aNone ) {
+
+	fIndex->nearest( point.data(), fNneighbours + 1, indices, distances );
+
+	size_t j = 0;
+	while ( j < indices.size() && distances[ j ] == 0 &&
+		( indices[ j ] < fNref ) != ( sample == aReference ) )
+	  ++j;
+
+	if ( j == indices.size() || distances[ j ] != 0 )
+	  j = indices.size() - 1;
+
+	indices.erase( indices.begin() + j );
+      }
+      else
+	fIndex->nearest( point.data(), fNneighbours, indices, distances );
+
+      size_t nr = 0;
+      for ( auto it = indices.cbegin(); it != indices.cend(); ++it )
+	nr += ( *it < fNref );
+      const size_t nw = indices.size() - nr;
+
+      // The weight is not defined if any of the samples is missing
+      if ( !nr || !nw )
+	continue;
+
+      const double w   = ratio*nr/nw;
+      const double rel = std::sqrt( 1./nr + 1./nw + normvar );
+
+      if ( rel > fMaxRelErr )
+	continue;
+
+      weights[ i ] = w;
+      errors[ i ]  = w*rel;
+    }
+  }
+
+  //_______________________________________________________________________________
+  //
+  void KNNWeighter::evaluateTree( TTree                     *tree,
+				  const std::vector<TLeaf*> &leaves,
+				  TLeaf                     *extra,
+				  const BlockFunction       &func ) const {
+
+    const size_t nvars = fAxes.size();
+
+    // The events of the trees used to build the index are excluded from their
+    // own neighbours
+    const Sample sample =
+      tree == fRefTree ? aReference : ( tree == fWgtTree ? aWeighted : aNone );
+
+    Doubles values( BlockSize*nvars ), weights( BlockSize ), errors( BlockSize ), extravals;
+    if ( extra )
+      extravals.resize( BlockSize );
+
+    const Long64_t nentries = tree->GetEntries();
+    for ( Long64_t first = 0; first < nentries; first += BlockSize ) {
+
+      const Long64_t last = std::min( first + Long64_t( BlockSize ), nentries );
+      const size_t   n    = last - first;
+
+      for ( Long64_t ievt = first; ievt < last; ++ievt ) {
+
+	tree->GetEntry( ievt );
+
+	const size_t i = ievt - first;
+	for ( size_t iv = 0; iv < nvars; ++iv )
+	  values[ i*nvars + iv ] = leaves[ iv ]->GetValue();
+
+	if ( extra )
+	  extravals[ i ] = extra->GetValue();
+      }
+
+      parallelFor( n, fNthreads, [&] ( size_t, size_t f, size_t l ) {
+	  this->predict( &values[ f*nvars ], l - f, &weights[ f ], &errors[ f ], sample );
+	} );
+
+      func( first, n, weights, errors, extravals );
+    }
+  }
+
+  //_______________________________________________________________________________
+  //
+  size_t KNNWeighter::readSample( TTree *tree, Doubles &values ) const {
+
+    const size_t nvars = fAxes.size();
+
+    std::vector<TLeaf*> leaves = this->setupTree( tree );
+
+    values.reserve( values.size() + tree->GetEntries()*nvars );
+
+    Doubles point( nvars );
+
+    size_t n = 0;
+    for ( Long64_t ievt = 0; ievt < tree->GetEntries(); ++ievt ) {
+
+      tree->GetEntry( ievt );
+
+      bool inside = true;
+      for ( size_t iv = 0; iv < nvars; ++iv ) {
+	point[ iv ] = leaves[ iv ]->GetValue();
+	inside = inside && point[ iv ] >= fAxes[ iv ].min && point[ iv ] < fAxes[ iv ].max;
+      }
+
+      if ( inside ) {
+	values.insert( values.end(), point.begin(), point.end() );
+	++n;
+      }
+    }
+
+    tree->SetBranchStatus( "*", true );
+
+    return n;
+  }
+
+}
@@ -0,0 +1,157 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//  Analysis package
+//
+// ---------------------------------------------------------------------------------
+//
+//  AUTHOR: Miguel Ramos Pernas
+//  e-mail: miguel.ramos.pernas@cern.ch
+//
+//  Last update: 18/10/2026
+//
+// ---------------------------------------------------------------------------------
+//
+//  Description:
+//
+//  This class performs the weighting of the events of a tree to reproduce the
+//  shape of the events of another one, like < VarWeighter >, but without using
+//  bins. The weight of an event is the ratio between the number of reference and
+//  weighted events among its k nearest neighbours, found in the joint sample. The
+//  variables are normalised using the mean and standard deviation of the
+//  reference sample, and the neighbours are searched using a < KDTree >. When
+//  evaluating the events used to build the index, the event itself is not
+//  counted among its neighbours.
+//
+// ---------------------------------------------------------------------------------
+////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef KNN_WEIGHTER
+#define KNN_WEIGHTER
+
+#include "Definitions.hpp"
+#include "KDTree.hpp"
+#include "TreeWeighter.hpp"
+
+#include "TLeaf.h"
+#include "TList.h"
+#include "TTree.h"
+
+#include <string>
+#include <vector>
+
+
+//_______________________________________________________________________________
+
+namespace isis {
+
+  class KNNWeighter : public TreeWeighter {
+
+  public:
+
+    // Sample the evaluated events belong to
+    enum Sample { aNone, aReference, aWeighted };
+
+    // Main constructor. The reference tree and the tree to be weighed have to be
+    // passed to the constructor, together with the configuration options. See
+    // < configure > for more information.
+    KNNWeighter( TTree *rtree, TTree *wtree, const std::string &opts = "" );
+
+    // Destructor
+    virtual ~KNNWeighter();
+
+    // Adds a new variable to this class. There have to be provided the name, the
+    // minimum and maximum values and the unit for it. Events outside the range
+    // are not used to calculate the weights, and obtain null weights.
+    void addVariable( const std::string &name,
+		      const double      &min,
+		      const double      &max,
+		      const std::string &units = "" );
+
+    // Builds the index of neighbours using the two attached trees. Events whose
+    // weight has a relative error greater than < maxrelerr > are assigned a null
+    // weight.
+    void calculateWeights( const double &maxrelerr = 1. );
+
+    // Configures the class given a set of options. The format follows that of
+    // < parseOpt > in Utils.hpp. The available options are:
+    //  - nNeighbours => Number of neighbours used to calculate the weights.
+    //  - LeafSize    => Maximum number of points in the leaves of the KD-tree.
+    //  - nThreads    => Number of threads (0 uses all the available).
+    void configure( const std::string &opts );
+
+    // Displays the configuration and the status of the class
+    void display();
+
+    // Returns whether the index of neighbours has been built
+    virtual bool isTrained() const;
+
+    // Evaluates the weights and their errors for a set of events. The values of
+    // the variables are given in a flat array, following the order in which they
+    // were added. The output arrays must have at least < n > elements. If the
+    // events belong to one of the samples used to build the index, it must be
+    // specified, so each event is removed from its own neighbours.
+    void predict( const double *values,
+		  const size_t &n,
+		  double       *weights,
+		  double       *errors,
+		  const Sample &sample = aNone ) const;
+
+  protected:
+
+    // Definition of the range of a variable
+    struct Axis {
+
+      // Minimum value
+      double min;
+
+      // Maximum value
+      double max;
+
+      // Mean in the reference sample
+      double mean;
+
+      // Standard deviation in the reference sample
+      double scale;
+    };
+
+    // Axes associated to each variable
+    std::vector<Axis> fAxes;
+
+    // Index of neighbours. The first < fNref > points belong to the reference
+    // sample.
+    KDTree *fIndex;
+
+    // Maximum number of points in the leaves of the KD-tree
+    size_t fLeafSize;
+
+    // Maximum relative error allowed for a weight
+    double fMaxRelErr;
+
+    // Number of neighbours
+    size_t fNneighbours;
+
+    // Number of reference events in the index
+    size_t fNref;
+
+    // Number of events to be weighted in the index
+    size_t fNwgt;
+
+  private:
+
+    // Evaluates the weights of all the events in a tree by blocks (see
+    // < TreeWeighter::evaluateTree >)
+    virtual void evaluateTree( TTree                     *tree,
+			       const std::vector<TLeaf*> &leaves,
+			       TLeaf                     *extra,
+			       const BlockFunction       &func ) const;
+
+    // Reads all the events of a tree inside the axes ranges, appending their
+    // values to the given vector
+    size_t readSample( TTree *tree, Doubles &values ) const;
+
+  };
+
+}
+
+#endif
@@ -0,0 +1,224 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//  Analysis package
+//
+// ---------------------------------------------------------------------------------
+//
+//  AUTHOR: Miguel Ramos Pernas
+//  e-mail: miguel.ramos.pernas@cern.ch
+//
+//  Last update: 18/10/2026
+//
+// ---------------------------------------------------------------------------------
+////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "Definitions.hpp"
+#include "Exceptions.hpp"
+#include "TreeWeighter.hpp"
+
+#include "TBranch.h"
+#include "TDirectory.h"
+#include "TH1D.h"
+#include "TLeaf.h"
+#include "TList.h"
+
+#include <iostream>
+
+
+//_______________________________________________________________________________
+
+namespace isis {
+
+  //_______________________________________________________________________________
+  //
+  TreeWeighter::TreeWeighter( TTree *rtree, TTree *wtree ) :
+    fNthreads( 0 ),
+    fRefTree( rtree ),
+    fWgtTree( wtree ) { }
+
+  //_______________________________________________________________________________
+  //
+  TreeWeighter::~TreeWeighter() { }
+
+  //_______________________________________________________________________________
+  //
+  void TreeWeighter::applyWeights( TTree             *tree,
+				   const std::string &wvname,
+				   const std::string &svname,
+				   const char        &type ) {
+
+    if ( !this->isTrained() )
+      throw BaseException("The weights have not been calculated yet");
+
+    std::cout << "*** Initializing weighting process ***" << std::endl;
+    std::cout << "Working with tree: " << tree->GetName() <<
+      " ( " << tree->GetDirectory()->GetName() << " )" << std::endl;
+
+    std::vector<TLeaf*> leaves = this->setupTree( tree );
+
+    // Defines the variable to be added and its branch
+    double wvalue = 0, svalue = 0;
+    float  wfvalue = 0, sfvalue = 0;
+    void *waddress, *saddress;
+    if ( type == 'D' ) {
+      waddress = &wvalue;
+      saddress = &svalue;
+    }
+    else if ( type == 'F' ) {
+      waddress = &wfvalue;
+      saddress = &sfvalue;
+    }
+    else
+      throw BaseException("Wrong variable type for the branch of weights \"" +
+			  std::string(1, type) + "\" ( F/D )");
+
+    // Creates the new branches
+    std::cout << "Created output branches:" << std::endl;
+    TBranch *wbranch = tree->Branch( wvname.c_str(), waddress, ( wvname + '/' + type ).c_str() );
+    std::cout << " - Weights < " << wbranch->GetName() << " >" << std::endl;
+    TBranch *sbranch = tree->Branch( svname.c_str(), saddress, ( svname + '/' + type ).c_str() );
+    std::cout << " - Errors  < " << sbranch->GetName() << " >" << std::endl;
+
+    // Fills the output branches. The new branches do not depend on the entry
+    // loaded, so they can be filled once the whole block is evaluated.
+    std::cout << "Filling the output branch" << std::endl;
+    this->evaluateTree( tree, leaves, 0,
+			[&] ( const Long64_t &first,
+			      const size_t   &n,
+			      const Doubles  &weights,
+			      const Doubles  &errors,
+			      const Doubles  & ) {
+
+			  for ( size_t i = 0; i < n; ++i ) {
+			    wvalue  = weights[ i ];
+			    svalue  = errors[ i ];
+			    wfvalue = weights[ i ];
+			    sfvalue = errors[ i ];
+			    wbranch->Fill();
+			    sbranch->Fill();
+			    if ( ( first + i ) % 100000 == 0 )
+			      tree->AutoSave();
+			  }
+			} );
+    tree->SetBranchStatus( "*", true );
+
+    // Writes the output tree
+    tree->AutoSave();
+    std::cout << "Written output tree < " << tree->GetName() << " > in file: " <<
+      tree->GetDirectory()->GetName() << std::endl;
+
+    std::cout << "*** Weighting process finished ***" << std::endl;
+  }
+
+  //_______________________________________________________________________________
+  //
+  TList* TreeWeighter::makeHistograms( std::string   variable,
+				       const size_t &nbins,
+				       const double &vmin,
+				       const double &vmax ) {
+
+    if ( !this->isTrained() )
+      throw BaseException("The weights have not been calculated yet");
+
+    // Defines the names of the output histograms
+    std::string
+      hrwn = variable + "_RawWhist",
+      hrrn = variable + "_RawRhist",
+      hfwn = variable + "_Whist",
+      hfrn = variable + "_Rhist";
+
+    // These are the different histograms that are returned
+    TH1D
+      *hrw = new TH1D( hrwn.c_str(), hrwn.c_str(), nbins, vmin, vmax ),
+      *hrr = new TH1D( hrrn.c_str(), hrrn.c_str(), nbins, vmin, vmax ),
+      *hfw = new TH1D( hfwn.c_str(), hfwn.c_str(), nbins, vmin, vmax ),
+      *hfr = new TH1D( hfrn.c_str(), hfrn.c_str(), nbins, vmin, vmax );
+
+    // Fills the histograms from the tree to be weighted
+    std::vector<TLeaf*> leaves = this->setupTree( fWgtTree );
+    fWgtTree->SetBranchStatus( variable.c_str(), true );
+    this->evaluateTree( fWgtTree, leaves, fWgtTree->GetLeaf( variable.c_str() ),
+			[hrw, hfw] ( const Long64_t &,
+				     const size_t   &n,
+				     const Doubles  &weights,
+				     const Doubles  &,
+				     const Doubles  &values ) {
+
+			  for ( size_t i = 0; i < n; ++i ) {
+			    hrw->Fill( values[ i ] );
+			    if ( weights[ i ] )
+			      hfw->Fill( values[ i ], weights[ i ] );
+			  }
+			} );
+
+    // Fills the histograms from the reference tree
+    leaves = this->setupTree( fRefTree );
+    fRefTree->SetBranchStatus( variable.c_str(), true );
+    this->evaluateTree( fRefTree, leaves, fRefTree->GetLeaf( variable.c_str() ),
+			[hrr, hfr] ( const Long64_t &,
+				     const size_t   &n,
+				     const Doubles  &weights,
+				     const Doubles  &,
+				     const Doubles  &values ) {
+
+			  for ( size_t i = 0; i < n; ++i ) {
+			    hrr->Fill( values[ i ] );
+			    if ( weights[ i ] > 0 )
+			      hfr->Fill( values[ i ] );
+			  }
+			} );
+
+    // Enables again all the variables of the trees
+    fRefTree->SetBranchStatus( "*", true );
+    fWgtTree->SetBranchStatus( "*", true );
+
+    // Builds the list to be returned
+    TList *list = new TList;
+    list->Add( hrw );
+    list->Add( hrr );
+    list->Add( hfw );
+    list->Add( hfr );
+
+    return list;
+  }
+
+  //_______________________________________________________________________________
+  //
+  void TreeWeighter::bookVariable( const std::string &name, const std::string &unit ) {
+
+    if ( fVariables.count( name ) )
+      throw BaseException("Variable with name \"" + name + "\" already booked");
+
+    std::cout << "*** Adding new variable < " << name << " > ***" << std::endl;
+    if ( unit.size() )
+      fVariables[ name ] = name + " ( " + unit + " )";
+    else
+      fVariables[ name ] = "";
+
+    fVarNames.push_back( name );
+  }
+
+  //_______________________________________________________________________________
+  //
+  std::vector<TLeaf*> TreeWeighter::setupTree( TTree *tree ) const {
+
+    std::vector<TLeaf*> leaves;
+    leaves.reserve( fVarNames.size() );
+
+    tree->SetBranchStatus( "*", false );
+    for ( auto it = fVarNames.cbegin(); it != fVarNames.cend(); ++it ) {
+
+      tree->SetBranchStatus( it->c_str(), true );
+
+      TLeaf *leaf = tree->GetLeaf( it->c_str() );
+      if ( !leaf )
+	throw NotFound("leaf", *it);
+
+      leaves.push_back( leaf );
+    }
+
+    return leaves;
+  }
+
+}
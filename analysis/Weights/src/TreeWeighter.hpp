@@ -0,0 +1,120 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//  Analysis package
+//
+// ---------------------------------------------------------------------------------
+//
+//  AUTHOR: Miguel Ramos Pernas
+//  e-mail: miguel.ramos.pernas@cern.ch
+//
+//  Last update: 18/10/2026
+//
+// ---------------------------------------------------------------------------------
+//
+//  Description:
+//
+//  Base class of the weighters whose weights are evaluated event by event from
+//  the values of the variables (see < BDTWeighter > and < KNNWeighter >). It
+//  holds the two trees and the names of the variables, and implements the
+//  functions to apply the weights to a tree and to make the control histograms
+//  in terms of < evaluateTree >, which must be defined by the derived classes.
+//
+// ---------------------------------------------------------------------------------
+////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef TREE_WEIGHTER
+#define TREE_WEIGHTER
+
+#include "Definitions.hpp"
+
+#include "TLeaf.h"
+#include "TList.h"
+#include "TTree.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+
+//_______________________________________________________________________________
+
+namespace isis {
+
+  class TreeWeighter {
+
+  public:
+
+    // Function called for each block of evaluated events, as
+    // < func(first, n, weights, errors, extravals) >
+    typedef std::function<void ( const Long64_t&,
+				 const size_t&,
+				 const Doubles&,
+				 const Doubles&,
+				 const Doubles& )> BlockFunction;
+
+    // Number of events read and evaluated at once
+    static const size_t BlockSize = 4096;
+
+    // Constructor given the reference tree and the tree to be weighted
+    TreeWeighter( TTree *rtree, TTree *wtree );
+
+    // Destructor
+    virtual ~TreeWeighter();
+
+    // Applies the weights to a given tree. Two branches will be added to it: one
+    // containing the weights and the other the errors. The type of the branch has
+    // also to be specified: D (double), F (float).
+    void applyWeights( TTree             *tree,
+		       const std::string &wvname,
+		       const std::string &svname,
+		       const char        &type );
+
+    // Returns whether the weights have been calculated
+    virtual bool isTrained() const = 0;
+
+    // Returns a list with the histograms for one of the variables in the tree given
+    // its name, the number of bins and the minimum and maximumm value in the
+    // histogram.
+    TList* makeHistograms( std::string   variable,
+			   const size_t &nbins,
+			   const double &vmin,
+			   const double &vmax );
+
+  protected:
+
+    // Number of threads
+    size_t fNthreads;
+
+    // Tree used as a reference
+    TTree *fRefTree;
+
+    // Names of the variables, in the order they were added
+    Strings fVarNames;
+
+    // Map containing name and title for each variable
+    StrMap fVariables;
+
+    // Tree to be weighted
+    TTree *fWgtTree;
+
+    // Books a new variable given its name and units
+    void bookVariable( const std::string &name, const std::string &unit );
+
+    // Evaluates the weights of all the events in a tree by blocks, calling
+    // < func > for each of them. The values of the leaf < extra > are passed
+    // to it if provided.
+    virtual void evaluateTree( TTree                     *tree,
+			       const std::vector<TLeaf*> &leaves,
+			       TLeaf                     *extra,
+			       const BlockFunction       &func ) const = 0;
+
+    // Disables all the branches in the tree but those associated to the variables
+    // and returns the leaves
+    std::vector<TLeaf*> setupTree( TTree *tree ) const;
+
+  };
+
+}
+
+#endif
@@ -7,7 +7,7 @@
 //  AUTHOR: Miguel Ramos Pernas
 //  e-mail: miguel.ramos.pernas@cern.ch
 //
-//  Last update: 10/04/2017
+//  Last update: 18/10/2026
 //
 // ---------------------------------------------------------------------------------
 ////////////////////////////////////////////////////////////////////////////////////
@@ -105,16 +105,13 @@ namespace isis {
 
   //_______________________________________________________________________________
   //
-  std::vector<VarBin> VarBin::split( const std::string &name,
-				     const size_t      &nbins,
-				     const double      &min,
-				     const double      &max ) {
+  std::vector<VarBin> VarBin::split( const std::vector<std::string> &names,
+				     const std::vector<Ranges>      &boxes ) {
     
-    double step = ( max - min )/nbins;
-    std::vector<VarBin> outvector( nbins, *this );
-    for ( size_t i = 0; i < nbins; i++ )
-      outvector[ i ].fVarRanges[ name ] = std::make_pair( min + i*step, min + ( i + 1 )*step );
-    outvector.back().fVarRanges[ name ].second = max;
+    std::vector<VarBin> outvector( boxes.size(), *this );
+    for ( size_t i = 0; i < boxes.size(); i++ )
+      for ( size_t iv = 0; iv < names.size(); iv++ )
+	outvector[ i ].fVarRanges[ names[ iv ] ] = boxes[ i ][ iv ];
     return outvector;
   }
 
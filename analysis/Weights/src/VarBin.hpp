@@ -7,7 +7,7 @@
 //  AUTHOR: Miguel Ramos Pernas
 //  e-mail: miguel.ramos.pernas@cern.ch
 //
-//  Last update: 10/04/2017
+//  Last update: 18/10/2026
 //
 // ---------------------------------------------------------------------------------
 //
@@ -42,6 +42,9 @@ namespace isis {
 
   public:
 
+    // Ranges of a bin for a set of variables
+    typedef std::vector<std::pair<double, double> > Ranges;
+
     // Main constructor
     VarBin();
 
@@ -72,17 +75,19 @@ namespace isis {
     
     // Returns the error associated to the bin
     inline const double getError() const;
+
+    // Returns the range of the bin for the given variable
+    inline const std::pair<double, double>& getRange( const std::string &name ) const;
     
     // Returns the weight associated to the bin
     inline const double getWeight() const;
 
   protected:
 
-    // Divides this bin using the information given
-    std::vector<VarBin> split( const std::string &name,
-			       const size_t      &nbins,
-			       const double      &min,
-			       const double      &max );
+    // Divides this bin in a set of boxes, each of them containing the ranges for
+    // the variables with the names given
+    std::vector<VarBin> split( const std::vector<std::string> &names,
+			       const std::vector<Ranges>      &boxes );
 
   protected:
     
@@ -114,6 +119,12 @@ namespace isis {
   //
   inline const double VarBin::getError() const { return fError; }
 
+  //_______________________________________________________________________________
+  //
+  inline const std::pair<double, double>& VarBin::getRange( const std::string &name ) const {
+    return fVarRanges.at( name );
+  }
+
   //_______________________________________________________________________________
   //
   inline const double VarBin::getWeight() const { return fWeight; }
@@ -0,0 +1,162 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//  Analysis package
+//
+// ---------------------------------------------------------------------------------
+//
+//  AUTHOR: Miguel Ramos Pernas
+//  e-mail: miguel.ramos.pernas@cern.ch
+//
+//  Last update: 18/10/2026
+//
+// ---------------------------------------------------------------------------------
+////////////////////////////////////////////////////////////////////////////////////
+
+
+#include "VarBinLocator.hpp"
+
+#include <algorithm>
+
+
+//_______________________________________________________________________________
+
+namespace isis {
+
+  //_______________________________________________________________________________
+  //
+  VarBinLocator::VarBinLocator( const std::vector<VarBin> &bins,
+				const Strings &names ) :
+    fEdges( names.size() ), fLinear( false ), fStrides( names.size() ) {
+
+    // Collects the edges of all the bins for each variable
+    for ( size_t iv = 0; iv < names.size(); ++iv ) {
+
+      Doubles &edges = fEdges[ iv ];
+      for ( auto itb = bins.cbegin(); itb != bins.cend(); ++itb ) {
+	const std::pair<double, double> &range = itb->getRange( names[ iv ] );
+	edges.push_back( range.first );
+	edges.push_back( range.second );
+      }
+      std::sort( edges.begin(), edges.end() );
+      edges.erase( std::unique( edges.begin(), edges.end() ), edges.end() );
+    }
+
+    const size_t nvars = names.size();
+
+    // Cells covered by each bin, as the first and last position in each axis.
+    // Empty bins can not contain any value.
+    std::vector<Sizes> first( bins.size() ), last( bins.size() );
+    for ( size_t ib = 0; ib < bins.size(); ++ib ) {
+
+      first[ ib ].resize( nvars );
+      last[ ib ].resize( nvars );
+
+      for ( size_t iv = 0; iv < nvars; ++iv ) {
+
+	const Doubles &edges = fEdges[ iv ];
+	const std::pair<double, double> &range = bins[ ib ].getRange( names[ iv ] );
+
+	first[ ib ][ iv ] = std::lower_bound( edges.cbegin(), edges.cend(), range.first ) - edges.cbegin();
+	last[ ib ][ iv ]  = std::lower_bound( edges.cbegin(), edges.cend(), range.second ) - edges.cbegin();
+      }
+    }
+
+    // The number of cells can grow as the product of the number of bins in each
+    // axis, so the table is only built if it is small enough
+    const size_t maxsize = size_t( -1 );
+
+    size_t stride = 1;
+    for ( size_t iv = nvars; iv-- && !fLinear; ) {
+      fStrides[ iv ] = stride;
+      if ( fEdges[ iv ].size() > 1 ) {
+	const size_t n = fEdges[ iv ].size() - 1;
+	if ( stride > maxsize/n )
+	  fLinear = true;
+	else
+	  stride *= n;
+      }
+    }
+
+    size_t ncells = 0;
+    for ( size_t ib = 0; ib < bins.size() && !fLinear; ++ib ) {
+
+      size_t n = 1;
+      for ( size_t iv = 0; iv < nvars; ++iv ) {
+	const size_t nv = last[ ib ][ iv ] - first[ ib ][ iv ];
+	n = ( nv && n > MaxCells/nv ) ? MaxCells + 1 : n*nv;
+      }
+
+      ncells += n;
+      if ( ncells > MaxCells )
+	fLinear = true;
+    }
+
+    if ( fLinear ) {
+
+      fEdges.assign( nvars, Doubles() );
+      fStrides.assign( nvars, 0 );
+
+      fRanges.reserve( 2*bins.size()*nvars );
+      for ( auto itb = bins.cbegin(); itb != bins.cend(); ++itb )
+	for ( size_t iv = 0; iv < nvars; ++iv ) {
+	  const std::pair<double, double> &range = itb->getRange( names[ iv ] );
+	  fRanges.push_back( range.first );
+	  fRanges.push_back( range.second );
+	}
+
+      return;
+    }
+
+    fCells.reserve( ncells );
+
+    // Each bin might cover several cells if other bins split its ranges
+    Sizes current( nvars );
+    for ( size_t ib = 0; ib < bins.size(); ++ib ) {
+
+      const Sizes &bfirst = first[ ib ];
+      const Sizes &blast  = last[ ib ];
+
+      bool empty = false;
+      for ( size_t iv = 0; iv < nvars; ++iv )
+	empty = empty || bfirst[ iv ] == blast[ iv ];
+      if ( empty )
+	continue;
+
+      current = bfirst;
+      while ( true ) {
+
+	size_t cell = 0;
+	for ( size_t iv = 0; iv < nvars; ++iv )
+	  cell += current[ iv ]*fStrides[ iv ];
+	fCells.push_back( std::make_pair( cell, ib ) );
+
+	// Moves to the next cell inside the bin
+	size_t iv = nvars;
+	while ( iv-- ) {
+	  if ( ++current[ iv ] < blast[ iv ] )
+	    break;
+	  current[ iv ] = bfirst[ iv ];
+	}
+	if ( iv == size_t( -1 ) )
+	  break;
+      }
+    }
+
+    // The first bin found is kept if two of them overlap
+    std::stable_sort( fCells.begin(), fCells.end(),
+		      [] ( const std::pair<size_t, size_t> &a,
+			   const std::pair<size_t, size_t> &b ) {
+			return a.first < b.first;
+		      } );
+    fCells.erase( std::unique( fCells.begin(), fCells.end(),
+			       [] ( const std::pair<size_t, size_t> &a,
+				    const std::pair<size_t, size_t> &b ) {
+				 return a.first == b.first;
+			       } ), fCells.end() );
+  }
+
+  //_______________________________________________________________________________
+  //
+  VarBinLocator::~VarBinLocator() { }
+
+}
@@ -0,0 +1,139 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//  Analysis package
+//
+// ---------------------------------------------------------------------------------
+//
+//  AUTHOR: Miguel Ramos Pernas
+//  e-mail: miguel.ramos.pernas@cern.ch
+//
+//  Last update: 18/10/2026
+//
+// ---------------------------------------------------------------------------------
+//
+//  Description:
+//
+//  Finds the bin of a vector of < VarBin > objects associated to a set of values
+//  without iterating over all of them. The edges of the bins are collected for
+//  each variable, so the values are first located in each axis by a binary
+//  search, and then the combination of cells is searched in a sorted table. The
+//  bins are assumed not to overlap, as it happens in < VarWeighter >. If the
+//  table would need more than < MaxCells > cells, the bins are searched
+//  linearly instead.
+//
+// ---------------------------------------------------------------------------------
+////////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef VAR_BIN_LOCATOR
+#define VAR_BIN_LOCATOR
+
+#include "Definitions.hpp"
+#include "VarBin.hpp"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+
+//_______________________________________________________________________________
+
+namespace isis {
+
+  class VarBinLocator {
+
+  public:
+
+    // Value returned when the values are not inside any of the bins
+    static const size_t NotFound = size_t( -1 );
+
+    // Maximum number of cells in the table
+    static const size_t MaxCells = size_t( 1 ) << 24;
+
+    // Main constructor. It needs the vector of bins and the names of the
+    // variables, which defines the order of the values given to < find >.
+    VarBinLocator( const std::vector<VarBin> &bins, const Strings &names );
+
+    // Destructor
+    ~VarBinLocator();
+
+    // Returns the index of the bin containing the given values, or < NotFound >
+    // if they are outside all of them. This method is thread-safe.
+    inline size_t find( const double *values ) const;
+
+    // Returns whether the bins are searched linearly
+    inline bool isLinear() const;
+
+  protected:
+
+    // Sorted edges for each variable
+    std::vector<Doubles> fEdges;
+
+    // Pairs of cell index and bin index, sorted by the first
+    std::vector<std::pair<size_t, size_t> > fCells;
+
+    // Whether the bins are searched linearly
+    bool fLinear;
+
+    // Minimum and maximum values of each bin and variable, used when the bins
+    // are searched linearly
+    Doubles fRanges;
+
+    // Strides used to calculate the index of a cell from those in each axis
+    Sizes fStrides;
+
+  };
+
+  //_______________________________________________________________________________
+  //
+  inline size_t VarBinLocator::find( const double *values ) const {
+
+    const size_t nvars = fEdges.size();
+
+    if ( fLinear ) {
+
+      const size_t nbins = nvars ? fRanges.size()/( 2*nvars ) : 0;
+
+      for ( size_t ib = 0; ib < nbins; ++ib ) {
+
+	const double *range = &fRanges[ 2*ib*nvars ];
+
+	bool inside = true;
+	for ( size_t iv = 0; iv < nvars && inside; ++iv )
+	  inside = values[ iv ] >= range[ 2*iv ] && values[ iv ] < range[ 2*iv + 1 ];
+
+	if ( inside )
+	  return ib;
+      }
+
+      return NotFound;
+    }
+
+    size_t cell = 0;
+    for ( size_t iv = 0; iv < nvars; ++iv ) {
+
+      const Doubles &edges = fEdges[ iv ];
+
+      // Ranges are closed on the left and open on the right
+      auto it = std::upper_bound( edges.cbegin(), edges.cend(), values[ iv ] );
+      if ( it == edges.cbegin() || it == edges.cend() )
+	return NotFound;
+
+      cell += ( it - edges.cbegin() - 1 )*fStrides[ iv ];
+    }
+
+    auto it = std::lower_bound( fCells.cbegin(), fCells.cend(),
+				std::make_pair( cell, size_t( 0 ) ) );
+    if ( it == fCells.cend() || it->first != cell )
+      return NotFound;
+
+    return it->second;
+  }
+
+  //_______________________________________________________________________________
+  //
+  inline bool VarBinLocator::isLinear() const { return fLinear; }
+
+}
+
+#endif
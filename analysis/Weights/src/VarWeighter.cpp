@@ -7,15 +7,20 @@
 //  AUTHOR: Miguel Ramos Pernas
 //  e-mail: miguel.ramos.pernas@cern.ch
 //
-//  Last update: 19/10/2017
+//  Last update: 18/10/2026
 //
 // ---------------------------------------------------------------------------------
 ////////////////////////////////////////////////////////////////////////////////////
 
 
+#include "Bin1D.hpp"
+#include "Bin2D.hpp"
+#include "BinaryIO.hpp"
 #include "Definitions.hpp"
 #include "Exceptions.hpp"
+#include "Parallel.hpp"
 #include "Utils.hpp"
+#include "VarBinLocator.hpp"
 #include "VarWeighter.hpp"
 
 #include "TBranch.h"
@@ -26,6 +31,7 @@
 #include "TList.h"
 
 #include <algorithm>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <cmath>
@@ -35,6 +41,10 @@
 
 namespace isis {
 
+  //_______________________________________________________________________________
+  //
+  const uint32_t VarWeighter::FileVersion;
+
   //_______________________________________________________________________________
   //
   VarWeighter::VarWeighter( TTree *rtree, TTree *wtree ) :
@@ -48,6 +58,57 @@ namespace isis {
       wtree->GetDirectory()->GetName() << " )" << std::endl;
   }
 
+  //_______________________________________________________________________________
+  //
+  VarWeighter::VarWeighter( const std::string &path ) :
+    fRefTree( 0 ), fWgtTree( 0 ) {
+    std::cout << "***********************************" << std::endl;
+    std::cout << "*** Initializing weighter class ***" << std::endl;
+    std::cout << "***********************************" << std::endl;
+    std::cout << " - Loading from file: " << path << std::endl;
+
+    std::ifstream file( path, std::ios::binary );
+    if ( !file )
+      throw NotFound("file", path);
+
+    const uint32_t version = binio::readHeader( file, "ISISVW" );
+    if ( version > FileVersion )
+      throw BaseException("The file \"" + path + "\" has version " +
+			  std::to_string(version) + ", but the latest supported is " +
+			  std::to_string(FileVersion));
+
+    // The names of the variables are stored once, and the ranges of each bin
+    // follow the same order
+    uint64_t nvars;
+    binio::read( file, nvars );
+    Strings names( nvars );
+    for ( auto it = names.begin(); it != names.end(); ++it ) {
+      std::string title;
+      binio::read( file, *it );
+      binio::read( file, title );
+      fVariables[ *it ] = title;
+    }
+
+    uint64_t nbins;
+    binio::read( file, nbins );
+    fBinVector = std::vector<VarBin>( nbins );
+    for ( auto itb = fBinVector.begin(); itb != fBinVector.end(); ++itb ) {
+      for ( auto it = names.cbegin(); it != names.cend(); ++it ) {
+	std::pair<double, double> &range = itb->fVarRanges[ *it ];
+	binio::read( file, range.first );
+	binio::read( file, range.second );
+      }
+      uint64_t nentries;
+      binio::read( file, nentries );
+      itb->fNentries = nentries;
+      binio::read( file, itb->fWeight );
+      binio::read( file, itb->fError );
+    }
+
+    std::cout << " - Number of variables: " << fVariables.size() << std::endl;
+    std::cout << " - Bin-list size:       " << fBinVector.size() << std::endl;
+  }
+
   //_______________________________________________________________________________
   //
   VarWeighter::~VarWeighter() { }
@@ -59,6 +120,7 @@ namespace isis {
 				 const double      &min,
 				 const double      &max,
 				 const std::string &unit ) {
+    this->checkTrees();
     std::cout << "*** Adding new variable < " << name << " > ***" << std::endl;
     std::cout << " - Number of bins: " << nbins << std::endl;
     std::cout << " - Minimum value:  " << min << std::endl;
@@ -67,38 +129,138 @@ namespace isis {
       fVariables[ name ] = name + " ( " + unit + " )";
     else
       fVariables[ name ] = "";
-    std::vector<VarBin> vbvector, appvector;
-    for ( auto it = fBinVector.begin(); it != fBinVector.end(); it++ ) {
-      vbvector = it->split( name, nbins, min, max );
-      appvector.insert( appvector.end(), vbvector.begin(), vbvector.end() );
+
+    double step = ( max - min )/nbins;
+    std::vector<VarBin::Ranges> boxes( nbins );
+    for ( size_t i = 0; i < nbins; i++ )
+      boxes[ i ].push_back( std::make_pair( min + i*step, min + ( i + 1 )*step ) );
+    boxes.back().back().second = max;
+
+    this->splitBins( Strings( 1, name ), boxes );
+  }
+
+  //_______________________________________________________________________________
+  //
+  void VarWeighter::addVariable( const std::string       &name,
+				 const AdaptiveBinning1D &binning,
+				 const std::string       &unit ) {
+    this->checkTrees();
+    std::cout << "*** Adding new variable < " << name << " > ***" << std::endl;
+    std::cout << " - Number of adaptive bins: " << binning.getNbins() << std::endl;
+    std::cout << " - Minimum value:           " << binning.getMin() << std::endl;
+    std::cout << " - Maximum value:           " << binning.getMax() << std::endl;
+    if ( unit.size() )
+      fVariables[ name ] = name + " ( " + unit + " )";
+    else
+      fVariables[ name ] = "";
+
+    // The bins that could not be filled have their minimum equal to the maximum
+    // of the binning, so repeated edges are removed
+    Doubles edges;
+    const std::vector<Bin*> &bins = binning.getBinList();
+    for ( auto it = bins.cbegin(); it != bins.cend(); ++it )
+      edges.push_back( static_cast<const Bin1D*>( *it )->getMin() );
+    edges.push_back( binning.getMax() );
+    edges.erase( std::unique( edges.begin(), edges.end() ), edges.end() );
+
+    std::vector<VarBin::Ranges> boxes( edges.size() - 1 );
+    for ( size_t i = 0; i < boxes.size(); i++ )
+      boxes[ i ].push_back( std::make_pair( edges[ i ], edges[ i + 1 ] ) );
+
+    this->splitBins( Strings( 1, name ), boxes );
+  }
+
+  //_______________________________________________________________________________
+  //
+  void VarWeighter::addVariables( const std::string       &xname,
+				  const std::string       &yname,
+				  const AdaptiveBinning2D &binning,
+				  const std::string       &xunit,
+				  const std::string       &yunit ) {
+    this->checkTrees();
+    std::cout << "*** Adding new variables < " << xname << ", " << yname << " > ***" << std::endl;
+    std::cout << " - Number of adaptive bins: " << binning.getNbins() << std::endl;
+    std::cout << " - Range in X:              ( " <<
+      binning.getXmin() << ", " << binning.getXmax() << " )" << std::endl;
+    std::cout << " - Range in Y:              ( " <<
+      binning.getYmin() << ", " << binning.getYmax() << " )" << std::endl;
+    if ( xunit.size() )
+      fVariables[ xname ] = xname + " ( " + xunit + " )";
+    else
+      fVariables[ xname ] = "";
+    if ( yunit.size() )
+      fVariables[ yname ] = yname + " ( " + yunit + " )";
+    else
+      fVariables[ yname ] = "";
+
+    Strings names = { xname, yname };
+
+    std::vector<VarBin::Ranges> boxes;
+    const std::vector<Bin*> &bins = binning.getBinList();
+    for ( auto it = bins.cbegin(); it != bins.cend(); ++it ) {
+      const Bin2D *bin = static_cast<const Bin2D*>( *it );
+      VarBin::Ranges ranges = {
+	std::make_pair( bin->getXmin(), bin->getXmax() ),
+	std::make_pair( bin->getYmin(), bin->getYmax() )
+      };
+      boxes.push_back( ranges );
     }
 
-    // Makes the setup of the trees
-    std::map<std::string, TLeaf*> refleafmap, wgtleafmap;
-    std::map<std::string, double> valuesmap;
-    this->setupTrees( refleafmap, wgtleafmap, valuesmap );
-  
-    // Fills the bins with the reference data and removes the blank ones
-    this->fillBinVector( fRefTree, refleafmap, valuesmap, appvector );
-    for ( auto itb = appvector.begin(); itb != appvector.end(); itb++ )
-      if ( itb->getEntries() == 0 )
-	appvector.erase( itb-- );
-    for ( auto itb = appvector.begin(); itb != appvector.end(); itb++ )
-      itb->fNentries = 0;
+    this->splitBins( names, boxes );
+  }
 
-    // Fills the bins with the data to be weighted and removes the blank ones
-    this->fillBinVector( fWgtTree, wgtleafmap, valuesmap, appvector );
-    for ( auto itb = appvector.begin(); itb != appvector.end(); itb++ )
-      if ( itb->getEntries() == 0 )
-	appvector.erase( itb-- );
-    for ( auto itb = appvector.begin(); itb != appvector.end(); itb++ )
-      itb->fNentries = 0;
+  //_______________________________________________________________________________
+  //
+  void VarWeighter::addAdaptiveVariable( const std::string &name,
+					 const size_t      &occ,
+					 const double      &min,
+					 const double      &max,
+					 const std::string &unit ) {
+    this->checkTrees();
+    std::cout << "Computing the adaptive binning of < " << name <<
+      " > with occupancy " << occ << std::endl;
 
-    // Finally redefines the vector of bins of the class
-    fBinVector = appvector;
-    std::cout << " - Bin-list size:  " << fBinVector.size() << std::endl;
+    std::vector<Doubles> values = this->readReference( Strings( 1, name ) );
+
+    AdaptiveBinning1D binning( occ, min, max, values[ 0 ] );
+
+    this->addVariable( name, binning, unit );
   }
 
+  //_______________________________________________________________________________
+  //
+  void VarWeighter::addAdaptiveVariables( const std::string &xname,
+					  const std::string &yname,
+					  const size_t      &occ,
+					  const double      &xmin,
+					  const double      &xmax,
+					  const double      &ymin,
+					  const double      &ymax,
+					  const std::string &xunit,
+					  const std::string &yunit ) {
+    this->checkTrees();
+    std::cout << "Computing the adaptive binning of < " << xname << ", " << yname <<
+      " > with occupancy " << occ << std::endl;
+
+    std::vector<Doubles> values = this->readReference( { xname, yname } );
+
+    // Only the points inside the ranges are used to make the binning
+    Doubles xvalues, yvalues;
+    for ( size_t i = 0; i < values[ 0 ].size(); ++i ) {
+      const double &x = values[ 0 ][ i ], &y = values[ 1 ][ i ];
+      if ( x >= xmin && x < xmax && y >= ymin && y < ymax ) {
+	xvalues.push_back( x );
+	yvalues.push_back( y );
+      }
+    }
+
+    if ( xvalues.empty() )
+      throw BaseException("No reference entries inside the given ranges");
+
+    AdaptiveBinning2D binning( occ, xmin, xmax, ymin, ymax, xvalues, yvalues );
+
+    this->addVariables( xname, yname, binning, xunit, yunit );
+  }
 
   //_______________________________________________________________________________
   //
@@ -109,14 +271,12 @@ namespace isis {
     std::cout << "*** Initializing weighting process ***" << std::endl;
     std::cout << "Working with tree: " << tree->GetName() <<
       " ( " << tree->GetDirectory()->GetName() << " )" << std::endl;
-    // Generates the maps of values and with the leaves of the tree to be used
+    // Generates the map with the leaves of the tree to be used
     std::map<std::string, TLeaf*> newleafmap;
-    std::map<std::string, double> valuesmap;
     tree->SetBranchStatus( "*", false );
     for ( auto it = fVariables.begin(); it != fVariables.end(); it++ ) {
       tree->SetBranchStatus( it->first.c_str(), true );
       newleafmap[ it->first ] = tree->GetLeaf( it->first.c_str() );
-      valuesmap[ it->first ]  = 0;
     }
 
     // Defines the variable to be added and its branch
@@ -143,10 +303,14 @@ namespace isis {
 
     // Fills the output branches
     std::cout << "Filling the output branch" << std::endl;
+    Strings names;
+    for ( auto it = fVariables.begin(); it != fVariables.end(); it++ )
+      names.push_back( it->first );
+    VarBinLocator locator( fBinVector, names );
     if ( type == 'D' )
-      this->fill<double*>( tree, wbranch, waddress, sbranch, saddress, valuesmap, newleafmap );
+      this->fill<double*>( tree, wbranch, waddress, sbranch, saddress, locator, newleafmap );
     else
-      this->fill<float*>( tree, wbranch, waddress, sbranch, saddress, valuesmap, newleafmap );
+      this->fill<float*>( tree, wbranch, waddress, sbranch, saddress, locator, newleafmap );
     tree->SetBranchStatus( "*", true );
 
     // Writes the output tree
@@ -171,7 +335,8 @@ namespace isis {
   //
   void VarWeighter::calculateWeights( const double &maxrelerr,
 				      const size_t &prec ) {
-  
+
+    this->checkTrees();
     std::cout << "***************************" << std::endl;
     std::cout << "*** Calculating weights ***" << std::endl;
     std::cout << "***************************" << std::endl;
@@ -240,76 +405,44 @@ namespace isis {
 				      const size_t &nbins,
 				      const double &vmin,
 				      const double &vmax ) {
-    // Defines the names of the output histograms
-    std::string
-      hrwn = variable + "_RawWhist",
-      hrrn = variable + "_RawRhist",
-      hfwn = variable + "_Whist",
-      hfrn = variable + "_Rhist";
-
-    // These are the different histograms that are returned
-    TH1D
-      *hrw = new TH1D( hrwn.c_str(), hrwn.c_str(), nbins, vmin, vmax ),
-      *hrr = new TH1D( hrrn.c_str(), hrrn.c_str(), nbins, vmin, vmax ),
-      *hfw = new TH1D( hfwn.c_str(), hfwn.c_str(), nbins, vmin, vmax ),
-      *hfr = new TH1D( hfrn.c_str(), hfrn.c_str(), nbins, vmin, vmax );
 
-    // Makes the setup of the trees
-    std::map<std::string, TLeaf*> refleafmap, wgtleafmap;
-    std::map<std::string, double> valuesmap;
-    this->setupTrees( refleafmap, wgtleafmap, valuesmap );
-  
-    Strings variables;
-    TLeaf *leaf;
-    for ( auto it = fVariables.begin(); it != fVariables.end(); it++ )
-      variables.push_back( it->first );
-    if ( std::find( variables.begin(), variables.end(), variable ) == variables.end() ) {
-      variables.push_back( variable );
-      fRefTree->SetBranchStatus( variable.c_str(), true );
-      fWgtTree->SetBranchStatus( variable.c_str(), true );
-    }
-  
-    // This is the iterator of the vector of bins
-    std::vector<VarBin>::iterator itb;
-
-    // Fills the histograms from the tree to be weighted
-    leaf = fWgtTree->GetLeaf( variable.c_str() );
-    for ( Long64_t ievt = 0; ievt < fWgtTree->GetEntries(); ievt++ ) {
-      fWgtTree->GetEntry( ievt );
-      for ( auto it = valuesmap.begin(); it != valuesmap.end(); it++ )
-	it->second = wgtleafmap[ it->first ]->GetValue();
-      hrw->Fill( leaf->GetValue() );
-      itb = fBinVector.begin();
-      while( itb != fBinVector.end() && itb->isOutside( valuesmap ) )
-	itb++;
-      if ( itb != fBinVector.end() && itb->getWeight() )
-	hfw->Fill( leaf->GetValue(), itb->getWeight() );
-    }
-  
-    // Fills the histograms from the reference tree
-    leaf = fRefTree->GetLeaf( variable.c_str() );
-    for ( Long64_t ievt = 0; ievt < fRefTree->GetEntries(); ievt++ ) {
-      fRefTree->GetEntry( ievt );
-      for ( auto it = valuesmap.begin(); it != valuesmap.end(); it++ )
-	it->second = refleafmap[ it->first ]->GetValue();
-      hrr->Fill( leaf->GetValue() );
-      itb = fBinVector.begin();
-      while( itb != fBinVector.end() && itb->isOutside( valuesmap ) )
-	itb++;
-      if ( itb != fBinVector.end() && itb->getWeight() > 0 )
-	hfr->Fill( leaf->GetValue() );
+    HistConfig config = { variable, nbins, vmin, vmax };
+
+    return this->makeHistograms( std::vector<HistConfig>( 1, config ) );
+  }
+
+  //_______________________________________________________________________________
+  //
+  TList* VarWeighter::makeHistograms( const std::vector<HistConfig> &configs,
+				      const size_t &nthreads ) {
+    this->checkTrees();
+
+    // These are the different histograms that are returned, with four histograms
+    // for each variable
+    std::vector<TH1D*> hists;
+    for ( auto it = configs.cbegin(); it != configs.cend(); ++it ) {
+
+      // Defines the names of the output histograms
+      std::string
+	hrwn = it->variable + "_RawWhist",
+	hrrn = it->variable + "_RawRhist",
+	hfwn = it->variable + "_Whist",
+	hfrn = it->variable + "_Rhist";
+
+      hists.push_back( new TH1D( hrwn.c_str(), hrwn.c_str(), it->nbins, it->min, it->max ) );
+      hists.push_back( new TH1D( hrrn.c_str(), hrrn.c_str(), it->nbins, it->min, it->max ) );
+      hists.push_back( new TH1D( hfwn.c_str(), hfwn.c_str(), it->nbins, it->min, it->max ) );
+      hists.push_back( new TH1D( hfrn.c_str(), hfrn.c_str(), it->nbins, it->min, it->max ) );
     }
 
-    // Enables again all the variables of the trees
-    fRefTree->SetBranchStatus( "*", true );
-    fWgtTree->SetBranchStatus( "*", true );
+    // Fills the histograms from the tree to be weighted and the reference tree
+    this->fillHistograms( fWgtTree, configs, hists, false, nthreads );
+    this->fillHistograms( fRefTree, configs, hists, true, nthreads );
 
     // Builds the list to be returned
     TList *list = new TList;
-    list->Add( hrw );
-    list->Add( hrr );
-    list->Add( hfw );
-    list->Add( hfr );
+    for ( auto it = hists.begin(); it != hists.end(); ++it )
+      list->Add( *it );
 
     return list;
   }
@@ -355,19 +488,288 @@ namespace isis {
     std::cout << separator << std::endl;
   }
 
+  //_______________________________________________________________________________
+  //
+  void VarWeighter::save( const std::string &path ) const {
+
+    std::ofstream file( path, std::ios::binary );
+    if ( !file )
+      throw BaseException("Unable to open file \"" + path + "\" for writing");
+
+    binio::writeHeader( file, "ISISVW", FileVersion );
+
+    binio::write( file, uint64_t( fVariables.size() ) );
+    for ( auto it = fVariables.cbegin(); it != fVariables.cend(); ++it ) {
+      binio::write( file, it->first );
+      binio::write( file, it->second );
+    }
+
+    binio::write( file, uint64_t( fBinVector.size() ) );
+    for ( auto itb = fBinVector.cbegin(); itb != fBinVector.cend(); ++itb ) {
+      for ( auto it = fVariables.cbegin(); it != fVariables.cend(); ++it ) {
+	const std::pair<double, double> &range = itb->fVarRanges.at( it->first );
+	binio::write( file, range.first );
+	binio::write( file, range.second );
+      }
+      binio::write( file, uint64_t( itb->fNentries ) );
+      binio::write( file, itb->fWeight );
+      binio::write( file, itb->fError );
+    }
+
+    if ( !file )
+      throw BaseException("Error writing the weighter to file \"" + path + "\"");
+
+    std::cout << "Weighter saved in file: " << path << std::endl;
+  }
+
+  //_______________________________________________________________________________
+  //
+  void VarWeighter::checkTrees() const {
+
+    if ( !fRefTree || !fWgtTree )
+      throw BaseException("The reference and weighting trees are not available; "
+			  "only the weights can be applied");
+  }
+
+  //_______________________________________________________________________________
+  //
+  void VarWeighter::fillHistograms( TTree                         *tree,
+				    const std::vector<HistConfig> &configs,
+				    const std::vector<TH1D*>      &hists,
+				    const bool                    &reference,
+				    const size_t                  &nthreads ) {
+
+    // The variables used to calculate the weights come first, so their values
+    // can be given directly to the locator of bins
+    Strings variables;
+    for ( auto it = fVariables.cbegin(); it != fVariables.cend(); ++it )
+      variables.push_back( it->first );
+    const size_t nwvars = variables.size();
+
+    Sizes columns;
+    for ( auto it = configs.cbegin(); it != configs.cend(); ++it ) {
+      auto itv = std::find( variables.begin(), variables.end(), it->variable );
+      columns.push_back( itv - variables.begin() );
+      if ( itv == variables.end() )
+	variables.push_back( it->variable );
+    }
+    const size_t ncols = variables.size();
+
+    VarBinLocator locator( fBinVector, Strings( variables.begin(), variables.begin() + nwvars ) );
+
+    Doubles binweights;
+    for ( auto itb = fBinVector.cbegin(); itb != fBinVector.cend(); ++itb )
+      binweights.push_back( itb->getWeight() );
+
+    tree->SetBranchStatus( "*", false );
+    std::vector<TLeaf*> leaves;
+    for ( auto it = variables.cbegin(); it != variables.cend(); ++it ) {
+      tree->SetBranchStatus( it->c_str(), true );
+      TLeaf *leaf = tree->GetLeaf( it->c_str() );
+      if ( !leaf )
+	throw NotFound("leaf", *it);
+      leaves.push_back( leaf );
+    }
+
+    // Offsets of the histograms of each variable in the buffers, including the
+    // underflow and overflow bins
+    Sizes offsets( 1, 0 );
+    for ( auto it = configs.cbegin(); it != configs.cend(); ++it )
+      offsets.push_back( offsets.back() + it->nbins + 2 );
+
+    // Each thread fills its own buffers, which are merged at the end
+    const size_t nt = nthreads ? nthreads : defaultNthreads();
+    std::vector<Doubles>
+      rawsums( nt, Doubles( offsets.back(), 0 ) ),
+      wgtsums( nt, Doubles( offsets.back(), 0 ) ),
+      wgtsums2( nt, Doubles( offsets.back(), 0 ) );
+    Sizes nfilled( nt, 0 );
+
+    Doubles values( BlockSize*ncols );
+
+    const Long64_t nentries = tree->GetEntries();
+    for ( Long64_t first = 0; first < nentries; first += BlockSize ) {
+
+      const Long64_t last = std::min( first + Long64_t( BlockSize ), nentries );
+
+      auto itv = values.begin();
+      for ( Long64_t ievt = first; ievt < last; ++ievt ) {
+	tree->GetEntry( ievt );
+	for ( auto itl = leaves.cbegin(); itl != leaves.cend(); ++itl )
+	  *itv++ = ( *itl )->GetValue();
+      }
+
+      parallelFor( last - first, nt, [&] ( size_t it, size_t f, size_t l ) {
+
+	  Doubles &raw = rawsums[ it ], &wgt = wgtsums[ it ], &wgt2 = wgtsums2[ it ];
+
+	  for ( size_t i = f; i < l; ++i ) {
+
+	    const double *vals = &values[ i*ncols ];
+
+	    size_t ib = locator.find( vals );
+
+	    double w = ib == VarBinLocator::NotFound ? 0 : binweights[ ib ];
+
+	    // Events from the reference tree are filled with unit weight if they
+	    // belong to a bin with positive weight
+	    bool fillw = reference ? w > 0 : w != 0;
+	    if ( reference )
+	      w = 1;
+
+	    nfilled[ it ] += fillw;
+
+	    for ( size_t ic = 0; ic < configs.size(); ++ic ) {
+
+	      const HistConfig &cfg = configs[ ic ];
+	      const double x = vals[ columns[ ic ] ];
+
+	      // Same convention as in < TAxis::FindBin >
+	      size_t bin;
+	      if ( x < cfg.min )
+		bin = 0;
+	      else if ( !( x < cfg.max ) )
+		bin = cfg.nbins + 1;
+	      else {
+		bin = 1 + size_t( cfg.nbins*( x - cfg.min )/( cfg.max - cfg.min ) );
+		if ( bin > cfg.nbins )
+		  bin = cfg.nbins;
+	      }
+
+	      raw[ offsets[ ic ] + bin ] += 1;
+	      if ( fillw ) {
+		wgt[ offsets[ ic ] + bin ]  += w;
+		wgt2[ offsets[ ic ] + bin ] += w*w;
+	      }
+	    }
+	  }
+	} );
+    }
+
+    tree->SetBranchStatus( "*", true );
+
+    // Merges the buffers into the histograms
+    size_t nwgt = 0;
+    for ( auto it = nfilled.cbegin(); it != nfilled.cend(); ++it )
+      nwgt += *it;
+
+    for ( size_t ic = 0; ic < configs.size(); ++ic ) {
+
+      TH1D
+	*hraw = hists[ 4*ic + reference ],
+	*hwgt = hists[ 4*ic + 2 + reference ];
+
+      if ( !reference )
+	hwgt->Sumw2();
+
+      for ( size_t bin = 0; bin < configs[ ic ].nbins + 2; ++bin ) {
+
+	double raw = 0, wgt = 0, wgt2 = 0;
+	for ( size_t it = 0; it < nt; ++it ) {
+	  raw  += rawsums[ it ][ offsets[ ic ] + bin ];
+	  wgt  += wgtsums[ it ][ offsets[ ic ] + bin ];
+	  wgt2 += wgtsums2[ it ][ offsets[ ic ] + bin ];
+	}
+
+	hraw->SetBinContent( bin, raw );
+	hwgt->SetBinContent( bin, wgt );
+	if ( !reference )
+	  hwgt->SetBinError( bin, std::sqrt( wgt2 ) );
+      }
+
+      hraw->SetEntries( nentries );
+      hwgt->SetEntries( nwgt );
+    }
+  }
+
+  //_______________________________________________________________________________
+  //
+  std::vector<Doubles> VarWeighter::readReference( const Strings &names ) {
+
+    fRefTree->SetBranchStatus( "*", false );
+    std::vector<TLeaf*> leaves;
+    for ( auto it = names.begin(); it != names.end(); it++ ) {
+      fRefTree->SetBranchStatus( it->c_str(), true );
+      TLeaf *leaf = fRefTree->GetLeaf( it->c_str() );
+      if ( !leaf )
+	throw NotFound("leaf", *it);
+      leaves.push_back( leaf );
+    }
+
+    std::vector<Doubles> values( names.size(), Doubles( fRefTree->GetEntries() ) );
+    for ( Long64_t ievt = 0; ievt < fRefTree->GetEntries(); ievt++ ) {
+      fRefTree->GetEntry( ievt );
+      for ( size_t iv = 0; iv < leaves.size(); iv++ )
+	values[ iv ][ ievt ] = leaves[ iv ]->GetValue();
+    }
+
+    fRefTree->SetBranchStatus( "*", true );
+
+    return values;
+  }
+
+  //_______________________________________________________________________________
+  //
+  void VarWeighter::splitBins( const Strings &names,
+			       const std::vector<VarBin::Ranges> &boxes ) {
+
+    std::vector<VarBin> vbvector, appvector;
+    for ( auto it = fBinVector.begin(); it != fBinVector.end(); it++ ) {
+      vbvector = it->split( names, boxes );
+      appvector.insert( appvector.end(), vbvector.begin(), vbvector.end() );
+    }
+
+    // Makes the setup of the trees
+    std::map<std::string, TLeaf*> refleafmap, wgtleafmap;
+    std::map<std::string, double> valuesmap;
+    this->setupTrees( refleafmap, wgtleafmap, valuesmap );
+
+    auto blank = [] ( const VarBin &bin ) { return bin.getEntries() == 0; };
+
+    // Fills the bins with the reference data and removes the blank ones
+    this->fillBinVector( fRefTree, refleafmap, valuesmap, appvector );
+    appvector.erase( std::remove_if( appvector.begin(), appvector.end(), blank ), appvector.end() );
+    for ( auto itb = appvector.begin(); itb != appvector.end(); itb++ )
+      itb->fNentries = 0;
+
+    // Fills the bins with the data to be weighted and removes the blank ones
+    this->fillBinVector( fWgtTree, wgtleafmap, valuesmap, appvector );
+    appvector.erase( std::remove_if( appvector.begin(), appvector.end(), blank ), appvector.end() );
+    for ( auto itb = appvector.begin(); itb != appvector.end(); itb++ )
+      itb->fNentries = 0;
+
+    fRefTree->SetBranchStatus( "*", true );
+    fWgtTree->SetBranchStatus( "*", true );
+
+    // Finally redefines the vector of bins of the class
+    fBinVector = appvector;
+    std::cout << " - Bin-list size:  " << fBinVector.size() << std::endl;
+  }
+
   //_______________________________________________________________________________
   //
   void VarWeighter::fillBinVector( TTree *tree,
 				   std::map<std::string, TLeaf*> &leafmap,
 				   std::map<std::string, double> &valuesmap,
 				   std::vector<VarBin> &binvector ) {
-    
+
+    Strings names;
+    for ( auto it = valuesmap.begin(); it != valuesmap.end(); it++ )
+      names.push_back( it->first );
+    VarBinLocator locator( binvector, names );
+
+    std::vector<TLeaf*> leaves;
+    for ( auto it = names.begin(); it != names.end(); it++ )
+      leaves.push_back( leafmap[ *it ] );
+
+    Doubles values( names.size() );
     for ( Long64_t ievt = 0; ievt < tree->GetEntries(); ievt++ ) {
       tree->GetEntry( ievt );
-      for ( auto it = valuesmap.begin(); it != valuesmap.end(); it++ )
-	it->second = leafmap[ it->first ]->GetValue();
-      for ( auto itb = binvector.begin(); itb != binvector.end(); itb++ )
-	itb->ifInsideAdd( valuesmap );
+      for ( size_t iv = 0; iv < leaves.size(); iv++ )
+	values[ iv ] = leaves[ iv ]->GetValue();
+      size_t ib = locator.find( values.data() );
+      if ( ib != VarBinLocator::NotFound )
+	binvector[ ib ].fNentries++;
     }  
   }
 
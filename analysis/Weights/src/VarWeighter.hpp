@@ -7,7 +7,7 @@
 //  AUTHOR: Miguel Ramos Pernas
 //  e-mail: miguel.ramos.pernas@cern.ch
 //
-//  Last update: 10/04/2017
+//  Last update: 18/10/2026
 //
 // ---------------------------------------------------------------------------------
 //
@@ -25,14 +25,20 @@
 #ifndef VAR_WEIGHTER
 #define VAR_WEIGHTER
 
+#include "AdaptiveBinning1D.hpp"
+#include "AdaptiveBinning2D.hpp"
 #include "Definitions.hpp"
 #include "VarBin.hpp"
+#include "VarBinLocator.hpp"
 
 #include "TBranch.h"
+#include "TH1D.h"
 #include "TLeaf.h"
 #include "TList.h"
 #include "TTree.h"
 
+#include <cstdint>
+#include <string>
 #include <vector>
 
 
@@ -44,10 +50,37 @@ namespace isis {
 
   public:
 
+    // Definition of the histograms of a variable to be made by < makeHistograms >
+    struct HistConfig {
+
+      // Name of the variable
+      std::string variable;
+
+      // Number of bins
+      size_t nbins;
+
+      // Minimum value
+      double min;
+
+      // Maximum value
+      double max;
+    };
+
+    // Number of events read from the trees at once when making histograms
+    static const size_t BlockSize = 4096;
+
+    // Version of the format of the files written by < save >
+    static const uint32_t FileVersion = 1;
+
     // Main constructor. The reference tree and the tree to be weighed have to be
     // passed to the constructor.
     VarWeighter( TTree *rtree, TTree *wtree );
 
+    // Constructor given the path to a file where the state of a weighter has been
+    // saved (see < save >). The class can only be used to apply the weights and
+    // display the bins, since no trees are attached to it.
+    VarWeighter( const std::string &path );
+
     // Destructor
     ~VarWeighter();
 
@@ -62,6 +95,41 @@ namespace isis {
 			const double      &max,
 			const std::string &units = "" );
 
+    // Adds a new variable to this class using the edges of an adaptive binning.
+    // The binning is usually computed on the reference sample, so all the bins
+    // have a similar number of reference entries (see < addAdaptiveVariable >).
+    void addVariable( const std::string       &name,
+			const AdaptiveBinning1D &binning,
+			const std::string       &units = "" );
+
+    // Adds two new variables to this class, splitting them jointly using the bins
+    // of a two-dimensional adaptive binning
+    void addVariables( const std::string       &xname,
+			 const std::string       &yname,
+			 const AdaptiveBinning2D &binning,
+			 const std::string       &xunits = "",
+			 const std::string       &yunits = "" );
+
+    // Adds a new variable with an adaptive binning computed on the reference
+    // sample, where each bin has approximately < occ > entries
+    void addAdaptiveVariable( const std::string &name,
+				const size_t      &occ,
+				const double      &min,
+				const double      &max,
+				const std::string &units = "" );
+
+    // Adds two new variables with a two-dimensional adaptive binning computed on
+    // the reference sample, where each bin has at least < occ > entries
+    void addAdaptiveVariables( const std::string &xname,
+				 const std::string &yname,
+				 const size_t      &occ,
+				 const double      &xmin,
+				 const double      &xmax,
+				 const double      &ymin,
+				 const double      &ymax,
+				 const std::string &xunits = "",
+				 const std::string &yunits = "" );
+
     // Applies the weights to a given tree. Two branches will be added to it: one
     // containing the weights and the other the errors. The type of the branch has
     // also to be specified: D (double), F (float). The maximum allowed relative
@@ -84,9 +152,20 @@ namespace isis {
 			   const double &vmin,
 			   const double &vmax );
 
+    // Returns a list with the histograms for several variables. The trees are read
+    // only once, and the events of each block are processed using < nthreads >
+    // threads (0 uses all the available). The histograms are stored in the same
+    // order as for the single-variable version, for each of the variables.
+    TList* makeHistograms( const std::vector<HistConfig> &configs,
+			   const size_t &nthreads = 0 );
+
     // Displays the map of bins associated to this class
     void display( const size_t &prec = 4 );
 
+    // Saves the state of the class (variables, bins, entries, weights and errors)
+    // in a binary file, so it can be loaded later using the constructor
+    void save( const std::string &path ) const;
+
     // Returns the vector of bins of the class
     inline const std::vector<VarBin>& getBinVector() const;
 
@@ -106,17 +185,37 @@ namespace isis {
 
   private:
 
-    // Fills the output branches. It is important, in the < while > statement to do
-    // not change the order of the conditionals.
+    // Throws an exception if the reference and weighting trees are not attached
+    void checkTrees() const;
+
+    // Reads the values of the given variables from the reference tree
+    std::vector<Doubles> readReference( const Strings &names );
+
+    // Splits the bins of the class in the given boxes, containing the ranges for
+    // the variables in < names >. The blank bins are removed.
+    void splitBins( const Strings &names, const std::vector<VarBin::Ranges> &boxes );
+
+    // Fills the output branches, finding the bin of each event with the given
+    // locator
     template<class type>
     void fill( TTree   *tree,
 	       TBranch *wbranch,
 	       void    *waddress,
 	       TBranch *sbranch,
 	       void    *saddress,
-	       std::map<std::string, double> &valuesmap,
+	       const VarBinLocator &locator,
 	       const std::map<std::string, TLeaf*> &newleafmap );
 
+    // Fills the raw and weighted histograms of the given variables from a tree.
+    // The histograms are filled in groups of four (see < makeHistograms >),
+    // and < reference > determines whether the events of the weighted
+    // histograms are filled with the weight of their bins or with unit weight.
+    void fillHistograms( TTree                         *tree,
+			 const std::vector<HistConfig> &configs,
+			 const std::vector<TH1D*>      &hists,
+			 const bool                    &reference,
+			 const size_t                  &nthreads );
+
     // Fills the bins in a vector given the tree, the map of leaves and the map of
     // values
     void fillBinVector( TTree *tree,
@@ -147,24 +246,23 @@ namespace isis {
 			  void    *waddress,
 			  TBranch *sbranch,
 			  void    *saddress,
-			  std::map<std::string, double> &valuesmap,
+			  const VarBinLocator &locator,
 			  const std::map<std::string, TLeaf*> &newleafmap ) {
     
-    std::vector<VarBin>::iterator itw;
+    Doubles values( newleafmap.size() );
     for ( Long64_t ievt = 0; ievt < tree->GetEntries(); ievt++ ) {
       tree->GetEntry( ievt );
-      for ( auto it = valuesmap.begin(); it != valuesmap.end(); it++ )
-	it->second = newleafmap.at( it->first )->GetValue();
-      itw = fBinVector.begin();
-      while ( itw != fBinVector.end() && itw->isOutside( valuesmap ) )
-	itw++;
-      if ( itw == fBinVector.end() ) {
+      auto itv = values.begin();
+      for ( auto it = newleafmap.begin(); it != newleafmap.end(); it++ )
+	*itv++ = it->second->GetValue();
+      size_t ib = locator.find( values.data() );
+      if ( ib == VarBinLocator::NotFound ) {
 	*static_cast<type>( waddress ) = 0;
 	*static_cast<type>( saddress ) = 0;
       }
       else {
-	*static_cast<type>( waddress ) = itw->getWeight();
-	*static_cast<type>( saddress ) = itw->getError();
+	*static_cast<type>( waddress ) = fBinVector[ ib ].getWeight();
+	*static_cast<type>( saddress ) = fBinVector[ ib ].getError();
       }
       wbranch->Fill();
       sbranch->Fill();
@@ -0,0 +1,166 @@
+////////////////////////////////////////////////////////////////
+//  Validation and throughput of the native Poisson sampler  //
+////////////////////////////////////////////////////////////////
+
+#include "Definitions.hpp"
+#include "PoissonSampler.hpp"
+#include "RandomEngine.hpp"
+
+#include "TMath.h"
+#include "TRandom3.h"
+
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+
+// Maximum number of standard deviations allowed between the mean and the
+// variance of the generated values and those of the Poisson distribution
+const double MaxPull = 5;
+
+// Minimum chi-square probability allowed for the distribution of the values
+const double MinProb = 1e-6;
+
+// Return the chi-square and the number of degrees of freedom of the comparison
+// between the observed frequencies and the expected from the Poisson
+// distribution. Only bins with more than 20 expected entries are considered.
+double chi2Test( const std::map<double, double> &freqs,
+		 const double &mean,
+		 const size_t &n,
+		 size_t &ndf ) {
+
+  double chi2 = 0;
+
+  size_t nbins = 0;
+  for ( auto it = freqs.begin(); it != freqs.end(); ++it ) {
+
+    double e = n*TMath::Poisson( it -> first, mean );
+
+    if ( e > 20 ) {
+      chi2 += ( it -> second - e )*( it -> second - e )/e;
+      ++nbins;
+    }
+  }
+
+  // The normalization is fixed by the number of toys
+  ndf = nbins ? nbins - 1 : 0;
+
+  return chi2;
+}
+
+// Check the values of the channel < ch > with the given mean, printing the
+// results. Returns whether they are compatible with the Poisson distribution.
+bool check( const std::string &name,
+	    const isis::Doubles &values,
+	    const size_t &ch,
+	    const size_t &nch,
+	    const double &mean ) {
+
+  const size_t n = values.size()/nch;
+
+  std::map<double, double> freqs;
+  double sum = 0, sum2 = 0;
+
+  for ( size_t i = 0; i < n; ++i ) {
+
+    double v = values[ i*nch + ch ];
+
+    freqs[ v ] += 1;
+
+    sum  += v;
+    sum2 += v*v;
+  }
+
+  const double m = sum/n;
+  const double v = sum2/n - m*m;
+
+  // Standard deviations of the mean and of the variance of a Poisson
+  // distribution
+  const double smean = std::sqrt( mean/n );
+  const double svar  = std::sqrt( ( mean + 2*mean*mean )/n );
+
+  size_t ndf;
+  const double chi2 = chi2Test( freqs, mean, n, ndf );
+  const double prob = ndf ? TMath::Prob( chi2, ndf ) : 1;
+
+  const bool ok =
+    std::abs( m - mean ) <= MaxPull*smean &&
+    std::abs( v - mean ) <= MaxPull*svar &&
+    prob >= MinProb;
+
+  std::cout << std::setw( 10 ) << name
+	    << std::setw( 8 ) << mean
+	    << std::setw( 14 ) << m
+	    << std::setw( 14 ) << v
+	    << std::setw( 20 ) << std::to_string( chi2 ) + "/" + std::to_string( ndf )
+	    << std::setw( 14 ) << prob
+	    << std::setw( 6 ) << ( ok ? "OK" : "FAIL" )
+	    << std::endl;
+
+  return ok;
+}
+
+int main() {
+
+  // Number of toys and means of the channels
+  const size_t  ntoys = 1000000;
+  isis::Doubles means = { 0.01, 0.5, 2, 7.5, 10, 30, 100, 1000 };
+
+  const size_t nch = means.size();
+
+  // Generates the toys with the sampler, both by blocks and toy by toy, and
+  // with TRandom3
+  isis::PoissonSampler sampler( means );
+  isis::RandomEngine   engine( 1 );
+  TRandom3             rndm( 1 );
+
+  isis::Doubles block( ntoys*nch ), single( ntoys*nch ), root( ntoys*nch );
+
+  auto start = std::chrono::steady_clock::now();
+
+  sampler.fill( engine, ntoys, block.data() );
+
+  auto mid = std::chrono::steady_clock::now();
+
+  for ( size_t i = 0; i < ntoys; ++i )
+    sampler.fill( engine, &single[ i*nch ] );
+
+  auto end = std::chrono::steady_clock::now();
+
+  for ( size_t i = 0; i < ntoys; ++i )
+    for ( size_t j = 0; j < nch; ++j )
+      root[ i*nch + j ] = rndm.Poisson( means[ j ] );
+
+  auto last = std::chrono::steady_clock::now();
+
+  // Compares the distributions of each channel
+  std::cout << std::setw( 10 ) << "Method" << std::setw( 8 ) << "Mean"
+	    << std::setw( 14 ) << "Mean (gen)" << std::setw( 14 ) << "Var (gen)"
+	    << std::setw( 20 ) << "chi2/ndf" << std::setw( 14 ) << "Prob"
+	    << std::endl;
+
+  bool ok = true;
+  for ( size_t j = 0; j < nch; ++j ) {
+    ok &= check( "Block", block, j, nch, means[ j ] );
+    ok &= check( "Single", single, j, nch, means[ j ] );
+    check( "TRandom3", root, j, nch, means[ j ] );
+  }
+
+  // Throughput of the methods
+  double tblock  = std::chrono::duration<double>( mid - start ).count();
+  double tsingle = std::chrono::duration<double>( end - mid ).count();
+  double troot   = std::chrono::duration<double>( last - end ).count();
+
+  std::cout << "Values per second (block)   : " << ntoys*nch/tblock << std::endl;
+  std::cout << "Values per second (single)  : " << ntoys*nch/tsingle << std::endl;
+  std::cout << "Values per second (TRandom3): " << ntoys*nch/troot << std::endl;
+
+  if ( !ok ) {
+    std::cerr << "ERROR: The sampler does not reproduce the Poisson distribution" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
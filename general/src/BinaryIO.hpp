@@ -0,0 +1,129 @@
+////////////////////////////////////////////////////////////////////////////
+//
+//  General package
+//
+// -------------------------------------------------------------------------
+//
+//  AUTHOR: Miguel Ramos Pernas
+//  e-mail: miguel.ramos.pernas@cern.ch
+//
+//  Last update: 18/10/2026
+//
+// -------------------------------------------------------------------------
+//
+//  Description:
+//
+//  Define functions to write and read objects to/from binary streams. The
+//  values are stored with the native representation, so the files are
+//  meant to be read in machines with the same architecture. Strings and
+//  vectors are preceded by their length.
+//
+// -------------------------------------------------------------------------
+////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef BINARY_IO_H
+#define BINARY_IO_H
+
+#include "Exceptions.hpp"
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+
+//________________________________________________________________________
+
+namespace isis {
+
+  namespace binio {
+
+    //______________________________________________________________________
+    // Write a value of a trivial type
+    template<class type>
+    inline void write( std::ostream &os, const type &value ) {
+
+      os.write(reinterpret_cast<const char*>(&value), sizeof(type));
+    }
+
+    //______________________________________________________________________
+    // Write a string
+    inline void write( std::ostream &os, const std::string &str ) {
+
+      write(os, uint64_t(str.size()));
+      os.write(str.data(), str.size());
+    }
+
+    //______________________________________________________________________
+    // Write a vector of values of a trivial type
+    template<class type>
+    inline void write( std::ostream &os, const std::vector<type> &vec ) {
+
+      write(os, uint64_t(vec.size()));
+      os.write(reinterpret_cast<const char*>(vec.data()), vec.size()*sizeof(type));
+    }
+
+    //______________________________________________________________________
+    // Read a value of a trivial type
+    template<class type>
+    inline void read( std::istream &is, type &value ) {
+
+      if ( !is.read(reinterpret_cast<char*>(&value), sizeof(type)) )
+	throw BaseException("Unexpected end of binary stream");
+    }
+
+    //______________________________________________________________________
+    // Read a string
+    inline void read( std::istream &is, std::string &str ) {
+
+      uint64_t n;
+      read(is, n);
+      str.resize(n);
+      if ( n && !is.read(&str[0], n) )
+	throw BaseException("Unexpected end of binary stream");
+    }
+
+    //______________________________________________________________________
+    // Read a vector of values of a trivial type
+    template<class type>
+    inline void read( std::istream &is, std::vector<type> &vec ) {
+
+      uint64_t n;
+      read(is, n);
+      vec.resize(n);
+      if ( n && !is.read(reinterpret_cast<char*>(vec.data()), n*sizeof(type)) )
+	throw BaseException("Unexpected end of binary stream");
+    }
+
+    //______________________________________________________________________
+    // Write the header of a file, given an identifier (written without its
+    // length) and the version
+    inline void writeHeader( std::ostream &os,
+			     const std::string &id,
+			     const uint32_t &version ) {
+
+      os.write(id.data(), id.size());
+      write(os, version);
+    }
+
+    //______________________________________________________________________
+    // Read the header of a file, checking that the identifier matches the
+    // expected one. Returns the version.
+    inline uint32_t readHeader( std::istream &is, const std::string &id ) {
+
+      std::string fid(id.size(), '\0');
+      uint32_t version;
+
+      if ( !is.read(&fid[0], fid.size()) || fid != id )
+	throw BaseException("Wrong file type; expected \"" + id + "\"");
+
+      read(is, version);
+
+      return version;
+    }
+  }
+
+}
+
+#endif
@@ -0,0 +1,89 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+//  General package
+//
+// -----------------------------------------------------------------------------
+//
+//  AUTHOR: Miguel Ramos Pernas
+//  e-mail: miguel.ramos.pernas@cern.ch
+//
+//  Last update: 18/10/2026
+//
+// -----------------------------------------------------------------------------
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include "BufferArena.hpp"
+
+#include <cstdint>
+
+
+//_______________________________________________________________________________
+
+namespace isis {
+
+  //_______________________________________________________________________________
+  //
+  BufferArena::BufferArena( const size_t &blockSize ) :
+    fBlockSize( blockSize ), fUsed( 0 ), fSize( 0 ) { }
+
+  //_______________________________________________________________________________
+  //
+  BufferArena::~BufferArena() { this->clear(); }
+
+  //_______________________________________________________________________________
+  //
+  void* BufferArena::allocate() {
+
+    if ( fBlocks.empty() || fUsed == fBlocks.back().size )
+      this->newBlock( fBlockSize );
+
+    Slot *slot = fBlocks.back().slots + fUsed;
+    *slot = 0;
+
+    ++fUsed;
+    ++fSize;
+
+    return slot;
+  }
+
+  //_______________________________________________________________________________
+  //
+  void BufferArena::clear() {
+
+    for ( auto it = fBlocks.begin(); it != fBlocks.end(); ++it )
+      delete [] it->memory;
+
+    fBlocks.clear();
+
+    fUsed = 0;
+    fSize = 0;
+  }
+
+  //_______________________________________________________________________________
+  //
+  void BufferArena::reserve( const size_t &n ) {
+
+    if ( fBlocks.empty() || fBlocks.back().size - fUsed < n )
+      this->newBlock( n > fBlockSize ? n : fBlockSize );
+  }
+
+  //_______________________________________________________________________________
+  //
+  void BufferArena::newBlock( const size_t &n ) {
+
+    Block block;
+
+    block.memory = new char[ n*sizeof(Slot) + Alignment ];
+    block.size   = n;
+
+    // The first slot is placed at the next aligned address
+    const uintptr_t addr = reinterpret_cast<uintptr_t>(block.memory);
+    block.slots = reinterpret_cast<Slot*>((addr + Alignment - 1) & ~(Alignment - 1));
+
+    fBlocks.push_back( block );
+
+    fUsed = 0;
+  }
+
+}
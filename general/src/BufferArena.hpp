@@ -0,0 +1,109 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+//  General package
+//
+// -----------------------------------------------------------------------------
+//
+//  AUTHOR: Miguel Ramos Pernas
+//  e-mail: miguel.ramos.pernas@cern.ch
+//
+//  Last update: 18/10/2026
+//
+// -----------------------------------------------------------------------------
+//
+//  Description:
+//
+//  Definition of the class to provide the storage of the values of the
+//  buffer arrays. The values are placed in consecutive slots, which can hold
+//  any of the types defined in < ValueTypeDef.hpp >. The memory is reserved
+//  in blocks aligned to the cache lines, so the addresses given by the arena
+//  remain valid until it is cleared. If the number of values is known in
+//  advance, it can be reserved so they are placed in a single block.
+//
+// -----------------------------------------------------------------------------
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef BUFFER_ARENA
+#define BUFFER_ARENA
+
+#include "ValueTypeDef.hpp"
+
+#include <cstddef>
+#include <vector>
+
+
+//_______________________________________________________________________________
+
+namespace isis {
+
+  class BufferArena {
+
+  public:
+
+    // Type of the slots, whose size and alignment are enough to store any of
+    // the types in < ValueTypeDef.hpp >
+    typedef ullInt Slot;
+
+    // Constructor given the number of slots in each block
+    BufferArena( const size_t &blockSize = 512 );
+
+    // The arena can not be copied, since the addresses would be shared
+    BufferArena( const BufferArena &other ) = delete;
+
+    // Destructor
+    ~BufferArena();
+
+    // Returns the address of a new slot, initialized to zero
+    void* allocate();
+
+    // Removes all the slots. The addresses given previously become invalid.
+    void clear();
+
+    // Makes sure that the next < n > slots are placed consecutively in memory
+    void reserve( const size_t &n );
+
+    // Returns the number of slots in use
+    inline size_t getSize() const;
+
+    // The arena can not be copied, since the addresses would be shared
+    BufferArena& operator = ( const BufferArena &other ) = delete;
+
+  protected:
+
+    // Alignment of the blocks (in bytes)
+    static const size_t Alignment = 64;
+
+    // Block of memory, where < memory > is the address to release
+    struct Block {
+      char  *memory;
+      Slot  *slots;
+      size_t size;
+    };
+
+    // Blocks of memory
+    std::vector<Block> fBlocks;
+
+    // Minimum number of slots in each block
+    size_t fBlockSize;
+
+    // Number of slots in use in the last block
+    size_t fUsed;
+
+    // Number of slots in use
+    size_t fSize;
+
+  private:
+
+    // Creates a new block with the given number of slots
+    void newBlock( const size_t &n );
+
+  };
+
+  //_______________________________________________________________________________
+  //
+  inline size_t BufferArena::getSize() const { return fSize; }
+
+}
+
+#endif
@@ -7,7 +7,7 @@
 //  AUTHOR: Miguel Ramos Pernas
 //  e-mail: miguel.ramos.pernas@cern.ch
 //
-//  Last update: 19/10/2017
+//  Last update: 18/10/2026
 //
 // -----------------------------------------------------------------------------
 ////////////////////////////////////////////////////////////////////////////////
@@ -17,6 +17,7 @@
 #include "Exceptions.hpp"
 #include "BufferArray.hpp"
 
+#include <cstring>
 #include <iostream>
 
 
@@ -28,9 +29,19 @@ namespace isis {
   //
   BufferArray::BufferArray( const BufferArray &other ) :
     fVarMap( other.fVarMap ) {
+
+    fArena.reserve( fVarMap.size() );
   
-    for ( auto it = fVarMap.begin(); it != fVarMap.end(); ++it )
-      it->second = new BuffVar( it->second->getType() );
+    for ( auto it = fVarMap.begin(); it != fVarMap.end(); ++it ) {
+
+      void *path = fArena.allocate();
+      std::memcpy( path, it->second->pathToValue(), sizeof(BufferArena::Slot) );
+
+      fVariables.emplace_back( it->second->getType(), path );
+      it->second = &fVariables.back();
+    }
+
+    this->buildIndex();
   }
 
   //_______________________________________________________________________________
@@ -41,27 +52,35 @@ namespace isis {
 
   //_______________________________________________________________________________
   //
-  BufferArray::~BufferArray() {
-
-    for ( auto it = fVarMap.begin(); it != fVarMap.end(); ++it )
-      delete it->second;
-  }
+  BufferArray::~BufferArray() { }
 
   //_______________________________________________________________________________
   //
   BufferVariable* BufferArray::addVariable( const std::string &name,
 					    const char &type ) {
 
-    if ( fVarMap.count( name ) )
+    if ( fIndex.find( name ) )
       throw BaseException("Variable with name \"" + name + "\" already booked");
     else {
-      BufferVariable *var = new BuffVar( type );
-      fVarMap[ name ] = var;
+      fVariables.emplace_back( type, fArena.allocate() );
+      BufferVariable *var = &fVariables.back();
+      auto it = fVarMap.insert( std::make_pair( name, var ) ).first;
+      fIndex.insert( it->first, var );
       return var;
     }
     return 0;
   }
 
+  //_______________________________________________________________________________
+  //
+  void BufferArray::buildIndex() {
+
+    fIndex.clear();
+
+    for ( auto it = fVarMap.begin(); it != fVarMap.end(); ++it )
+      fIndex.insert( it->first, it->second );
+  }
+
   //_______________________________________________________________________________
   //
   void BufferArray::extractNames( Strings &names ) {
@@ -7,7 +7,7 @@
 //  AUTHOR: Miguel Ramos Pernas
 //  e-mail: miguel.ramos.pernas@cern.ch
 //
-//  Last update: 10/04/2017
+//  Last update: 18/10/2026
 //
 // -----------------------------------------------------------------------------
 //
@@ -19,7 +19,13 @@
 //  variables since the class BufferVariable does not support a copy
 //  constructor. In order to modify them, one must use the operator. To add a
 //  new variable, one must use the method < AddVariable >, specifying the
-//  name and the type.
+//  name and the type. The variables and their values are stored consecutively
+//  in containers owned by the array, so no memory is allocated for each of
+//  them, and their addresses remain valid until the array is cleared. If the
+//  type of a variable is known at compile time, a < TypedBuffer > handle can
+//  be requested to access its value directly. The variables are iterated
+//  following the order of the map, while the access by name is done through
+//  a hash index.
 //
 // -----------------------------------------------------------------------------
 ////////////////////////////////////////////////////////////////////////////////
@@ -28,10 +34,17 @@
 #ifndef BUFFER_ARRAY
 #define BUFFER_ARRAY
 
+#include "BufferArena.hpp"
+#include "BufferIndex.hpp"
 #include "BufferVariable.hpp"
 #include "Definitions.hpp"
+#include "Exceptions.hpp"
+#include "TypedBuffer.hpp"
+#include "ValueTypeDef.hpp"
 
+#include <deque>
 #include <map>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -49,8 +62,8 @@ namespace isis {
     typedef bool (*SortFunc)( const std::string &stra, const std::string &strb );
     typedef std::map<std::string, BuffVar*, SortFunc> BuffVarMap;
     
-    // Copy constructor. Memory will be allocated to generate new variables. The
-    // allocated memory is independent for each array.
+    // Copy constructor. The variables and their values are copied to a single
+    // block of memory, independent for each array.
     BufferArray( const BufferArray &other );
     
     // Main constructor, given the ordering function to follow. By default, the
@@ -72,14 +85,28 @@ namespace isis {
     std::string toString() const;
     
     // Removes the variables booked in this class
-    inline void clear();
+    inline virtual void clear();
+
+    // Reserves memory so the values of the next < n > variables are placed
+    // consecutively
+    inline void reserve( const size_t &n );
 
     // Checks whether the given variable is already booked  
     inline bool contains( const std::string &name ) const;
 
-    // Returns the variable related to the name given
+    // Returns the variable related to the name given. If it is not booked, an
+    // std::out_of_range exception is thrown (IndexError in python).
     inline const BuffVar& get( const std::string &name ) const;
 
+    // Returns the variable related to the name given, or null if it is not
+    // booked
+    inline BuffVar* find( const std::string &name ) const;
+
+    // Returns the handle to access the value of the given variable. An
+    // exception is thrown if its type does not correspond to that requested.
+    template<class type>
+    inline TypedBuffer<type> getBuffer( const std::string &name );
+
     // Returns the map containing all the variables
     inline const BuffVarMap& getMap() const;
 
@@ -89,34 +116,79 @@ namespace isis {
     // Reconstructs the map following the given sort function    
     inline void sort( SortFunc func );
     
-    // Operator to get a variable by index
+    // Operator to get a variable by index. It throws as < get > if the variable
+    // is not booked.
     inline BuffVar& operator [] ( const std::string &name );
     
   protected:
     
+    // Arena storing the values of the variables
+    BufferArena fArena;
+
+    // Variables booked in the array
+    std::deque<BuffVar> fVariables;
+
     // Map containing the variables
     BuffVarMap fVarMap;
+
+    // Index to access the variables by name
+    BufferIndex fIndex;
+
+  private:
+
+    // Builds the index from the map of variables
+    void buildIndex();
     
   };
   
   //_______________________________________________________________________________
   //
   inline void BufferArray::clear() {
-    for ( auto it = fVarMap.begin(); it != fVarMap.end(); ++it )
-      delete it->second;
+    fIndex.clear();
     fVarMap.clear();
+    fVariables.clear();
+    fArena.clear();
   }
 
+  //_______________________________________________________________________________
+  //
+  inline void BufferArray::reserve( const size_t &n ) { fArena.reserve( n ); }
+
   //_______________________________________________________________________________
   //
   inline bool BufferArray::contains( const std::string &name ) const {
-    return fVarMap.count( name );
+    return fIndex.find( name );
+  }
+
+  //_______________________________________________________________________________
+  //
+  inline BufferArray::BuffVar* BufferArray::find( const std::string &name ) const {
+    return fIndex.find( name );
   }
 
   //_______________________________________________________________________________
   //
   inline const BufferArray::BuffVar& BufferArray::get( const std::string &name ) const {
-    return *(fVarMap.at( name ));
+
+    BuffVar *var = fIndex.find( name );
+    if ( !var )
+      throw std::out_of_range("Unable to find variable \"" + name + "\"");
+
+    return *var;
+  }
+
+  //_______________________________________________________________________________
+  //
+  template<class type>
+  inline TypedBuffer<type> BufferArray::getBuffer( const std::string &name ) {
+
+    BuffVar &var = (*this)[ name ];
+
+    if ( var.getType() != typeCode<type>() )
+      throw BaseException("Variable with name \"" + name +
+			  "\" does not have type < " + typeCode<type>() + " >");
+
+    return TypedBuffer<type>( static_cast<type*>(var.pathToValue()) );
   }
 
   //_______________________________________________________________________________
@@ -133,12 +205,18 @@ namespace isis {
   //
   inline void BufferArray::sort( SortFunc func ) {
     fVarMap = BufferArray::BuffVarMap( fVarMap.begin(), fVarMap.end(), func );
+    this->buildIndex();
   }
 
   //_______________________________________________________________________________
   //
   inline BufferVariable& BufferArray::operator [] ( const std::string &name ) {
-    return *(fVarMap.at( name ));
+
+    BuffVar *var = fIndex.find( name );
+    if ( !var )
+      throw std::out_of_range("Unable to find variable \"" + name + "\"");
+
+    return *var;
   }
 
 }
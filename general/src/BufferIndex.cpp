@@ -0,0 +1,68 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+//  General package
+//
+// -----------------------------------------------------------------------------
+//
+//  AUTHOR: Miguel Ramos Pernas
+//  e-mail: miguel.ramos.pernas@cern.ch
+//
+//  Last update: 18/10/2026
+//
+// -----------------------------------------------------------------------------
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include "BufferIndex.hpp"
+
+
+//_______________________________________________________________________________
+
+namespace isis {
+
+  //_______________________________________________________________________________
+  //
+  BufferIndex::BufferIndex() : fSize( 0 ) { }
+
+  //_______________________________________________________________________________
+  //
+  BufferIndex::~BufferIndex() { }
+
+  //_______________________________________________________________________________
+  //
+  void BufferIndex::clear() {
+
+    fEntries.clear();
+    fSize = 0;
+  }
+
+  //_______________________________________________________________________________
+  //
+  void BufferIndex::insert( const std::string &name, BufferVariable *var ) {
+
+    // The table is kept at most half full, so the probing sequences are short
+    if ( 2*(fSize + 1) > fEntries.size() ) {
+
+      std::vector<Entry> entries( fEntries.empty() ? 16 : 2*fEntries.size(),
+				  Entry{0, 0, 0} );
+      entries.swap( fEntries );
+
+      fSize = 0;
+      for ( auto it = entries.begin(); it != entries.end(); ++it )
+	if ( it->var )
+	  this->insert( *it->name, it->var );
+    }
+
+    const size_t hash = std::hash<std::string>()( name );
+    const size_t mask = fEntries.size() - 1;
+
+    size_t i = hash & mask;
+    while ( fEntries[ i ].var )
+      i = (i + 1) & mask;
+
+    fEntries[ i ] = Entry{hash, &name, var};
+
+    ++fSize;
+  }
+
+}
@@ -0,0 +1,99 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+//  General package
+//
+// -----------------------------------------------------------------------------
+//
+//  AUTHOR: Miguel Ramos Pernas
+//  e-mail: miguel.ramos.pernas@cern.ch
+//
+//  Last update: 18/10/2026
+//
+// -----------------------------------------------------------------------------
+//
+//  Description:
+//
+//  Definition of the index to access the variables of a buffer array by name
+//  in constant time. It is a flat hash table with open addressing and linear
+//  probing. The names are not copied, so they must remain valid while they
+//  are in the index.
+//
+// -----------------------------------------------------------------------------
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef BUFFER_INDEX
+#define BUFFER_INDEX
+
+#include "BufferVariable.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+
+//_______________________________________________________________________________
+
+namespace isis {
+
+  class BufferIndex {
+
+  public:
+
+    // Main constructor
+    BufferIndex();
+
+    // Destructor
+    ~BufferIndex();
+
+    // Removes all the entries
+    void clear();
+
+    // Adds a new entry. The name must not be in the index already.
+    void insert( const std::string &name, BufferVariable *var );
+
+    // Returns the variable with the given name, or null if it is not found
+    inline BufferVariable* find( const std::string &name ) const;
+
+  protected:
+
+    // Entry of the table. An empty entry has a null variable.
+    struct Entry {
+      size_t             hash;
+      const std::string *name;
+      BufferVariable    *var;
+    };
+
+    // Table of entries, whose size is a power of two
+    std::vector<Entry> fEntries;
+
+    // Number of entries in use
+    size_t fSize;
+
+  };
+
+  //_______________________________________________________________________________
+  //
+  inline BufferVariable* BufferIndex::find( const std::string &name ) const {
+
+    if ( fEntries.empty() )
+      return 0;
+
+    const size_t hash = std::hash<std::string>()( name );
+    const size_t mask = fEntries.size() - 1;
+
+    for ( size_t i = hash & mask; fEntries[ i ].var; i = (i + 1) & mask ) {
+
+      const Entry &entry = fEntries[ i ];
+
+      if ( entry.hash == hash && *entry.name == name )
+	return entry.var;
+    }
+
+    return 0;
+  }
+
+}
+
+#endif
@@ -7,7 +7,7 @@
 //  AUTHOR: Miguel Ramos Pernas
 //  e-mail: miguel.ramos.pernas@cern.ch
 //
-//  Last update: 10/04/2017
+//  Last update: 18/10/2026
 //
 // -------------------------------------------------------------------------------
 //////////////////////////////////////////////////////////////////////////////////
@@ -25,10 +25,16 @@ namespace isis {
 
   //_______________________________________________________________________________
   //
-  BufferVariable::BufferVariable( const char &type ) : fType( type ) {
+  BufferVariable::BufferVariable( const char &type ) :
+    fType( type ), fPath( 0 ), fOwner( true ) {
     this->construct();
   }
 
+  //_______________________________________________________________________________
+  //
+  BufferVariable::BufferVariable( const char &type, void *path ) :
+    fType( type ), fPath( path ), fOwner( false ) { }
+
   //_______________________________________________________________________________
   //
   BufferVariable::~BufferVariable() { this->clear(); }
@@ -49,7 +55,7 @@ namespace isis {
   //
   void BufferVariable::construct() {
 
-    if ( fType != '\0' )
+    if ( fOwner && fType != '\0' )
       I_SWITCH_BY_DATA_TYPE(fType, fPath, I_NEW_INSTANCE,
 			  
 			    IError << "Unknown type for buffer variable < "
@@ -61,7 +67,7 @@ namespace isis {
   //
   void BufferVariable::clear() {
 
-    if ( fType != '\0' )
+    if ( fOwner && fType != '\0' )
       I_SWITCH_BY_DATA_TYPE(fType, fPath, I_DELETE_PTR, NOOP);
   }
 
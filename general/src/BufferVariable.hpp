@@ -7,7 +7,7 @@
 //  AUTHOR: Miguel Ramos Pernas
 //  e-mail: miguel.ramos.pernas@cern.ch
 //
-//  Last update: 19/10/2017
+//  Last update: 18/10/2026
 //
 // -------------------------------------------------------------------------------
 //
@@ -16,7 +16,8 @@
 //  Main class to store any kind of primitive data types. Different objects of
 //  this type can be stored in the same container, while refering to different
 //  data types. It results very useful when dealing with buffers were each
-//  variable has a different type.
+//  variable has a different type. The value can be stored in memory owned by
+//  the class or at an external address, provided by the user.
 //
 // -------------------------------------------------------------------------------
 //////////////////////////////////////////////////////////////////////////////////
@@ -43,6 +44,11 @@ namespace isis {
     // Constructor given the type as a character
     BufferVariable( const char &type = '\0' );
 
+    // Constructor given the type and the address where to store the value. The
+    // memory must be able to hold any of the types in < ValueTypeDef.hpp >,
+    // and is not released by this class.
+    BufferVariable( const char &type, void *path );
+
     // Destructor
     ~BufferVariable();
 
@@ -75,6 +81,9 @@ namespace isis {
     // Pointer to the variable stored
     void *fPath;
 
+    // Whether the memory of the value is owned by this class
+    bool fOwner;
+
   private:
     
     // Method to construct this class, given the type
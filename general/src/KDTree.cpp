@@ -0,0 +1,190 @@
+///////////////////////////////////////////////////////////
+//
+//  General package
+//
+// --------------------------------------------------------
+//
+//  AUTHOR: Miguel Ramos Pernas
+//  e-mail: miguel.ramos.pernas@cern.ch
+//
+//  Last update: 18/10/2026
+//
+// --------------------------------------------------------
+///////////////////////////////////////////////////////////
+
+
+#include "Exceptions.hpp"
+#include "KDTree.hpp"
+
+#include <algorithm>
+#include <limits>
+
+
+//_______________________________________________________________________________
+
+namespace isis {
+
+  //_______________________________________________________________________________
+  //
+  KDTree::KDTree( const Doubles &points, const size_t &ndim, const size_t &leafsize ) :
+    fLeafSize( leafsize ? leafsize : 1 ), fNdim( ndim ) {
+
+    if ( !ndim || points.size() % ndim )
+      throw BaseException("The number of values does not correspond to a set of "
+			  "points with " + std::to_string(ndim) + " dimensions");
+
+    const size_t npoints = points.size()/ndim;
+
+    fIndices.resize( npoints );
+    for ( size_t i = 0; i < npoints; ++i )
+      fIndices[ i ] = i;
+
+    fNodes.reserve( 2*( npoints/fLeafSize + 1 ) );
+    this->build( points, 0, npoints );
+
+    // The points are copied following the order of the leaves
+    fPoints.resize( points.size() );
+    for ( size_t i = 0; i < npoints; ++i )
+      std::copy( points.begin() + fIndices[ i ]*ndim,
+		 points.begin() + ( fIndices[ i ] + 1 )*ndim,
+		 fPoints.begin() + i*ndim );
+  }
+
+  //_______________________________________________________________________________
+  //
+  KDTree::~KDTree() { }
+
+  //_______________________________________________________________________________
+  //
+  void KDTree::nearest( const double *point,
+			const size_t &k,
+			Sizes        &indices,
+			Doubles      &distances ) const {
+
+    std::vector<Candidate> heap;
+    heap.reserve( k + 1 );
+
+    if ( k && !fNodes.empty() )
+      this->search( 0, point, k, heap );
+
+    std::sort_heap( heap.begin(), heap.end() );
+
+    indices.resize( heap.size() );
+    distances.resize( heap.size() );
+    for ( size_t i = 0; i < heap.size(); ++i ) {
+      distances[ i ] = heap[ i ].first;
+      indices[ i ]   = fIndices[ heap[ i ].second ];
+    }
+  }
+
+  //_______________________________________________________________________________
+  //
+  size_t KDTree::build( const Doubles &points, const size_t &first, const size_t &last ) {
+
+    const size_t inode = fNodes.size();
+
+    Node node;
+    node.first = first;
+    node.last  = last;
+    node.dim   = 0;
+    node.split = 0;
+    node.left  = 0;
+    node.right = 0;
+    fNodes.push_back( node );
+
+    if ( last - first <= fLeafSize )
+      return inode;
+
+    // The node is divided in the dimension with the largest spread
+    double spread = -1;
+    for ( size_t id = 0; id < fNdim; ++id ) {
+
+      double
+	vmin = std::numeric_limits<double>::max(),
+	vmax = std::numeric_limits<double>::lowest();
+      for ( size_t i = first; i < last; ++i ) {
+	const double &v = points[ fIndices[ i ]*fNdim + id ];
+	vmin = std::min( vmin, v );
+	vmax = std::max( vmax, v );
+      }
+
+      if ( vmax - vmin > spread ) {
+	spread = vmax - vmin;
+	node.dim = id;
+      }
+    }
+
+    // All the points are equal
+    if ( spread <= 0 )
+      return inode;
+
+    const size_t mid = first + ( last - first )/2;
+    const size_t dim = node.dim;
+
+    std::nth_element( fIndices.begin() + first,
+		      fIndices.begin() + mid,
+		      fIndices.begin() + last,
+		      [&points, this, dim] ( const size_t &a, const size_t &b ) {
+			return points[ a*fNdim + dim ] < points[ b*fNdim + dim ];
+		      } );
+
+    node.split = points[ fIndices[ mid ]*fNdim + dim ];
+
+    // The vector of nodes might be reallocated while building the children
+    node.left  = this->build( points, first, mid );
+    node.right = this->build( points, mid, last );
+
+    fNodes[ inode ] = node;
+
+    return inode;
+  }
+
+  //_______________________________________________________________________________
+  //
+  void KDTree::search( const size_t &inode,
+		       const double *point,
+		       const size_t &k,
+		       std::vector<Candidate> &heap ) const {
+
+    const Node &node = fNodes[ inode ];
+
+    if ( !node.left ) {
+
+      for ( size_t i = node.first; i < node.last; ++i ) {
+
+	const double *p = &fPoints[ i*fNdim ];
+
+	double d2 = 0;
+	for ( size_t id = 0; id < fNdim; ++id ) {
+	  const double d = p[ id ] - point[ id ];
+	  d2 += d*d;
+	}
+
+	if ( heap.size() < k ) {
+	  heap.push_back( Candidate( d2, i ) );
+	  std::push_heap( heap.begin(), heap.end() );
+	}
+	else if ( d2 < heap.front().first ) {
+	  std::pop_heap( heap.begin(), heap.end() );
+	  heap.back() = Candidate( d2, i );
+	  std::push_heap( heap.begin(), heap.end() );
+	}
+      }
+
+      return;
+    }
+
+    // Visits first the child containing the point
+    const double diff = point[ node.dim ] - node.split;
+
+    const size_t
+      near = diff < 0 ? node.left : node.right,
+      far  = diff < 0 ? node.right : node.left;
+
+    this->search( near, point, k, heap );
+
+    if ( heap.size() < k || diff*diff < heap.front().first )
+      this->search( far, point, k, heap );
+  }
+
+}
@@ -0,0 +1,134 @@
+///////////////////////////////////////////////////////////
+//
+//  General package
+//
+// --------------------------------------------------------
+//
+//  AUTHOR: Miguel Ramos Pernas
+//  e-mail: miguel.ramos.pernas@cern.ch
+//
+//  Last update: 18/10/2026
+//
+// --------------------------------------------------------
+//
+//  Description:
+//
+//  Implements a KD-tree to search the nearest neighbours
+//  of a point in a set of points in N dimensions. The
+//  points are given as a flat array (one point after the
+//  other) and copied into the class, sorted following
+//  the order of the leaves, so the searches are done
+//  over contiguous memory. Once built, the tree is never
+//  modified, so it can be queried from several threads.
+//
+// --------------------------------------------------------
+///////////////////////////////////////////////////////////
+
+
+#ifndef KD_TREE_H
+#define KD_TREE_H
+
+#include "Definitions.hpp"
+
+#include <utility>
+#include <vector>
+
+
+//_______________________________________________________________________________
+
+namespace isis {
+
+  class KDTree {
+
+  public:
+
+    // Main constructor. The values of the points are given in a flat array, with
+    // < ndim > values for each point. Nodes with less than < leafsize > points
+    // are not divided.
+    KDTree( const Doubles &points, const size_t &ndim, const size_t &leafsize = 16 );
+
+    // Destructor
+    ~KDTree();
+
+    // Finds the < k > nearest points to the given one. Their indices (in the
+    // array used to build the tree) and squared distances are stored in the
+    // output vectors, sorted by increasing distance.
+    void nearest( const double *point,
+		  const size_t &k,
+		  Sizes        &indices,
+		  Doubles      &distances ) const;
+
+    // Returns the number of dimensions
+    inline size_t getNdim() const;
+
+    // Returns the number of points
+    inline size_t getNpoints() const;
+
+  protected:
+
+    // Node of the tree. Leaf nodes have no children, and contain the points in
+    // the range [first, last).
+    struct Node {
+
+      // First point in the node
+      size_t first;
+
+      // Point after the last in the node
+      size_t last;
+
+      // Dimension used to split the node
+      size_t dim;
+
+      // Value used to split the node
+      double split;
+
+      // Index of the left child (null for leaves)
+      size_t left;
+
+      // Index of the right child (null for leaves)
+      size_t right;
+    };
+
+    // Original index of each point
+    Sizes fIndices;
+
+    // Size of the leaves
+    size_t fLeafSize;
+
+    // Number of dimensions
+    size_t fNdim;
+
+    // Nodes of the tree. The first is the root node.
+    std::vector<Node> fNodes;
+
+    // Values of the points, sorted as in < fIndices >
+    Doubles fPoints;
+
+  private:
+
+    // Type used to store the candidates in a search
+    typedef std::pair<double, size_t> Candidate;
+
+    // Builds the node for the points in [first, last), returning its index
+    size_t build( const Doubles &points, const size_t &first, const size_t &last );
+
+    // Searches the nearest points in the given node, updating the heap of
+    // candidates
+    void search( const size_t &inode,
+		 const double *point,
+		 const size_t &k,
+		 std::vector<Candidate> &heap ) const;
+
+  };
+
+  //_______________________________________________________________________________
+  //
+  inline size_t KDTree::getNdim() const { return fNdim; }
+
+  //_______________________________________________________________________________
+  //
+  inline size_t KDTree::getNpoints() const { return fIndices.size(); }
+
+}
+
+#endif
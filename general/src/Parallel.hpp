@@ -0,0 +1,115 @@
+////////////////////////////////////////////////////////////////////////////
+//
+//  General package
+//
+// -------------------------------------------------------------------------
+//
+//  AUTHOR: Miguel Ramos Pernas
+//  e-mail: miguel.ramos.pernas@cern.ch
+//
+//  Last update: 18/10/2026
+//
+// -------------------------------------------------------------------------
+//
+//  Description:
+//
+//  Define functions to split a loop among several threads. The work is
+//  divided in contiguous chunks, so each thread can use its own buffers
+//  which are merged by the caller once all of them have finished.
+//
+// -------------------------------------------------------------------------
+////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <exception>
+#include <thread>
+#include <vector>
+
+
+//________________________________________________________________________
+
+namespace isis {
+
+  //______________________________________________________________________
+  // Return the number of threads to use by default. It corresponds to the
+  // number of concurrent threads supported by the machine.
+  inline size_t defaultNthreads() {
+
+    size_t n = std::thread::hardware_concurrency();
+
+    return n ? n : 1;
+  }
+
+  //______________________________________________________________________
+  // Return the number of threads to be used given the requested value and
+  // the number of elements to process. A null request means to use the
+  // default number of threads.
+  inline size_t getNthreads( const size_t &nthreads, const size_t &n ) {
+
+    size_t nt = nthreads ? nthreads : defaultNthreads();
+
+    if ( nt > n )
+      nt = n;
+
+    return nt ? nt : 1;
+  }
+
+  //______________________________________________________________________
+  // Split the range [0, n) in contiguous chunks and call
+  // < func(ithread, first, last) > for each of them in a different thread.
+  // The last chunk is processed by the calling thread. If any of the calls
+  // throws an exception, it is propagated once all the threads finish.
+  template<class function>
+  void parallelFor( const size_t &n, const size_t &nthreads, const function &func ) {
+
+    const size_t nt = getNthreads(nthreads, n);
+
+    if ( nt == 1 ) {
+      if ( n )
+	func(0, 0, n);
+      return;
+    }
+
+    std::vector<std::exception_ptr> errors(nt);
+    std::vector<std::thread> threads;
+    threads.reserve(nt - 1);
+
+    auto call = [&func, &errors] ( size_t it, size_t first, size_t last ) {
+      try {
+	func(it, first, last);
+      }
+      catch ( ... ) {
+	errors[it] = std::current_exception();
+      }
+    };
+
+    const size_t chunk = n/nt;
+    const size_t rem   = n % nt;
+
+    size_t first = 0;
+    for ( size_t it = 0; it < nt; ++it ) {
+
+      size_t last = first + chunk + (it < rem);
+
+      if ( it + 1 < nt )
+	threads.emplace_back(call, it, first, last);
+      else
+	call(it, first, last);
+
+      first = last;
+    }
+
+    for ( auto &th : threads )
+      th.join();
+
+    for ( auto &err : errors )
+      if ( err )
+	std::rethrow_exception(err);
+  }
+
+}
+
+#endif
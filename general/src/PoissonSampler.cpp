@@ -0,0 +1,94 @@
+////////////////////////////////////////////////////////////////////////////
+//
+//  General package
+//
+// -------------------------------------------------------------------------
+//
+//  AUTHOR: Miguel Ramos Pernas
+//  e-mail: miguel.ramos.pernas@cern.ch
+//
+//  Last update: 18/10/2026
+//
+// -------------------------------------------------------------------------
+////////////////////////////////////////////////////////////////////////////
+
+
+#include "Definitions.hpp"
+#include "PoissonSampler.hpp"
+
+#include <cmath>
+
+
+//________________________________________________________________________
+
+namespace isis {
+
+  //______________________________________________________________________
+  //
+  constexpr double PoissonSampler::MaxTableMean;
+
+  //______________________________________________________________________
+  //
+  PoissonSampler::PoissonSampler( const Doubles &means ) {
+
+    this->setMeans( means );
+  }
+
+  //______________________________________________________________________
+  //
+  PoissonSampler::~PoissonSampler() { }
+
+  //______________________________________________________________________
+  //
+  void PoissonSampler::setMeans( const Doubles &means ) {
+
+    fMeans = means;
+
+    fCDF.clear();
+    fChannels.resize( means.size() );
+
+    for ( size_t i = 0; i < means.size(); ++i ) {
+
+      Channel &ch = fChannels[ i ];
+
+      const double mean = means[ i ];
+
+      ch.mean = mean;
+
+      if ( mean <= 0 )
+	continue;
+
+      if ( mean < MaxTableMean ) {
+
+	// The table is filled until the probabilities above the mode are
+	// negligible. The last element is set to one so the remaining
+	// probability is assigned to it.
+	ch.first = fCDF.size();
+	ch.mode  = std::floor( mean );
+
+	double k = 0, p = std::exp( -mean ), cdf = p;
+	while ( k <= mean || ( p > 1e-17 && cdf < 1 ) ) {
+	  fCDF.push_back( cdf );
+	  ++k;
+	  p   *= mean/k;
+	  cdf += p;
+	}
+	fCDF.back() = 1;
+      }
+      else {
+
+	// Transformed rejection with squeeze (PTRS), from W. Hormann, "The
+	// transformed rejection method for generating Poisson random
+	// variables", Insurance: Mathematics and Economics 12 (1993) 39
+	const double slam = std::sqrt( mean );
+
+	ch.loglam   = std::log( mean );
+	ch.b        = 0.931 + 2.53*slam;
+	ch.a        = -0.059 + 0.02483*ch.b;
+	ch.invalpha = 1.1239 + 1.1328/( ch.b - 3.4 );
+	ch.vr       = 0.9277 - 3.6224/( ch.b - 2 );
+      }
+    }
+  }
+
+}
@@ -0,0 +1,241 @@
+////////////////////////////////////////////////////////////////////////////
+//
+//  General package
+//
+// -------------------------------------------------------------------------
+//
+//  AUTHOR: Miguel Ramos Pernas
+//  e-mail: miguel.ramos.pernas@cern.ch
+//
+//  Last update: 18/10/2026
+//
+// -------------------------------------------------------------------------
+//
+//  Description:
+//
+//  Generate values following Poisson distributions with a fixed set of
+//  means, one per channel, using a < RandomEngine >. Everything that only
+//  depends on the means is calculated on construction: for small means the
+//  cumulative distribution is stored in a table which is inverted starting
+//  from the mode, and for large means the constants of the transformed
+//  rejection method (PTRS) are cached. The values for a whole toy, or a
+//  block of toys, are then generated at once. The object is not modified
+//  while generating, so it can be shared among threads, each of them
+//  having its own generator.
+//
+// -------------------------------------------------------------------------
+////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef POISSON_SAMPLER_H
+#define POISSON_SAMPLER_H
+
+#include "Definitions.hpp"
+#include "RandomEngine.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+
+//________________________________________________________________________
+
+namespace isis {
+
+  class PoissonSampler {
+
+  public:
+
+    // Constructor given the means of the channels
+    PoissonSampler( const Doubles &means = {} );
+
+    // Destructor
+    ~PoissonSampler();
+
+    // Generate the values for one toy, writing them in < values >, which must
+    // have space for as many elements as channels
+    inline void fill( RandomEngine &rndm, double *values ) const;
+
+    // Generate the values for < n > toys. The values of each toy are written
+    // one after the other, so < values > must have space for < n > times the
+    // number of channels. The toys are processed in groups, and within each
+    // group the channels one after the other: for those generated by
+    // inversion, the uniform numbers of the whole group are drawn first and
+    // then transformed. The values follow the same distributions as those from
+    // < fill >, but they are not the same.
+    inline void fill( RandomEngine &rndm, const size_t &n, double *values ) const;
+
+    // Return the means of the channels
+    inline const Doubles& getMeans() const;
+
+    // Return the number of channels
+    inline size_t getSize() const;
+
+    // Return a value for the given channel
+    inline double sample( const size_t &pos, RandomEngine &rndm ) const;
+
+    // Set the means of the channels, recalculating the tables and constants
+    void setMeans( const Doubles &means );
+
+    // Means below this value are generated inverting the cumulative
+    // distribution
+    static constexpr double MaxTableMean = 10;
+
+  protected:
+
+    // Information to generate the values of a channel. For the inversion
+    // method, < first > and < mode > are the positions of the first value and
+    // of the mode in the table. The rest of values are the constants of the
+    // PTRS method.
+    struct Channel {
+      double a;
+      double b;
+      double invalpha;
+      double loglam;
+      double mean;
+      double vr;
+      size_t first;
+      size_t mode;
+    };
+
+    // Cumulative distributions of the channels generated by inversion
+    Doubles fCDF;
+
+    // Information of the channels
+    std::vector<Channel> fChannels;
+
+    // Means of the channels
+    Doubles fMeans;
+
+  private:
+
+    // Return the value of a channel corresponding to the given uniform number,
+    // inverting its cumulative distribution
+    inline double invert( const Channel &ch, const double &u ) const;
+
+    // Generate a value using the PTRS method
+    inline double ptrs( const Channel &ch, RandomEngine &rndm ) const;
+
+  };
+
+  //______________________________________________________________________
+  //
+  inline void PoissonSampler::fill( RandomEngine &rndm, double *values ) const {
+
+    for ( size_t i = 0; i < fChannels.size(); ++i )
+      values[ i ] = this->sample( i, rndm );
+  }
+
+  //______________________________________________________________________
+  //
+  inline void PoissonSampler::fill( RandomEngine &rndm,
+				    const size_t &n,
+				    double       *values ) const {
+
+    const size_t nch = fChannels.size();
+
+    // The toys are processed in groups small enough to be kept in the cache
+    const size_t groupsize = 512;
+
+    for ( size_t first = 0; first < n; first += groupsize, values += groupsize*nch ) {
+
+      const size_t m = std::min( groupsize, n - first );
+
+      for ( size_t j = 0; j < nch; ++j ) {
+
+	const Channel &ch = fChannels[ j ];
+
+	double *column = values + j;
+
+	if ( ch.mean <= 0 )
+	  for ( size_t i = 0; i < m; ++i )
+	    column[ i*nch ] = 0;
+	else if ( ch.mean >= MaxTableMean )
+	  for ( size_t i = 0; i < m; ++i )
+	    column[ i*nch ] = this->ptrs( ch, rndm );
+	else {
+
+	  for ( size_t i = 0; i < m; ++i )
+	    column[ i*nch ] = rndm.uniform();
+
+	  for ( size_t i = 0; i < m; ++i )
+	    column[ i*nch ] = this->invert( ch, column[ i*nch ] );
+	}
+      }
+    }
+  }
+
+  //______________________________________________________________________
+  //
+  inline const Doubles& PoissonSampler::getMeans() const {
+
+    return fMeans;
+  }
+
+  //______________________________________________________________________
+  //
+  inline size_t PoissonSampler::getSize() const {
+
+    return fChannels.size();
+  }
+
+  //______________________________________________________________________
+  //
+  inline double PoissonSampler::sample( const size_t &pos, RandomEngine &rndm ) const {
+
+    const Channel &ch = fChannels[ pos ];
+
+    if ( ch.mean <= 0 )
+      return 0;
+
+    if ( ch.mean >= MaxTableMean )
+      return this->ptrs( ch, rndm );
+
+    return this->invert( ch, rndm.uniform() );
+  }
+
+  //______________________________________________________________________
+  //
+  inline double PoissonSampler::invert( const Channel &ch, const double &u ) const {
+
+    // Smallest value whose cumulative probability is greater or equal than
+    // the uniform number. The last element of the table is one, so the
+    // search always ends.
+    const double *cdf = fCDF.data() + ch.first;
+
+    size_t k = ch.mode;
+    if ( u > cdf[ k ] )
+      do ++k; while ( u > cdf[ k ] );
+    else
+      while ( k && u <= cdf[ k - 1 ] )
+	--k;
+
+    return k;
+  }
+
+  //______________________________________________________________________
+  //
+  inline double PoissonSampler::ptrs( const Channel &ch, RandomEngine &rndm ) const {
+
+    while ( true ) {
+
+      const double u  = rndm.uniform() - 0.5;
+      const double v  = rndm.uniform();
+      const double us = 0.5 - std::abs( u );
+      const double k  = std::floor( ( 2*ch.a/us + ch.b )*u + ch.mean + 0.43 );
+
+      if ( us >= 0.07 && v <= ch.vr )
+	return k;
+
+      if ( k < 0 || ( us < 0.013 && v > us ) )
+	continue;
+
+      if ( std::log( v*ch.invalpha/( ch.a/( us*us ) + ch.b ) ) <=
+	   -ch.mean + k*ch.loglam - std::lgamma( k + 1 ) )
+	return k;
+    }
+  }
+
+}
+
+#endif
@@ -0,0 +1,309 @@
+////////////////////////////////////////////////////////////////////////////
+//
+//  General package
+//
+// -------------------------------------------------------------------------
+//
+//  AUTHOR: Miguel Ramos Pernas
+//  e-mail: miguel.ramos.pernas@cern.ch
+//
+//  Last update: 18/10/2026
+//
+// -------------------------------------------------------------------------
+//
+//  Description:
+//
+//  Define a pseudo-random number generator based on the xoshiro256**
+//  algorithm. The state is seeded using the splitmix64 generator, and the
+//  < jump > method advances the sequence by 2^128 steps, so independent
+//  streams can be given to different threads starting from a single seed.
+//  Each object must only be used by one thread at a time.
+//
+// -------------------------------------------------------------------------
+////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef RANDOM_ENGINE_H
+#define RANDOM_ENGINE_H
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+
+//________________________________________________________________________
+
+namespace isis {
+
+  class RandomEngine {
+
+  public:
+
+    // Type of the values returned by the generator
+    typedef uint64_t result_type;
+
+    // Constructor given the seed
+    RandomEngine( const uint64_t &seed = 0 );
+
+    // Destructor
+    ~RandomEngine() { }
+
+    // Return the next value of the sequence
+    inline uint64_t operator() ();
+
+    // Advance the sequence by 2^128 steps. It is equivalent to calling the
+    // generator 2^128 times.
+    inline void jump();
+
+    // Return a vector with < n > generators. The first is a copy of this one,
+    // and the rest are separated by calls to < jump >. This object is left
+    // in the state following the last generator.
+    inline std::vector<RandomEngine> split( const size_t &n );
+
+    // Return the state of the generator, given by four values
+    inline const uint64_t* getState() const;
+
+    // Return a value following a gamma distribution with the given shape and
+    // unit scale
+    inline double gamma( const double &shape );
+
+    // Return a value following a normal distribution with null mean and unit
+    // standard deviation
+    inline double gaussian();
+
+    // Return a value following a Poisson distribution with the given mean
+    inline double poisson( const double &mean );
+
+    // Set the seed of the generator
+    inline void setSeed( const uint64_t &seed );
+
+    // Set the state of the generator, given by four values (see < getState >)
+    inline void setState( const uint64_t *state );
+
+    // Return a value following a uniform distribution in [0, 1)
+    inline double uniform();
+
+    // Minimum value returned by the generator
+    static constexpr uint64_t min() { return 0; }
+
+    // Maximum value returned by the generator
+    static constexpr uint64_t max() { return UINT64_MAX; }
+
+  protected:
+
+    // State of the generator
+    uint64_t fState[ 4 ];
+
+  private:
+
+    // Rotate the bits of the given value to the left
+    static inline uint64_t rotl( const uint64_t &x, const int &k ) {
+      return ( x << k ) | ( x >> ( 64 - k ) );
+    }
+
+  };
+
+  //______________________________________________________________________
+  //
+  inline RandomEngine::RandomEngine( const uint64_t &seed ) {
+
+    this->setSeed( seed );
+  }
+
+  //______________________________________________________________________
+  //
+  inline uint64_t RandomEngine::operator() () {
+
+    const uint64_t result = rotl( fState[ 1 ]*5, 7 )*9;
+    const uint64_t t      = fState[ 1 ] << 17;
+
+    fState[ 2 ] ^= fState[ 0 ];
+    fState[ 3 ] ^= fState[ 1 ];
+    fState[ 1 ] ^= fState[ 2 ];
+    fState[ 0 ] ^= fState[ 3 ];
+    fState[ 2 ] ^= t;
+    fState[ 3 ]  = rotl( fState[ 3 ], 45 );
+
+    return result;
+  }
+
+  //______________________________________________________________________
+  //
+  inline void RandomEngine::jump() {
+
+    static const uint64_t coefs[ 4 ] = {
+      0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+      0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL };
+
+    uint64_t s[ 4 ] = { 0, 0, 0, 0 };
+    for ( int i = 0; i < 4; ++i )
+      for ( int b = 0; b < 64; ++b ) {
+	if ( coefs[ i ] & ( uint64_t( 1 ) << b ) )
+	  for ( int j = 0; j < 4; ++j )
+	    s[ j ] ^= fState[ j ];
+	( *this )();
+      }
+
+    for ( int j = 0; j < 4; ++j )
+      fState[ j ] = s[ j ];
+  }
+
+  //______________________________________________________________________
+  //
+  inline std::vector<RandomEngine> RandomEngine::split( const size_t &n ) {
+
+    std::vector<RandomEngine> engines;
+    engines.reserve( n );
+
+    for ( size_t i = 0; i < n; ++i ) {
+      engines.push_back( *this );
+      this->jump();
+    }
+
+    return engines;
+  }
+
+  //______________________________________________________________________
+  //
+  inline const uint64_t* RandomEngine::getState() const {
+
+    return fState;
+  }
+
+  //______________________________________________________________________
+  //
+  inline double RandomEngine::gamma( const double &shape ) {
+
+    if ( shape <= 0 )
+      return 0;
+
+    // For shapes smaller than one, the value is obtained from a gamma
+    // distribution with shape + 1
+    if ( shape < 1 )
+      return this->gamma( shape + 1 )*std::pow( 1. - this->uniform(), 1./shape );
+
+    // Method from G. Marsaglia and W. W. Tsang, "A simple method for
+    // generating gamma variables", ACM Trans. Math. Softw. 26 (2000) 363
+    const double d = shape - 1./3;
+    const double c = 1./std::sqrt( 9*d );
+
+    while ( true ) {
+
+      double x, v;
+      do {
+	x = this->gaussian();
+	v = 1 + c*x;
+      } while ( v <= 0 );
+
+      v = v*v*v;
+
+      const double u = 1. - this->uniform();
+
+      if ( u < 1 - 0.0331*x*x*x*x )
+	return d*v;
+
+      if ( std::log( u ) < 0.5*x*x + d*( 1 - v + std::log( v ) ) )
+	return d*v;
+    }
+  }
+
+  //______________________________________________________________________
+  //
+  inline double RandomEngine::gaussian() {
+
+    // Polar method. Only one of the two values is used, so the state of the
+    // generator is fully described by < fState >.
+    double u, v, s;
+    do {
+      u = 2*this->uniform() - 1;
+      v = 2*this->uniform() - 1;
+      s = u*u + v*v;
+    } while ( s >= 1 || s == 0 );
+
+    return u*std::sqrt( -2*std::log( s )/s );
+  }
+
+  //______________________________________________________________________
+  //
+  inline double RandomEngine::poisson( const double &mean ) {
+
+    if ( mean <= 0 )
+      return 0;
+
+    // For small means the cumulative distribution is inverted
+    if ( mean < 10 ) {
+
+      const double u = this->uniform();
+
+      double k = 0, p = std::exp( -mean ), cdf = p;
+      while ( u > cdf && p > 0 ) {
+	++k;
+	p   *= mean/k;
+	cdf += p;
+      }
+
+      return k;
+    }
+
+    // Transformed rejection with squeeze (PTRS), from W. Hormann, "The
+    // transformed rejection method for generating Poisson random variables",
+    // Insurance: Mathematics and Economics 12 (1993) 39
+    const double slam     = std::sqrt( mean );
+    const double loglam   = std::log( mean );
+    const double b        = 0.931 + 2.53*slam;
+    const double a        = -0.059 + 0.02483*b;
+    const double invalpha = 1.1239 + 1.1328/( b - 3.4 );
+    const double vr       = 0.9277 - 3.6224/( b - 2 );
+
+    while ( true ) {
+
+      const double u  = this->uniform() - 0.5;
+      const double v  = this->uniform();
+      const double us = 0.5 - std::abs( u );
+      const double k  = std::floor( ( 2*a/us + b )*u + mean + 0.43 );
+
+      if ( us >= 0.07 && v <= vr )
+	return k;
+
+      if ( k < 0 || ( us < 0.013 && v > us ) )
+	continue;
+
+      if ( std::log( v ) + std::log( invalpha ) - std::log( a/( us*us ) + b ) <=
+	   -mean + k*loglam - std::lgamma( k + 1 ) )
+	return k;
+    }
+  }
+
+  //______________________________________________________________________
+  //
+  inline void RandomEngine::setSeed( const uint64_t &seed ) {
+
+    // The state is filled using the splitmix64 generator, so similar seeds
+    // lead to very different states
+    uint64_t x = seed;
+    for ( int i = 0; i < 4; ++i ) {
+      uint64_t z = ( x += 0x9e3779b97f4a7c15ULL );
+      z = ( z ^ ( z >> 30 ) )*0xbf58476d1ce4e5b9ULL;
+      z = ( z ^ ( z >> 27 ) )*0x94d049bb133111ebULL;
+      fState[ i ] = z ^ ( z >> 31 );
+    }
+  }
+
+  //______________________________________________________________________
+  //
+  inline void RandomEngine::setState( const uint64_t *state ) {
+
+    for ( int i = 0; i < 4; ++i )
+      fState[ i ] = state[ i ];
+  }
+
+  //______________________________________________________________________
+  //
+  inline double RandomEngine::uniform() {
+
+    return ( ( *this )() >> 11 )*( 1./9007199254740992. );
+  }
+
+}
+
+#endif
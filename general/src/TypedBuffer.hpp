@@ -0,0 +1,78 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+//  General package
+//
+// -----------------------------------------------------------------------------
+//
+//  AUTHOR: Miguel Ramos Pernas
+//  e-mail: miguel.ramos.pernas@cern.ch
+//
+//  Last update: 18/10/2026
+//
+// -----------------------------------------------------------------------------
+//
+//  Description:
+//
+//  Definition of the handle to access a variable of a buffer array whose type
+//  is known at compile time. The type is checked once, when the handle is
+//  created, so the value is accessed directly through its address, without
+//  any switch or look-up by name. The handle remains valid as long as the
+//  variable is booked in the array.
+//
+// -----------------------------------------------------------------------------
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef TYPED_BUFFER
+#define TYPED_BUFFER
+
+
+//_______________________________________________________________________________
+
+namespace isis {
+
+  template<class type>
+  class TypedBuffer {
+
+  public:
+
+    // Constructor given the address of the value
+    TypedBuffer( type *path = 0 ) : fPath( path ) { }
+
+    // Destructor
+    ~TypedBuffer() { }
+
+    // Returns the address of the value
+    inline type* get() const;
+
+    // Returns the value
+    inline const type& value() const;
+
+    // Returns a reference to the value
+    inline type& operator * () const;
+
+  protected:
+
+    // Address of the value
+    type *fPath;
+
+  };
+
+  //_______________________________________________________________________________
+  //
+  template<class type>
+  inline type* TypedBuffer<type>::get() const { return fPath; }
+
+  //_______________________________________________________________________________
+  //
+  template<class type>
+  inline const type& TypedBuffer<type>::value() const { return *fPath; }
+
+  //_______________________________________________________________________________
+  //
+  template<class type>
+  inline type& TypedBuffer<type>::operator * () const { return *fPath; }
+
+}
+
+#endif
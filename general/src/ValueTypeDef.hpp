@@ -7,7 +7,7 @@
 //  AUTHOR: Miguel Ramos Pernas
 //  e-mail: miguel.ramos.pernas@cern.ch
 //
-//  Last update: 10/04/2017
+//  Last update: 18/10/2026
 //
 // -------------------------------------------------------------------------------
 //
@@ -41,6 +41,21 @@ namespace isis {
   using ullInt = unsigned long long int;
   using Bool   = bool;
 
+  // Returns the character identifying the given type in Root
+  template<class type> inline char typeCode();
+
+  template<> inline char typeCode<Char>()   { return 'B'; }
+  template<> inline char typeCode<uChar>()  { return 'b'; }
+  template<> inline char typeCode<sInt>()   { return 'S'; }
+  template<> inline char typeCode<usInt>()  { return 's'; }
+  template<> inline char typeCode<Int>()    { return 'I'; }
+  template<> inline char typeCode<uInt>()   { return 'i'; }
+  template<> inline char typeCode<Float>()  { return 'F'; }
+  template<> inline char typeCode<Double>() { return 'D'; }
+  template<> inline char typeCode<llInt>()  { return 'L'; }
+  template<> inline char typeCode<ullInt>() { return 'l'; }
+  template<> inline char typeCode<Bool>()   { return 'O'; }
+
 }
 
 //_______________________________________________________________________________
@@ -7,7 +7,7 @@
 #//  AUTHOR: Miguel Ramos Pernas
 #//  e-mail: miguel.ramos.pernas@cern.ch
 #//
-#//  Last update: 19/10/2017
+#//  Last update: 18/10/2026
 #//
 #// ----------------------------------------------------------
 #//
@@ -226,13 +226,15 @@ class DataMgr( pandas.DataFrame ):
                 print deco + '\n'
         
     @staticmethod
-    def from_root( path, tname, columns = None, name = '<unnamed>', cuts = '', regex = False ):
+    def from_root( path, tname, columns = None, name = '<unnamed>', cuts = '', regex = False, nthreads = 1 ):
         '''
-        Create a DataMgr instance from a root file
+        Create a DataMgr instance from a root file. The clusters of the
+        tree can be read using several threads (zero means to use the
+        number of concurrent threads supported by the machine).
         '''
         cols = columns or []
         
-        v = treeToArray(path, tname, cols, cuts, regex)
+        v = treeToArray(path, tname, cols, cuts, regex, nthreads)
         
         return DataMgr(data = v, columns = v.dtype.names, name = name)
     
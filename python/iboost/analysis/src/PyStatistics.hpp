@@ -7,7 +7,7 @@
 //  AUTHOR: Miguel Ramos Pernas
 //  e-mail: miguel.ramos.pernas@cern.ch
 //
-//  Last update: 30/06/2017
+//  Last update: 18/10/2026
 //
 // -------------------------------------------------------------------------------
 //
@@ -25,16 +25,83 @@
 
 #include "GlobalWrappers.hpp"
 
+#include "CLsAsymptotic.hpp"
 #include "CLsFactory.hpp"
 #include "CLsFluctuator.hpp"
+#include "CLsFluctuators.hpp"
 #include "CLsHypothesis.hpp"
 #include "CLsPrior.hpp"
+#include "CLsPriors.hpp"
 #include "CLsResult.hpp"
+#include "CLsScanResult.hpp"
+#include "CLsTSDistribution.hpp"
 #include "Definitions.hpp"
 
 #include "TPython.h"
 
 
+//_______________________________________________________________________________
+
+// Wrappers for the class CLsAsymptotic
+namespace CLsAsy {
+
+  //_______________________________________________________________________________
+  //
+  inline isis::CLsResult calculateFromArray( const isis::CLsAsymptotic &calc,
+					     const np::ndarray &array ) {
+
+    auto vector = iboost::numpyArrayToStdCont<isis::Doubles>( array );
+
+    return calc.calculate( vector );
+  }
+
+  //_______________________________________________________________________________
+  //
+  isis::CLsResult
+  (isis::CLsAsymptotic::*calculateFromDouble)( const double &tstat ) const =
+    &isis::CLsAsymptotic::calculate;
+
+  BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(expected_Overloads, expected, 0, 1);
+
+  //_______________________________________________________________________________
+  //
+  inline isis::CLsScanResult scan( const np::ndarray &bkg,
+				   const np::ndarray &sig,
+				   const np::ndarray &mu,
+				   const np::ndarray &obs ) {
+
+    auto b = iboost::numpyArrayToStdCont<isis::Doubles>( bkg );
+    auto s = iboost::numpyArrayToStdCont<isis::Doubles>( sig );
+    auto m = iboost::numpyArrayToStdCont<isis::Doubles>( mu );
+    auto o = iboost::numpyArrayToStdCont<isis::Doubles>( obs );
+
+    return isis::CLsAsymptotic::scan( b, s, m, o );
+  }
+
+  //_______________________________________________________________________________
+  //
+  inline double upperLimit( const np::ndarray &bkg,
+			    const np::ndarray &sig,
+			    const double &mumin,
+			    const double &mumax,
+			    const np::ndarray &obs,
+			    const double &cl = 0.95,
+			    const int &nsigma = 0,
+			    const double &precision = 1e-6 ) {
+
+    auto b = iboost::numpyArrayToStdCont<isis::Doubles>( bkg );
+    auto s = iboost::numpyArrayToStdCont<isis::Doubles>( sig );
+    auto o = iboost::numpyArrayToStdCont<isis::Doubles>( obs );
+
+    return isis::CLsAsymptotic::upperLimit( b, s, mumin, mumax, o, cl, nsigma, precision );
+  }
+
+  BOOST_PYTHON_FUNCTION_OVERLOADS(upperLimit_Overloads, upperLimit, 5, 8);
+
+  BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(validate_Overloads, validate, 1, 4);
+}
+
+
 //_______________________________________________________________________________
 
 // Wrappers for the class CLsFactory
@@ -56,6 +123,94 @@ namespace CLsFact {
   (isis::CLsFactory::*calculateFromDouble)( const double &tstat ) const =
     &isis::CLsFactory::calculate;
 
+  //_______________________________________________________________________________
+  // Calculate the results for an array of test-statistics values, or for a
+  // two-dimensional array with the observed values in each row. The result is a
+  // dictionary with an array for each quantity.
+  inline py::dict calculateMany( const isis::CLsFactory &factory,
+				 const np::ndarray &values ) {
+
+    np::ndarray array = iboost::numpyArrayAsContiguous<double>( values );
+
+    const double *data = reinterpret_cast<const double*>(array.get_data());
+
+    isis::Doubles tstats;
+
+    if ( array.get_nd() == 1 )
+      tstats.assign(data, data + array.shape(0));
+    else if ( array.get_nd() == 2 ) {
+
+      const size_t nrows = array.shape(0);
+      const size_t ncols = array.shape(1);
+
+      tstats.resize(nrows);
+
+      isis::Doubles row(ncols);
+      for ( size_t i = 0; i < nrows; ++i ) {
+
+	std::copy(data + i*ncols, data + (i + 1)*ncols, row.begin());
+
+	tstats[i] = factory.testStat( row );
+      }
+    }
+    else
+      throw isis::BaseException("The input array must have one or two dimensions");
+
+    auto results = factory.calculateMany( tstats.data(), tstats.size() );
+
+    Py_intptr_t shape[1] = {long(results.size())};
+
+    const char *names[] = {"Alpha", "Beta", "CLb", "CLs", "CLsb", "TestStat", "Significance"};
+    double (isis::CLsResult::*getters[])() const = {
+      &isis::CLsResult::alpha,
+      &isis::CLsResult::beta,
+      &isis::CLsResult::CLb,
+      &isis::CLsResult::CLs,
+      &isis::CLsResult::CLsb,
+      &isis::CLsResult::testStat,
+      &isis::CLsResult::significance
+    };
+
+    py::dict output;
+    for ( size_t i = 0; i < 7; ++i ) {
+
+      np::ndarray column = np::empty(1, shape, np::dtype::get_builtin<double>());
+
+      double *out = reinterpret_cast<double*>(column.get_data());
+      for ( size_t j = 0; j < results.size(); ++j )
+	out[j] = (results[j].*getters[i])();
+
+      output[names[i]] = column;
+    }
+
+    return output;
+  }
+
+  //_______________________________________________________________________________
+  //
+  void (isis::CLsFactory::*generate)( const size_t &n ) = &isis::CLsFactory::generate;
+
+  //_______________________________________________________________________________
+  //
+  void (isis::CLsFactory::*generateParallel)( const size_t &n,
+					       const size_t &nthreads,
+					       const uint64_t &seed ) =
+    &isis::CLsFactory::generate;
+
+  //_______________________________________________________________________________
+  //
+  inline void generateCheckpoint( isis::CLsFactory &factory,
+				  const size_t &n,
+				  const size_t &nthreads,
+				  const uint64_t &seed,
+				  const std::string &path,
+				  const size_t &batch = 100000 ) {
+
+    factory.generate( n, nthreads, seed, path, batch );
+  }
+
+  BOOST_PYTHON_FUNCTION_OVERLOADS(generateCheckpoint_Overloads, generateCheckpoint, 5, 6);
+
   //_______________________________________________________________________________
   //
   inline isis::CLsHypothesis getNullHyp( isis::CLsFactory &factory ) {
@@ -70,6 +225,40 @@ namespace CLsFact {
     return *(factory.getSigHyp());
   }
 
+  //_______________________________________________________________________________
+  //
+  inline void merge( isis::CLsFactory &factory, py::list &paths ) {
+
+    auto vector = iboost::boostListToStdCont<std::vector, std::string>( paths );
+
+    factory.merge( vector );
+  }
+
+  //_______________________________________________________________________________
+  //
+  inline isis::CLsScanResult scan( const np::ndarray &bkg,
+				   const np::ndarray &sig,
+				   const np::ndarray &mu,
+				   const np::ndarray &obs,
+				   const size_t &n = 10000,
+				   const size_t &nthreads = 0,
+				   const uint64_t &seed = 0,
+				   isis::CLsFluctuator *nullFluct = 0,
+				   isis::CLsPrior *nullPrior = 0,
+				   isis::CLsFluctuator *sigFluct = 0,
+				   isis::CLsPrior *sigPrior = 0 ) {
+
+    auto b = iboost::numpyArrayToStdCont<isis::Doubles>( bkg );
+    auto s = iboost::numpyArrayToStdCont<isis::Doubles>( sig );
+    auto m = iboost::numpyArrayToStdCont<isis::Doubles>( mu );
+    auto o = iboost::numpyArrayToStdCont<isis::Doubles>( obs );
+
+    return isis::CLsFactory::scan( b, s, m, o, n, nthreads, seed,
+				   nullFluct, nullPrior, sigFluct, sigPrior );
+  }
+
+  BOOST_PYTHON_FUNCTION_OVERLOADS(scan_Overloads, scan, 4, 11);
+
   //_______________________________________________________________________________
   //
   inline double testStat( const isis::CLsFactory &factory,
@@ -79,6 +268,35 @@ namespace CLsFact {
 
     return factory.testStat( vector );
   }
+
+  //_______________________________________________________________________________
+  //
+  inline double upperLimit( const np::ndarray &bkg,
+			    const np::ndarray &sig,
+			    const double &mumin,
+			    const double &mumax,
+			    const np::ndarray &obs,
+			    const double &cl = 0.95,
+			    const int &nsigma = 0,
+			    const double &precision = 1e-3,
+			    const size_t &n = 10000,
+			    const size_t &nthreads = 0,
+			    const uint64_t &seed = 0,
+			    isis::CLsFluctuator *nullFluct = 0,
+			    isis::CLsPrior *nullPrior = 0,
+			    isis::CLsFluctuator *sigFluct = 0,
+			    isis::CLsPrior *sigPrior = 0 ) {
+
+    auto b = iboost::numpyArrayToStdCont<isis::Doubles>( bkg );
+    auto s = iboost::numpyArrayToStdCont<isis::Doubles>( sig );
+    auto o = iboost::numpyArrayToStdCont<isis::Doubles>( obs );
+
+    return isis::CLsFactory::upperLimit( b, s, mumin, mumax, o,
+					 cl, nsigma, precision, n, nthreads, seed,
+					 nullFluct, nullPrior, sigFluct, sigPrior );
+  }
+
+  BOOST_PYTHON_FUNCTION_OVERLOADS(upperLimit_Overloads, upperLimit, 5, 15);
 }
 
 // Wrappers for the class CLsFluctuator
@@ -91,6 +309,44 @@ namespace CLsFluct {
       return this->get_override("fluctuate")(pos, value);
     }
   };
+
+  //_______________________________________________________________________________
+  //
+  inline isis::CLsAsymGaussFluct* asymGaussConstructor( const np::ndarray &siglo,
+							const np::ndarray &sighi,
+							const uint64_t &seed ) {
+
+    auto lo = iboost::numpyArrayToStdCont<isis::Doubles>( siglo );
+    auto hi = iboost::numpyArrayToStdCont<isis::Doubles>( sighi );
+
+    return new isis::CLsAsymGaussFluct(lo, hi, seed);
+  }
+
+  //_______________________________________________________________________________
+  //
+  inline isis::CLsAsymGaussFluct* asymGaussConstructor_NoSeed( const np::ndarray &siglo,
+							       const np::ndarray &sighi ) {
+
+    return asymGaussConstructor(siglo, sighi, 0);
+  }
+
+  //_______________________________________________________________________________
+  //
+  template<class fluct>
+  inline fluct* constructor( const np::ndarray &sigmas, const uint64_t &seed ) {
+
+    auto vec = iboost::numpyArrayToStdCont<isis::Doubles>( sigmas );
+
+    return new fluct(vec, seed);
+  }
+
+  //_______________________________________________________________________________
+  //
+  template<class fluct>
+  inline fluct* constructor_NoSeed( const np::ndarray &sigmas ) {
+
+    return constructor<fluct>(sigmas, 0);
+  }
 }
 
 // Wrappers for the class CLsHypothesis
@@ -131,6 +387,17 @@ namespace CLsHyp {
     return boost::shared_ptr<isis::CLsHypothesis>( hyp );
   }
 
+  //_______________________________________________________________________________
+  //
+  void (isis::CLsHypothesis::*generate)( const size_t &n ) = &isis::CLsHypothesis::generate;
+
+  //_______________________________________________________________________________
+  //
+  void (isis::CLsHypothesis::*generateParallel)( const size_t &n,
+						  const size_t &nthreads,
+						  const uint64_t &seed ) =
+    &isis::CLsHypothesis::generate;
+
   //_______________________________________________________________________________
   //
   inline np::ndarray getHyp( const isis::CLsHypothesis &hyp ) {
@@ -140,6 +407,13 @@ namespace CLsHyp {
     return iboost::stdContToNumpyArray( vec );
   }
 
+  //_______________________________________________________________________________
+  //
+  inline np::ndarray getHypView( const isis::CLsHypothesis &hyp ) {
+
+    return iboost::stdVectorToNumpyView( hyp.shareHyp() );
+  }
+
   //_______________________________________________________________________________
   //
   inline double poissonProb( const isis::CLsHypothesis &hyp,
@@ -150,6 +424,31 @@ namespace CLsHyp {
     return hyp.poissonProb( vec );
   }
 
+  //_______________________________________________________________________________
+  //
+  inline np::ndarray getProposal( const isis::CLsHypothesis &hyp ) {
+
+    auto vec = hyp.getProposal();
+
+    return iboost::stdContToNumpyArray( vec );
+  }
+
+  //_______________________________________________________________________________
+  //
+  inline np::ndarray getTSLogWeights( const isis::CLsHypothesis &hyp ) {
+
+    auto vec = hyp.getTSLogWeights();
+
+    return iboost::stdContToNumpyArray( vec );
+  }
+
+  //_______________________________________________________________________________
+  //
+  inline np::ndarray getTSLogWeightsView( const isis::CLsHypothesis &hyp ) {
+
+    return iboost::stdVectorToNumpyView( hyp.shareTSLogWeights() );
+  }
+
   //_______________________________________________________________________________
   //
   inline np::ndarray getTSVals( const isis::CLsHypothesis &hyp ) {
@@ -159,6 +458,33 @@ namespace CLsHyp {
     return iboost::stdContToNumpyArray( vec );
   }
 
+  //_______________________________________________________________________________
+  //
+  inline np::ndarray getTSValsView( const isis::CLsHypothesis &hyp ) {
+
+    return iboost::stdVectorToNumpyView( hyp.shareTSVals() );
+  }
+
+  //_______________________________________________________________________________
+  //
+  inline np::ndarray pValues( const isis::CLsHypothesis &hyp,
+			      const np::ndarray &tstats ) {
+
+    np::ndarray array = iboost::numpyArrayAsContiguous<double>( tstats );
+
+    np::ndarray result = np::empty(array.get_nd(), array.get_shape(),
+				   np::dtype::get_builtin<double>());
+
+    size_t n = 1;
+    for ( int i = 0; i < array.get_nd(); ++i )
+      n *= array.shape(i);
+
+    hyp.pValues( reinterpret_cast<const double*>(array.get_data()), n,
+		 reinterpret_cast<double*>(result.get_data()) );
+
+    return result;
+  }
+
   //_______________________________________________________________________________
   //
   inline void setHyp( isis::CLsHypothesis &hyp,
@@ -172,6 +498,111 @@ namespace CLsHyp {
   }
 
   BOOST_PYTHON_FUNCTION_OVERLOADS(setHyp_Overloads, setHyp, 2, 4);
+
+  //_______________________________________________________________________________
+  //
+  inline void setProposal( isis::CLsHypothesis &hyp, const np::ndarray &means ) {
+
+    auto vec = iboost::numpyArrayToStdCont<isis::Doubles>( means );
+
+    hyp.setProposal(vec);
+  }
+
+  //_______________________________________________________________________________
+  //
+  inline void setTiltedProposal( isis::CLsHypothesis &hyp,
+				 const isis::CLsHypothesis &target,
+				 const double &tilt = 1 ) {
+
+    hyp.setProposal(target, tilt);
+  }
+
+  BOOST_PYTHON_FUNCTION_OVERLOADS(setTiltedProposal_Overloads, setTiltedProposal, 2, 3);
+}
+
+// Wrappers for the class CLsScanResult
+namespace CLsScanRes {
+
+  //_______________________________________________________________________________
+  //
+  inline np::ndarray expectedCLb( const isis::CLsScanResult &res, const int &nsigma ) {
+
+    return iboost::stdContToNumpyArray( res.expectedCLb( nsigma ) );
+  }
+
+  //_______________________________________________________________________________
+  //
+  inline np::ndarray expectedCLs( const isis::CLsScanResult &res, const int &nsigma ) {
+
+    return iboost::stdContToNumpyArray( res.expectedCLs( nsigma ) );
+  }
+
+  //_______________________________________________________________________________
+  //
+  inline np::ndarray expectedCLsb( const isis::CLsScanResult &res, const int &nsigma ) {
+
+    return iboost::stdContToNumpyArray( res.expectedCLsb( nsigma ) );
+  }
+
+  //_______________________________________________________________________________
+  //
+  inline np::ndarray getMu( const isis::CLsScanResult &res ) {
+
+    return iboost::stdContToNumpyArray( res.getMu() );
+  }
+
+  //_______________________________________________________________________________
+  //
+  inline np::ndarray observedCLb( const isis::CLsScanResult &res ) {
+
+    return iboost::stdContToNumpyArray( res.observedCLb() );
+  }
+
+  //_______________________________________________________________________________
+  //
+  inline np::ndarray observedCLs( const isis::CLsScanResult &res ) {
+
+    return iboost::stdContToNumpyArray( res.observedCLs() );
+  }
+
+  //_______________________________________________________________________________
+  //
+  inline np::ndarray observedCLsb( const isis::CLsScanResult &res ) {
+
+    return iboost::stdContToNumpyArray( res.observedCLsb() );
+  }
+
+  BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(expectedUpperLimit_Overloads, expectedUpperLimit, 0, 2);
+
+  BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(observedUpperLimit_Overloads, observedUpperLimit, 0, 1);
+}
+
+// Wrappers for the class CLsTSDistribution
+namespace CLsTSDist {
+
+  //_______________________________________________________________________________
+  //
+  void (isis::CLsTSDistribution::*fill)( const double &t ) = &isis::CLsTSDistribution::fill;
+
+  //_______________________________________________________________________________
+  //
+  inline void fillArray( isis::CLsTSDistribution &dist, const np::ndarray &values ) {
+
+    auto vector = iboost::numpyArrayToStdCont<isis::Doubles>( values );
+
+    dist.fill( vector );
+  }
+
+  //_______________________________________________________________________________
+  //
+  inline np::ndarray getEdges( const isis::CLsTSDistribution &dist ) {
+
+    auto vec = dist.getEdges();
+
+    return iboost::stdContToNumpyArray( vec );
+  }
+
+  BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(reset_Overloads, reset, 0, 1);
 }
 
 // Wrappers for the class CLsPrior
@@ -184,4 +615,14 @@ namespace CLsPrior {
       return this->get_override("evaluate")(pos, mean, value);
     }
   };
+
+  //_______________________________________________________________________________
+  //
+  template<class prior>
+  inline prior* constructor( const np::ndarray &sigmas ) {
+
+    auto vec = iboost::numpyArrayToStdCont<isis::Doubles>( sigmas );
+
+    return new prior(vec);
+  }
 }
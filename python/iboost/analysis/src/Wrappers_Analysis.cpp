@@ -7,7 +7,7 @@
 //  AUTHOR: Miguel Ramos Pernas
 //  e-mail: miguel.ramos.pernas@cern.ch
 //
-//  Last update: 03/07/2017
+//  Last update: 18/10/2026
 //
 // -------------------------------------------------------------------------------
 //
@@ -97,11 +97,68 @@ BOOST_PYTHON_MODULE( analysis ) {
     .def("fluctuate", py::pure_virtual(&CLsFluct::CLsFluctWrap::fluctuate))
     ;
 
+  // Wrappers from CLsFluctuators
+  py::class_<isis::CLsNativeFluctuator, py::bases<isis::CLsFluctuator>, boost::noncopyable>
+    ("CLsNativeFluctuator", py::no_init)
+    .def("fluctuate", &isis::CLsNativeFluctuator::fluctuate)
+    .def("getSize"  , &isis::CLsNativeFluctuator::getSize)
+    .def("setSeed"  , &isis::CLsNativeFluctuator::setSeed)
+    ;
+
+  py::class_<isis::CLsAsymGaussFluct, py::bases<isis::CLsNativeFluctuator>, boost::noncopyable>
+    ("CLsAsymGaussFluct", py::no_init)
+    .def("__init__", py::make_constructor(&CLsFluct::asymGaussConstructor))
+    .def("__init__", py::make_constructor(&CLsFluct::asymGaussConstructor_NoSeed))
+    ;
+
+  py::class_<isis::CLsGammaFluct, py::bases<isis::CLsNativeFluctuator>, boost::noncopyable>
+    ("CLsGammaFluct", py::no_init)
+    .def("__init__", py::make_constructor(&CLsFluct::constructor<isis::CLsGammaFluct>))
+    .def("__init__", py::make_constructor(&CLsFluct::constructor_NoSeed<isis::CLsGammaFluct>))
+    ;
+
+  py::class_<isis::CLsGaussFluct, py::bases<isis::CLsNativeFluctuator>, boost::noncopyable>
+    ("CLsGaussFluct", py::no_init)
+    .def("__init__", py::make_constructor(&CLsFluct::constructor<isis::CLsGaussFluct>))
+    .def("__init__", py::make_constructor(&CLsFluct::constructor_NoSeed<isis::CLsGaussFluct>))
+    ;
+
+  py::class_<isis::CLsLogNormFluct, py::bases<isis::CLsNativeFluctuator>, boost::noncopyable>
+    ("CLsLogNormFluct", py::no_init)
+    .def("__init__", py::make_constructor(&CLsFluct::constructor<isis::CLsLogNormFluct>))
+    .def("__init__", py::make_constructor(&CLsFluct::constructor_NoSeed<isis::CLsLogNormFluct>))
+    ;
+
   // Wrapper from CLsPrior
   py::class_<CLsPrior::CLsPriorWrap, boost::noncopyable>("CLsPrior")
     .def("evaluate", py::pure_virtual(&CLsPrior::CLsPriorWrap::evaluate))
     ;
 
+  // Wrappers from CLsPriors
+  py::class_<isis::CLsNativePrior, py::bases<isis::CLsPrior>, boost::noncopyable>
+    ("CLsNativePrior", py::no_init)
+    .def("evaluate", &isis::CLsNativePrior::evaluate)
+    ;
+
+  py::class_<isis::CLsFlatPrior, py::bases<isis::CLsNativePrior>, boost::noncopyable>
+    ("CLsFlatPrior", py::init<>())
+    ;
+
+  py::class_<isis::CLsGammaPrior, py::bases<isis::CLsNativePrior>, boost::noncopyable>
+    ("CLsGammaPrior", py::no_init)
+    .def("__init__", py::make_constructor(&CLsPrior::constructor<isis::CLsGammaPrior>))
+    ;
+
+  py::class_<isis::CLsGaussPrior, py::bases<isis::CLsNativePrior>, boost::noncopyable>
+    ("CLsGaussPrior", py::no_init)
+    .def("__init__", py::make_constructor(&CLsPrior::constructor<isis::CLsGaussPrior>))
+    ;
+
+  py::class_<isis::CLsLogNormPrior, py::bases<isis::CLsNativePrior>, boost::noncopyable>
+    ("CLsLogNormPrior", py::no_init)
+    .def("__init__", py::make_constructor(&CLsPrior::constructor<isis::CLsLogNormPrior>))
+    ;
+
   // Wrapper from CLsResult
   py::class_<isis::CLsResult>("CLsResult",
 			      py::init<
@@ -122,20 +179,65 @@ BOOST_PYTHON_MODULE( analysis ) {
     .def("isEvidence"           , &isis::CLsResult::isEvidence)
     ;
     
+  // Wrapper from CLsScanResult
+  py::class_<isis::CLsScanResult>("CLsScanResult", py::no_init)
+    .def("expectedCLb"       , &CLsScanRes::expectedCLb)
+    .def("expectedCLs"       , &CLsScanRes::expectedCLs)
+    .def("expectedCLsb"      , &CLsScanRes::expectedCLsb)
+    .def("expectedUpperLimit", &isis::CLsScanResult::expectedUpperLimit,
+	 CLsScanRes::expectedUpperLimit_Overloads())
+    .def("getMu"             , &CLsScanRes::getMu)
+    .def("hasObserved"       , &isis::CLsScanResult::hasObserved)
+    .def("observedCLb"       , &CLsScanRes::observedCLb)
+    .def("observedCLs"       , &CLsScanRes::observedCLs)
+    .def("observedCLsb"      , &CLsScanRes::observedCLsb)
+    .def("observedUpperLimit", &isis::CLsScanResult::observedUpperLimit,
+	 CLsScanRes::observedUpperLimit_Overloads())
+    ;
+
+  // Wrapper from CLsTSDistribution
+  py::class_<isis::CLsTSDistribution>("CLsTSDistribution",
+				      py::init<py::optional<size_t, size_t, size_t> >())
+    .def("countBelow", &isis::CLsTSDistribution::countBelow)
+    .def("fill"      , CLsTSDist::fill)
+    .def("fill"      , &CLsTSDist::fillArray)
+    .def("getEdges"  , &CLsTSDist::getEdges)
+    .def("getEntries", &isis::CLsTSDistribution::getEntries)
+    .def("isExact"   , &isis::CLsTSDistribution::isExact)
+    .def("merge"     , &isis::CLsTSDistribution::merge)
+    .def("quantile"  , &isis::CLsTSDistribution::quantile)
+    .def("reset"     , &isis::CLsTSDistribution::reset, CLsTSDist::reset_Overloads())
+    ;
+
   // Wrapper from CLsHypothesis
   py::class_<isis::CLsHypothesis>("CLsHypothesis", py::init<>())
     .def("__init__"        , py::make_constructor(&CLsHyp::constructor))
     .def("__init__"        , py::make_constructor(&CLsHyp::constructor_NoPrior))
     .def("__init__"        , py::make_constructor(&CLsHyp::constructor_NoFluctNoPrior))
+    .def("clearProposal"   , &isis::CLsHypothesis::clearProposal)
+    .def("clearToys"       , &isis::CLsHypothesis::clearToys)
     .def("pValue"          , &isis::CLsHypothesis::pValue)
+    .def("pValues"         , &CLsHyp::pValues)
+    .def("getEffectiveSize", &isis::CLsHypothesis::getEffectiveSize)
+    .def("getProposal"     , &CLsHyp::getProposal)
+    .def("getTSLogWeights" , &CLsHyp::getTSLogWeights)
     .def("getTSVals"       , &CLsHyp::getTSVals)
+    .def("getTSValsView"   , &CLsHyp::getTSValsView)
+    .def("getTSLogWeightsView", &CLsHyp::getTSLogWeightsView)
     .def("getHyp"          , &CLsHyp::getHyp)
-    .def("generate"        , &isis::CLsHypothesis::generate)
+    .def("getHypView"      , &CLsHyp::getHypView)
+    .def("getTSDistribution", &isis::CLsHypothesis::getTSDistribution,
+	 py::return_value_policy<py::copy_const_reference>())
+    .def("generate"        , CLsHyp::generate)
+    .def("generate"        , CLsHyp::generateParallel)
     .def("poissonProb"     , &CLsHyp::poissonProb)
     .def("setFactory"      , &isis::CLsHypothesis::setFactory)
     .def("setFluctuator"   , &isis::CLsHypothesis::setFluctuator)
     .def("setHyp"          , &CLsHyp::setHyp, CLsHyp::setHyp_Overloads())
     .def("setPrior"        , &isis::CLsHypothesis::setPrior)
+    .def("setProposal"     , &CLsHyp::setProposal)
+    .def("setProposal"     , &CLsHyp::setTiltedProposal, CLsHyp::setTiltedProposal_Overloads())
+    .def("setTSDistribution", &isis::CLsHypothesis::setTSDistribution)
     .def("testStatFromProb", &isis::CLsHypothesis::testStatFromProb)
     ;
 
@@ -152,15 +254,41 @@ BOOST_PYTHON_MODULE( analysis ) {
     .def("beta"            , &isis::CLsFactory::beta)
     .def("calculate"       , &CLsFact::calculateFromArray)
     .def("calculate"       , CLsFact::calculateFromDouble)
+    .def("calculateMany"   , &CLsFact::calculateMany)
     .def("CLb"             , &isis::CLsFactory::CLb)
     .def("CLs"             , &isis::CLsFactory::CLs)
     .def("CLsb"            , &isis::CLsFactory::CLsb)
-    .def("generate"        , &isis::CLsFactory::generate)
+    .def("generate"        , CLsFact::generate)
+    .def("generate"        , CLsFact::generateParallel)
+    .def("generate"        , &CLsFact::generateCheckpoint, CLsFact::generateCheckpoint_Overloads())
+    .def("merge"           , &CLsFact::merge)
+    .def("scan"            , &CLsFact::scan, CLsFact::scan_Overloads())
+    .staticmethod("scan")
     .def("testStat"        , &CLsFact::testStat)
+    .def("upperLimit"      , &CLsFact::upperLimit, CLsFact::upperLimit_Overloads())
+    .staticmethod("upperLimit")
     .add_property("NullHyp", &CLsFact::getNullHyp, &isis::CLsFactory::setNullHyp)
     .add_property("SigHyp" , &CLsFact::getSigHyp, &isis::CLsFactory::setSigHyp)
     ;
   
+  // Wrapper from CLsAsymptotic. The factory must outlive the calculator.
+  py::class_<isis::CLsAsymptotic>("CLsAsymptotic",
+				  py::init<isis::CLsFactory&>()[py::with_custodian_and_ward<1, 2>()])
+    .def("alpha"     , &isis::CLsAsymptotic::alpha)
+    .def("beta"      , &isis::CLsAsymptotic::beta)
+    .def("calculate" , &CLsAsy::calculateFromArray)
+    .def("calculate" , CLsAsy::calculateFromDouble)
+    .def("CLb"       , &isis::CLsAsymptotic::CLb)
+    .def("CLs"       , &isis::CLsAsymptotic::CLs)
+    .def("CLsb"      , &isis::CLsAsymptotic::CLsb)
+    .def("expected"  , &isis::CLsAsymptotic::expected, CLsAsy::expected_Overloads())
+    .def("scan"      , &CLsAsy::scan)
+    .staticmethod("scan")
+    .def("upperLimit", &CLsAsy::upperLimit, CLsAsy::upperLimit_Overloads())
+    .staticmethod("upperLimit")
+    .def("validate"  , &isis::CLsAsymptotic::validate, CLsAsy::validate_Overloads())
+    ;
+
   // Wrappers from RootUtils
   py::def("getSafeObject", &RootUtils::getSafeObject);
 }
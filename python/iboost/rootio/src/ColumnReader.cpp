@@ -0,0 +1,202 @@
+//////////////////////////////////////////////////////////////////////////////////
+//
+//  Python wrappers
+//
+// -------------------------------------------------------------------------------
+//
+//  AUTHOR: Miguel Ramos Pernas
+//  e-mail: miguel.ramos.pernas@cern.ch
+//
+//  Last update: 18/10/2026
+//
+// -------------------------------------------------------------------------------
+//////////////////////////////////////////////////////////////////////////////////
+
+
+#include "ColumnReader.hpp"
+
+#include "Definitions.hpp"
+#include "Exceptions.hpp"
+#include "TreeManagement.hpp"
+#include "ValueTypeDef.hpp"
+
+#include "Bytes.h"
+#include "TBranch.h"
+#include "TTree.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+
+//_______________________________________________________________________________
+
+namespace iboost {
+
+  //_______________________________________________________________________________
+  //
+  ColumnReader::ColumnReader( TTree *tree,
+			      const std::string &name,
+			      char *column,
+			      const size_t &stride ) :
+    fColumn(column), fSize(0), fStride(stride), fValue(0)
+#ifdef I_ROOT_BULK_IO
+    , fBulk(true), fBuffer(TBuffer::kWrite, 32*1024),
+    fBasketFirst(0), fBasketSize(0), fConvert(0)
+#endif
+  {
+
+    if ( !isis::isScalarBranch(tree, name) )
+      throw isis::BaseException("Branch < " + name + " > does not hold a single value");
+
+    fBranch = tree->GetBranch(name.c_str());
+
+    fType = isis::getVarType(tree, name);
+
+#define I_COLUMN_READER_SIZE( type, ptr ) fSize = sizeof(type)
+
+    I_SWITCH_BY_DATA_TYPE(fType, 0, I_COLUMN_READER_SIZE,
+			  throw isis::BaseException("Unknown type for branch < " + name + " >"));
+
+#undef I_COLUMN_READER_SIZE
+
+    fBranch->SetAddress(&fValue);
+
+#ifdef I_ROOT_BULK_IO
+    switch ( fSize ) {
+    case 1: fConvert = &ColumnReader::fromSerialized<UChar_t>;   break;
+    case 2: fConvert = &ColumnReader::fromSerialized<UShort_t>;  break;
+    case 4: fConvert = &ColumnReader::fromSerialized<UInt_t>;    break;
+    case 8: fConvert = &ColumnReader::fromSerialized<ULong64_t>; break;
+    default: fBulk = false; break;
+    }
+#endif
+  }
+
+  //_______________________________________________________________________________
+  //
+  ColumnReader::~ColumnReader() {
+
+    fBranch->ResetAddress();
+  }
+
+  //_______________________________________________________________________________
+  //
+  void ColumnReader::readRange( const Long64_t &first,
+				const Long64_t &last,
+				const size_t &pos ) {
+
+    if ( last > first )
+      this->readEntries(0, first, last - first, fColumn + pos*fStride);
+  }
+
+  //_______________________________________________________________________________
+  //
+  void ColumnReader::readSelected( const Long64_t *entries,
+				   const size_t &n,
+				   const size_t &pos ) {
+
+    this->readEntries(entries, 0, n, fColumn + pos*fStride);
+  }
+
+  //_______________________________________________________________________________
+  //
+  void ColumnReader::readEntries( const Long64_t *entries,
+				  const Long64_t &first,
+				  const size_t &n,
+				  char *out ) {
+
+    size_t i = 0;
+
+#ifdef I_ROOT_BULK_IO
+
+    // The values are taken from whole baskets, until all the entries are
+    // processed or the bulk API fails
+    while ( fBulk && i < n ) {
+
+      const Long64_t entry = entries ? entries[i] : first + i;
+
+      if ( !this->loadBasket(entry) )
+	break;
+
+      const Long64_t end = fBasketFirst + fBasketSize;
+
+      char *data = fBuffer.GetCurrent();
+
+      size_t j;
+      if ( entries ) {
+	j = std::lower_bound(entries + i, entries + n, end) - entries;
+	fConvert(data, entries + i, fBasketFirst, j - i, out + i*fStride, fStride);
+      }
+      else {
+	j = std::min<Long64_t>(n, end - first);
+	fConvert(data + (entry - fBasketFirst)*fSize, 0, 0, j - i, out + i*fStride, fStride);
+      }
+
+      i = j;
+    }
+
+#endif
+
+    // The remaining entries are read one by one
+    for ( out += i*fStride; i < n; ++i, out += fStride ) {
+
+      fBranch->GetEntry(entries ? entries[i] : first + i);
+
+      std::memcpy(out, &fValue, fSize);
+    }
+  }
+
+#ifdef I_ROOT_BULK_IO
+
+  //_______________________________________________________________________________
+  //
+  template<class type>
+  void ColumnReader::fromSerialized( char *data,
+				     const Long64_t *entries,
+				     const Long64_t &first,
+				     const size_t &n,
+				     char *out,
+				     const size_t &stride ) {
+
+    for ( size_t i = 0; i < n; ++i, out += stride ) {
+
+      char *ptr = data + (entries ? entries[i] - first : i)*sizeof(type);
+
+      type value;
+      frombuf(ptr, &value);
+
+      std::memcpy(out, &value, sizeof(type));
+    }
+  }
+
+  //_______________________________________________________________________________
+  //
+  bool ColumnReader::loadBasket( const Long64_t &entry ) {
+
+    if ( entry >= fBasketFirst && entry < fBasketFirst + fBasketSize )
+      return true;
+
+    // First entry of the basket containing the requested entry. The bulk API
+    // returns the entries of a basket starting from the first one.
+    const Long64_t *bfirst = fBranch->GetBasketEntry();
+    const Int_t nbaskets   = fBranch->GetWriteBasket() + 1;
+
+    fBasketFirst = *(std::upper_bound(bfirst, bfirst + nbaskets, entry) - 1);
+
+    const Int_t count = fBranch->GetBulkRead().GetEntriesSerialized(fBasketFirst, fBuffer);
+
+    if ( count <= 0 || entry >= fBasketFirst + count ) {
+      fBulk = false;
+      fBasketSize = 0;
+      return false;
+    }
+
+    fBasketSize = count;
+
+    return true;
+  }
+
+#endif
+
+}
@@ -0,0 +1,164 @@
+//////////////////////////////////////////////////////////////////////////////////
+//
+//  Python wrappers
+//
+// -------------------------------------------------------------------------------
+//
+//  AUTHOR: Miguel Ramos Pernas
+//  e-mail: miguel.ramos.pernas@cern.ch
+//
+//  Last update: 18/10/2026
+//
+// -------------------------------------------------------------------------------
+//
+//  Description:
+//
+//  Define the class to read the values of a branch of a Root tree and write
+//  them in a column of a numpy structured array. The type of the branch is
+//  resolved on construction, so no decisions are taken for each entry. If the
+//  Root version provides the bulk API, the baskets are decompressed at once
+//  and their content is copied to the column; otherwise the values are read
+//  with < TBranch::GetEntry > into an internal address. The entries must be
+//  requested in increasing order.
+//
+// -------------------------------------------------------------------------------
+//////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef COLUMN_READER_H
+#define COLUMN_READER_H
+
+#include "Definitions.hpp"
+
+#include "RVersion.h"
+#include "TBranch.h"
+#include "TTree.h"
+
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,14,0)
+#define I_ROOT_BULK_IO
+#include "TBufferFile.h"
+#endif
+
+#include <string>
+
+
+//_______________________________________________________________________________
+
+namespace iboost {
+
+  class ColumnReader {
+
+  public:
+
+    // Constructor given the tree, the name of the branch, the position of the
+    // first element of the column and the separation between elements (in bytes)
+    ColumnReader( TTree *tree,
+		  const std::string &name,
+		  char *column,
+		  const size_t &stride );
+
+    // Destructor
+    ~ColumnReader();
+
+    // Return the type of the branch
+    inline char getType() const;
+
+    // Read the entries in [ first, last ), writing them in the column starting
+    // at position < pos >
+    void readRange( const Long64_t &first, const Long64_t &last, const size_t &pos );
+
+    // Read the < n > given entries, writing them in the column starting at
+    // position < pos >
+    void readSelected( const Long64_t *entries, const size_t &n, const size_t &pos );
+
+    // Set the position of the first element of the column
+    inline void setColumn( char *column );
+
+  protected:
+
+    // Branch to read
+    TBranch *fBranch;
+
+    // Position of the first element of the column
+    char *fColumn;
+
+    // Size of the values
+    size_t fSize;
+
+    // Separation between the elements in the column
+    size_t fStride;
+
+    // Type of the branch
+    char fType;
+
+    // Address of the branch when reading entry by entry
+    Long64_t fValue;
+
+#ifdef I_ROOT_BULK_IO
+
+    // Whether the bulk API can be used for this branch
+    bool fBulk;
+
+    // Buffer holding the serialized content of the last basket
+    TBufferFile fBuffer;
+
+    // First entry and number of entries of the basket in the buffer
+    Long64_t fBasketFirst;
+    Long64_t fBasketSize;
+
+    // Function to convert the serialized values (big-endian) to the column
+    void (*fConvert)( char *data,
+		      const Long64_t *entries,
+		      const Long64_t &first,
+		      const size_t &n,
+		      char *out,
+		      const size_t &stride );
+
+#endif
+
+  private:
+
+    // Read the < n > entries, which are given by < entries > or, if null,
+    // start at < first >, writing them in < out >
+    void readEntries( const Long64_t *entries,
+		      const Long64_t &first,
+		      const size_t &n,
+		      char *out );
+
+#ifdef I_ROOT_BULK_IO
+
+    // Convert the serialized values. If < entries > is given, the values are
+    // located at < entries[i] - first >, otherwise they are consecutive.
+    template<class type>
+    static void fromSerialized( char *data,
+				const Long64_t *entries,
+				const Long64_t &first,
+				const size_t &n,
+				char *out,
+				const size_t &stride );
+
+    // Load the basket containing the given entry. If the bulk API can not be
+    // used, it is disabled and "false" is returned.
+    bool loadBasket( const Long64_t &entry );
+
+#endif
+
+  };
+
+  //_______________________________________________________________________________
+  //
+  inline char ColumnReader::getType() const {
+
+    return fType;
+  }
+
+  //_______________________________________________________________________________
+  //
+  inline void ColumnReader::setColumn( char *column ) {
+
+    fColumn = column;
+  }
+
+}
+
+#endif
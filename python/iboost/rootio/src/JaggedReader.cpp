@@ -0,0 +1,185 @@
+//////////////////////////////////////////////////////////////////////////////////
+//
+//  Python wrappers
+//
+// -------------------------------------------------------------------------------
+//
+//  AUTHOR: Miguel Ramos Pernas
+//  e-mail: miguel.ramos.pernas@cern.ch
+//
+//  Last update: 18/10/2026
+//
+// -------------------------------------------------------------------------------
+//////////////////////////////////////////////////////////////////////////////////
+
+
+#include "JaggedReader.hpp"
+
+#include "Definitions.hpp"
+#include "Exceptions.hpp"
+#include "TreeManagement.hpp"
+#include "ValueTypeDef.hpp"
+
+#include "TBranch.h"
+#include "TBranchElement.h"
+#include "TLeaf.h"
+#include "TObjArray.h"
+#include "TTree.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+
+//_______________________________________________________________________________
+
+namespace iboost {
+
+  //_______________________________________________________________________________
+  // Branches holding std::vector<bool> objects are rejected on construction,
+  // since the elements are not stored contiguously
+  template<>
+  const char* JaggedReader::vectorData<bool>( void *, size_t &n ) {
+
+    n = 0;
+    
+    return 0;
+  }
+  
+  //_______________________________________________________________________________
+  //
+  JaggedReader::JaggedReader( TTree *tree, const std::string &name ) :
+    fCountBranch(0), fLeaf(0), fOffsets(1, 0), fSize(0), fVector(0),
+    fVectorDelete(0), fVectorData(0) {
+
+    fBranch = tree->GetBranch(name.c_str());
+    if ( !fBranch )
+      throw isis::NotFound("branch", name);
+
+    if ( dynamic_cast<TBranchElement*>(fBranch) ) {
+
+      fType = vectorType(fBranch->GetClassName());
+
+      if ( fType == 'O' )
+	throw isis::BaseException("Branches holding std::vector<bool> are not supported");
+
+#define I_JAGGED_READER_VECTOR( type, ptr )				\
+      ptr           = new std::vector<type>;				\
+      fVectorData   = &JaggedReader::vectorData<type>;			\
+      fVectorDelete = &JaggedReader::vectorDelete<type>;		\
+      fSize         = sizeof(type)
+      
+      I_SWITCH_BY_DATA_TYPE(fType, fVector, I_JAGGED_READER_VECTOR,
+			    throw isis::BaseException("Unknown type for branch < " + name + " >"));
+
+#undef I_JAGGED_READER_VECTOR
+
+      fBranch->SetAddress(&fVector);
+    }
+    else {
+
+      TObjArray *leaves = fBranch->GetListOfLeaves();
+      if ( leaves->GetEntries() != 1 )
+	throw isis::BaseException("Branch < " + name + " > does not hold a single leaf");
+
+      fLeaf = static_cast<TLeaf*>(leaves->At(0));
+      fType = isis::getVarType(tree, name);
+
+#define I_JAGGED_READER_SIZE( type, ptr ) fSize = sizeof(type)
+
+      I_SWITCH_BY_DATA_TYPE(fType, 0, I_JAGGED_READER_SIZE,
+			    throw isis::BaseException("Unknown type for branch < " + name + " >"));
+
+#undef I_JAGGED_READER_SIZE
+
+      // The leaf allocates its own storage, with space for the maximum number
+      // of values
+      fBranch->ResetAddress();
+
+      // The number of values of variable-length arrays is stored in another
+      // branch, which must be read first
+      if ( fLeaf->GetLeafCount() ) {
+
+	fCountBranch = fLeaf->GetLeafCount()->GetBranch();
+
+	tree->SetBranchStatus(fCountBranch->GetName(), 1);
+      }
+    }
+  }
+
+  //_______________________________________________________________________________
+  //
+  JaggedReader::~JaggedReader() {
+
+    fBranch->ResetAddress();
+    
+    if ( fVector )
+      fVectorDelete(fVector);
+  }
+
+  //_______________________________________________________________________________
+  //
+  void JaggedReader::readRange( const Long64_t &first, const Long64_t &last ) {
+
+    fOffsets.reserve(fOffsets.size() + last - first);
+    
+    for ( Long64_t ievt = first; ievt < last; ++ievt )
+      this->readEntry(ievt);
+  }
+
+  //_______________________________________________________________________________
+  //
+  void JaggedReader::readSelected( const Long64_t *entries, const size_t &n ) {
+
+    fOffsets.reserve(fOffsets.size() + n);
+    
+    for ( size_t i = 0; i < n; ++i )
+      this->readEntry(entries[i]);
+  }
+
+  //_______________________________________________________________________________
+  //
+  char JaggedReader::vectorType( const std::string &cl ) {
+
+    static const std::map<std::string, char> types = {
+      {"vector<char>", 'B'}, {"vector<Char_t>", 'B'},
+      {"vector<unsigned char>", 'b'}, {"vector<UChar_t>", 'b'},
+      {"vector<short>", 'S'}, {"vector<Short_t>", 'S'},
+      {"vector<unsigned short>", 's'}, {"vector<UShort_t>", 's'},
+      {"vector<int>", 'I'}, {"vector<Int_t>", 'I'},
+      {"vector<unsigned int>", 'i'}, {"vector<UInt_t>", 'i'},
+      {"vector<float>", 'F'}, {"vector<Float_t>", 'F'},
+      {"vector<double>", 'D'}, {"vector<Double_t>", 'D'},
+      {"vector<long long>", 'L'}, {"vector<Long64_t>", 'L'},
+      {"vector<unsigned long long>", 'l'}, {"vector<ULong64_t>", 'l'},
+      {"vector<bool>", 'O'}, {"vector<Bool_t>", 'O'}
+    };
+
+    auto it = types.find(cl);
+    if ( it == types.end() )
+      throw isis::BaseException("Branches holding objects of class < " + cl + " > are not supported");
+
+    return it->second;
+  }
+
+  //_______________________________________________________________________________
+  //
+  template<class type>
+  const char* JaggedReader::vectorData( void *vec, size_t &n ) {
+
+    const std::vector<type> &v = *static_cast<std::vector<type>*>(vec);
+
+    n = v.size();
+    
+    return reinterpret_cast<const char*>(v.data());
+  }
+
+  //_______________________________________________________________________________
+  //
+  template<class type>
+  void JaggedReader::vectorDelete( void *vec ) {
+
+    delete static_cast<std::vector<type>*>(vec);
+  }
+
+}
@@ -0,0 +1,187 @@
+//////////////////////////////////////////////////////////////////////////////////
+//
+//  Python wrappers
+//
+// -------------------------------------------------------------------------------
+//
+//  AUTHOR: Miguel Ramos Pernas
+//  e-mail: miguel.ramos.pernas@cern.ch
+//
+//  Last update: 18/10/2026
+//
+// -------------------------------------------------------------------------------
+//
+//  Description:
+//
+//  Define the class to read a branch holding a different number of values per
+//  entry: fixed-size arrays ("x[3]/D"), variable-length arrays ("x[n]/D") and
+//  std::vector objects. The values of all the entries are stored one after
+//  the other (content), together with the position where the values of each
+//  entry start (offsets), which has one more element than the number of
+//  entries. The values of an entry are copied at once. The entries must be
+//  requested in increasing order.
+//
+// -------------------------------------------------------------------------------
+//////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef JAGGED_READER_H
+#define JAGGED_READER_H
+
+#include "Definitions.hpp"
+
+#include "TBranch.h"
+#include "TLeaf.h"
+#include "TTree.h"
+
+#include <string>
+#include <vector>
+
+
+//_______________________________________________________________________________
+
+namespace iboost {
+
+  class JaggedReader {
+
+  public:
+
+    // Constructor given the tree and the name of the branch
+    JaggedReader( TTree *tree, const std::string &name );
+
+    // Destructor
+    ~JaggedReader();
+
+    // Return the values of all the entries read
+    inline const std::vector<char>& getContent() const;
+
+    // Return the position of the first value of each entry read, and the
+    // total number of values
+    inline const std::vector<Long64_t>& getOffsets() const;
+
+    // Return the name of the branch
+    inline std::string getName() const;
+
+    // Return the size of each value
+    inline size_t getSize() const;
+
+    // Return the type of the values
+    inline char getType() const;
+
+    // Read the entries in [ first, last )
+    void readRange( const Long64_t &first, const Long64_t &last );
+
+    // Read the < n > given entries
+    void readSelected( const Long64_t *entries, const size_t &n );
+
+  protected:
+
+    // Branch to read
+    TBranch *fBranch;
+
+    // Values of the entries
+    std::vector<char> fContent;
+
+    // Branch with the number of elements (variable-length arrays)
+    TBranch *fCountBranch;
+
+    // Leaf holding the values (arrays)
+    TLeaf *fLeaf;
+
+    // Position of the first value of each entry
+    std::vector<Long64_t> fOffsets;
+
+    // Size of the values
+    size_t fSize;
+
+    // Type of the values
+    char fType;
+
+    // Vector where the values are read (std::vector branches)
+    void *fVector;
+
+    // Function to delete the vector
+    void (*fVectorDelete)( void *vec );
+
+    // Function to access the data of the vector and its size
+    const char* (*fVectorData)( void *vec, size_t &n );
+
+  private:
+
+    // Read the given entry, appending its values
+    inline void readEntry( const Long64_t &entry );
+
+    // Return the type associated to the values of the given vector class
+    static char vectorType( const std::string &cl );
+
+    // Return the data of a vector of the given type, and its size
+    template<class type>
+    static const char* vectorData( void *vec, size_t &n );
+
+    // Delete a vector of the given type
+    template<class type>
+    static void vectorDelete( void *vec );
+
+  };
+
+  //_______________________________________________________________________________
+  //
+  inline const std::vector<char>& JaggedReader::getContent() const {
+
+    return fContent;
+  }
+
+  //_______________________________________________________________________________
+  //
+  inline const std::vector<Long64_t>& JaggedReader::getOffsets() const {
+
+    return fOffsets;
+  }
+
+  //_______________________________________________________________________________
+  //
+  inline std::string JaggedReader::getName() const {
+
+    return fBranch->GetName();
+  }
+
+  //_______________________________________________________________________________
+  //
+  inline size_t JaggedReader::getSize() const {
+
+    return fSize;
+  }
+
+  //_______________________________________________________________________________
+  //
+  inline char JaggedReader::getType() const {
+
+    return fType;
+  }
+
+  //_______________________________________________________________________________
+  //
+  inline void JaggedReader::readEntry( const Long64_t &entry ) {
+
+    const char *data;
+    size_t n;
+    
+    if ( fVector ) {
+      fBranch->GetEntry(entry);
+      data = fVectorData(fVector, n);
+    }
+    else {
+      if ( fCountBranch )
+	fCountBranch->GetEntry(entry);
+      fBranch->GetEntry(entry);
+      data = static_cast<const char*>(fLeaf->GetValuePointer());
+      n    = fLeaf->GetLen();
+    }
+
+    fContent.insert(fContent.end(), data, data + n*fSize);
+    fOffsets.push_back(fOffsets.back() + n);
+  }
+
+}
+
+#endif
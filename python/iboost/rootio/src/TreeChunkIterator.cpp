@@ -0,0 +1,263 @@
+//////////////////////////////////////////////////////////////////////////////////
+//
+//  Python wrappers
+//
+// -------------------------------------------------------------------------------
+//
+//  AUTHOR: Miguel Ramos Pernas
+//  e-mail: miguel.ramos.pernas@cern.ch
+//
+//  Last update: 18/10/2026
+//
+// -------------------------------------------------------------------------------
+//////////////////////////////////////////////////////////////////////////////////
+
+
+#include "GlobalWrappers.hpp"
+#include "NumpyUtils.hpp"
+#include "TreeChunkIterator.hpp"
+#include "TreeReader.hpp"
+#include "TreeWrapper.hpp"
+
+#include <Python.h>
+#include <boost/python/errors.hpp>
+#include <boost/python/extract.hpp>
+#include <boost/python/list.hpp>
+#include <boost/python/object.hpp>
+#include <boost/python/slice.hpp>
+
+#include "Definitions.hpp"
+#include "Exceptions.hpp"
+#include "RootUtils.hpp"
+#include "TreeManagement.hpp"
+
+#include "TFile.h"
+#include "TROOT.h"
+#include "TTree.h"
+
+#include <memory>
+#include <string>
+
+
+//_______________________________________________________________________________
+
+namespace iboost {
+
+  //_______________________________________________________________________________
+  //
+  TreeChunkIterator::TreeChunkIterator( py::object paths,
+					const std::string &tpath,
+					py::object vars,
+					const size_t &chunksize,
+					const std::string &cuts,
+					const bool &use_regex ) :
+    fChunkSize(chunksize), fCluster(0), fCuts(cuts), fEntry(0),
+    fFile(0), fFilling(0), fNextFile(0), fNfilled(0), fReader(0),
+    fTreePath(tpath) {
+
+    if ( !fChunkSize )
+      throw isis::BaseException("The size of the chunks must be greater than zero");
+    
+    py::extract<std::string> single(paths);
+    if ( single.check() )
+      fPaths.push_back(single());
+    else {
+      py::list lst = py::extract<py::list>(paths);
+      fPaths = boostListToStdCont<std::vector, std::string>(lst);
+    }
+
+    if ( fPaths.empty() )
+      throw isis::BaseException("At least one file must be provided");
+
+    // The variables are determined from the first file
+    {
+      std::unique_ptr<TFile> file(TFile::Open(fPaths[0].c_str()));
+      if ( !file )
+	throw isis::BaseException("Unable to open file < " + fPaths[0] + " >");
+      
+      TTree *tree = static_cast<TTree*>(isis::getSafeObject(file.get(), fTreePath));
+
+      fTypes = getBranchTypes(tree, vars, use_regex);
+
+      file->Close();
+    }
+
+    // Build the buffers
+    for ( size_t i = 0; i < 2; ++i ) {
+      
+      fBuffers.push_back(void_ndarray(fChunkSize, fTypes));
+
+      fColumns[i] = struct_array_columns(fBuffers[i]);
+    }
+    
+    fStride = fBuffers[0].get_dtype().get_itemsize();
+
+    // The files are opened in the background thread
+    ROOT::EnableThreadSafety();
+
+    this->startFill(0);
+  }
+
+  //_______________________________________________________________________________
+  //
+  TreeChunkIterator::~TreeChunkIterator() {
+
+    if ( fThread.joinable() )
+      fThread.join();
+    
+    this->closeFile();
+  }
+
+  //_______________________________________________________________________________
+  //
+  np::ndarray TreeChunkIterator::next() {
+
+    this->wait();
+
+    const size_t current = fFilling;
+    const size_t n       = fNfilled;
+
+    if ( !n ) {
+      PyErr_SetString(PyExc_StopIteration, "No more entries to read");
+      py::throw_error_already_set();
+    }
+
+    // The next chunk is read in the other buffer, unless the array returned
+    // from it is still in use
+    this->releaseBuffer(1 - current);
+    this->startFill(1 - current);
+
+    if ( n == fChunkSize )
+      return fBuffers[current];
+    else
+      return py::extract<np::ndarray>(fBuffers[current][py::slice(0, n)]);
+  }
+
+  //_______________________________________________________________________________
+  //
+  void TreeChunkIterator::closeFile() {
+
+    delete fReader;
+    fReader = 0;
+    
+    if ( fFile ) {
+      fFile->Close();
+      delete fFile;
+      fFile = 0;
+    }
+
+    fClusters.clear();
+  }
+
+  //_______________________________________________________________________________
+  //
+  void TreeChunkIterator::fill() {
+
+    if ( fReader )
+      fReader->setColumns(fColumns[fFilling]);
+    
+    // The entries are read cluster by cluster, moving to the next file when
+    // the current is exhausted
+    while ( fNfilled < fChunkSize ) {
+
+      if ( fCluster + 1 >= fClusters.size() ) {
+	if ( !this->openNext() )
+	  break;
+	continue;
+      }
+
+      const Long64_t last = fClusters[fCluster + 1];
+
+      fNfilled += fReader->read(fEntry, last, fNfilled, fChunkSize - fNfilled);
+
+      if ( fEntry == last )
+	++fCluster;
+    }
+  }
+
+  //_______________________________________________________________________________
+  //
+  bool TreeChunkIterator::openNext() {
+
+    this->closeFile();
+    
+    while ( fNextFile < fPaths.size() ) {
+
+      const std::string &path = fPaths[fNextFile++];
+      
+      fFile = TFile::Open(path.c_str());
+      if ( !fFile )
+	throw isis::BaseException("Unable to open file < " + path + " >");
+
+      TTree *tree = static_cast<TTree*>(isis::getSafeObject(fFile, fTreePath));
+
+      for ( const auto &el : fTypes )
+	if ( isis::getVarType(tree, el.first) != el.second )
+	  throw isis::BaseException("The type of branch < " + el.first +
+				    " > in file < " + path +
+				    " > differs from that in the first file");
+      
+      fClusters = TreeReader::getClusters(tree);
+
+      if ( fClusters.size() > 1 ) {
+	
+	fReader  = new TreeReader(tree, fColumns[fFilling], fStride, fCuts);
+	fCluster = 0;
+	fEntry   = 0;
+	
+	return true;
+      }
+      
+      this->closeFile();
+    }
+
+    return false;
+  }
+
+  //_______________________________________________________________________________
+  //
+  void TreeChunkIterator::releaseBuffer( const size_t &buffer ) {
+
+    // The only reference is that held by this class
+    if ( Py_REFCNT(fBuffers[buffer].ptr()) == 1 )
+      return;
+
+    fBuffers[buffer] = void_ndarray(fChunkSize, fTypes);
+
+    fColumns[buffer] = struct_array_columns(fBuffers[buffer]);
+  }
+
+  //_______________________________________________________________________________
+  //
+  void TreeChunkIterator::startFill( const size_t &buffer ) {
+
+    fFilling = buffer;
+    fNfilled = 0;
+
+    fThread = std::thread([this] () {
+	try {
+	  this->fill();
+	}
+	catch ( ... ) {
+	  fError = std::current_exception();
+	}
+      });
+  }
+
+  //_______________________________________________________________________________
+  //
+  void TreeChunkIterator::wait() {
+
+    if ( fThread.joinable() )
+      fThread.join();
+
+    if ( fError ) {
+
+      std::exception_ptr error = fError;
+      fError = std::exception_ptr();
+      
+      std::rethrow_exception(error);
+    }
+  }
+
+}
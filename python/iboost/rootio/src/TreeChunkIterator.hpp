@@ -0,0 +1,156 @@
+//////////////////////////////////////////////////////////////////////////////////
+//
+//  Python wrappers
+//
+// -------------------------------------------------------------------------------
+//
+//  AUTHOR: Miguel Ramos Pernas
+//  e-mail: miguel.ramos.pernas@cern.ch
+//
+//  Last update: 18/10/2026
+//
+// -------------------------------------------------------------------------------
+//
+//  Description:
+//
+//  Define the class to iterate over the entries of a tree, stored in one or
+//  several files, in chunks of a fixed size. Each chunk is returned as a numpy
+//  structured array. Two buffers are used: while one of them is returned,
+//  the next chunk is read on a background thread into the other. A buffer is
+//  only filled again if no array returned from it is referenced anymore;
+//  otherwise a new one is allocated, so the chunks remain valid while they
+//  are kept. The last chunk may be smaller.
+//
+// -------------------------------------------------------------------------------
+//////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef TREE_CHUNK_ITERATOR_H
+#define TREE_CHUNK_ITERATOR_H
+
+#include "GlobalWrappers.hpp"
+#include "TreeReader.hpp"
+
+#include <boost/python/object.hpp>
+
+#include "Definitions.hpp"
+
+#include "TFile.h"
+#include "TTree.h"
+
+#include <exception>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+//_______________________________________________________________________________
+
+namespace iboost {
+
+  class TreeChunkIterator {
+
+  public:
+
+    // Constructor given the path(s) to the file(s), the path to the tree in
+    // them, the variables to read (all of them if empty), the size of the
+    // chunks, the cuts and whether the variables are regular expressions. The
+    // variables are resolved using the tree in the first file.
+    TreeChunkIterator( py::object paths,
+		       const std::string &tpath,
+		       py::object vars = py::list(),
+		       const size_t &chunksize = 100000,
+		       const std::string &cuts = std::string(),
+		       const bool &use_regex = false );
+
+    // Destructor
+    ~TreeChunkIterator();
+
+    // Return the next chunk. If there are no more entries, the python
+    // exception "StopIteration" is raised.
+    np::ndarray next();
+
+  protected:
+
+    // Buffers where the chunks are written
+    std::vector<np::ndarray> fBuffers;
+
+    // Size of the chunks
+    size_t fChunkSize;
+
+    // Boundaries of the clusters of the current tree
+    std::vector<Long64_t> fClusters;
+
+    // Columns of each of the buffers
+    std::map<std::string, char*> fColumns[2];
+
+    // Index of the current cluster
+    size_t fCluster;
+
+    // Cuts to apply
+    std::string fCuts;
+
+    // Next entry to read in the current tree
+    Long64_t fEntry;
+
+    // Error raised in the background thread
+    std::exception_ptr fError;
+
+    // Current file
+    TFile *fFile;
+
+    // Index of the buffer being filled
+    size_t fFilling;
+
+    // Index of the next file to open
+    size_t fNextFile;
+
+    // Number of entries in the buffer being filled
+    size_t fNfilled;
+
+    // Paths to the files
+    isis::Strings fPaths;
+
+    // Reader of the current tree
+    TreeReader *fReader;
+
+    // Size of the rows of the buffers
+    size_t fStride;
+
+    // Thread filling the next buffer
+    std::thread fThread;
+
+    // Path to the tree in the files
+    std::string fTreePath;
+
+    // Types of the variables
+    std::map<std::string, char> fTypes;
+
+  private:
+
+    // Close the current file, if any
+    void closeFile();
+
+    // Fill the buffer with index < fFilling >, setting < fNfilled >
+    void fill();
+
+    // Open the next file with entries. Returns "false" if there are no more
+    // files.
+    bool openNext();
+
+    // Replace the given buffer by a new one if it is still referenced from
+    // python
+    void releaseBuffer( const size_t &buffer );
+
+    // Start filling the given buffer on the background thread
+    void startFill( const size_t &buffer );
+
+    // Wait for the background thread to finish, propagating its errors
+    void wait();
+
+  };
+
+}
+
+#endif
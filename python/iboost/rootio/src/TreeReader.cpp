@@ -0,0 +1,202 @@
+//////////////////////////////////////////////////////////////////////////////////
+//
+//  Python wrappers
+//
+// -------------------------------------------------------------------------------
+//
+//  AUTHOR: Miguel Ramos Pernas
+//  e-mail: miguel.ramos.pernas@cern.ch
+//
+//  Last update: 18/10/2026
+//
+// -------------------------------------------------------------------------------
+//////////////////////////////////////////////////////////////////////////////////
+
+
+#include "ColumnReader.hpp"
+#include "JaggedReader.hpp"
+#include "TreeReader.hpp"
+
+#include "Definitions.hpp"
+#include "Exceptions.hpp"
+
+#include "TBranch.h"
+#include "TLeaf.h"
+#include "TTree.h"
+#include "TTreeFormula.h"
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+
+//_______________________________________________________________________________
+
+namespace iboost {
+
+  //_______________________________________________________________________________
+  //
+  TreeReader::TreeReader( TTree *tree,
+			  const std::map<std::string, char*> &columns,
+			  const size_t &stride,
+			  const std::string &cuts,
+			  const isis::Strings &jagged ) :
+    fFormula(0), fTree(tree) {
+
+    fTree->SetBranchStatus("*", 0);
+
+    try {
+
+      // The formula reads by itself the branches it depends on
+      if ( !cuts.empty() ) {
+
+	fFormula = new TTreeFormula("cuts", cuts.c_str(), fTree);
+
+	if ( !fFormula->GetNdim() )
+	  throw isis::BaseException("Unable to compile the cuts < " + cuts + " >");
+        
+	for ( int i = 0; i < fFormula->GetNcodes(); ++i ) {
+
+	  TLeaf *leaf = fFormula->GetLeaf(i);
+
+	  if ( leaf ) {
+	    const char *name = leaf->GetBranch()->GetName();
+	    fTree->SetBranchStatus(name, 1);
+	    fTree->AddBranchToCache(name, true);
+	  }
+	}
+      }
+      
+      // The branches are registered in the cache so the baskets of a cluster
+      // are read in one go
+      fReaders.reserve(columns.size());
+      for ( const auto &el : columns ) {
+
+	fTree->SetBranchStatus(el.first.c_str(), 1);
+        
+	fReaders.push_back(new ColumnReader(fTree, el.first, el.second, stride));
+
+	fTree->AddBranchToCache(el.first.c_str(), true);
+      }
+
+      fJagged.reserve(jagged.size());
+      for ( const auto &name : jagged ) {
+
+	fTree->SetBranchStatus(name.c_str(), 1);
+        
+	fJagged.push_back(new JaggedReader(fTree, name));
+
+	fTree->AddBranchToCache(name.c_str(), true);
+      }
+
+      fTree->StopCacheLearningPhase();
+    }
+    catch ( ... ) {
+      // The destructor is not called if the constructor fails
+      this->release();
+      throw;
+    }
+  }
+
+  //_______________________________________________________________________________
+  //
+  TreeReader::~TreeReader() {
+
+    this->release();
+  }
+
+  //_______________________________________________________________________________
+  //
+  size_t TreeReader::read( Long64_t &first,
+			   const Long64_t &last,
+			   const size_t &pos,
+			   const size_t &nmax ) {
+
+    if ( !fFormula ) {
+
+      Long64_t end = last;
+      if ( size_t(last - first) > nmax )
+	end = first + nmax;
+      
+      for ( auto &r : fReaders )
+	r->readRange(first, end, pos);
+
+      for ( auto &r : fJagged )
+	r->readRange(first, end);
+
+      const size_t n = end - first;
+      
+      first = end;
+
+      return n;
+    }
+    
+    fSelected.clear();
+	
+    for ( ; first < last && fSelected.size() < nmax; ++first ) {
+
+      fTree->LoadTree(first);
+
+      // As in < TTree::Draw >, an entry is selected if any of the instances
+      // of the formula is satisfied
+      const int ndata = fFormula->GetNdata();
+      for ( int i = 0; i < ndata; ++i )
+	if ( fFormula->EvalInstance(i) ) {
+	  fSelected.push_back(first);
+	  break;
+	}
+    }
+	
+    for ( auto &r : fReaders )
+      r->readSelected(fSelected.data(), fSelected.size(), pos);
+
+    for ( auto &r : fJagged )
+      r->readSelected(fSelected.data(), fSelected.size());
+
+    return fSelected.size();
+  }
+
+  //_______________________________________________________________________________
+  //
+  void TreeReader::release() {
+
+    delete fFormula;
+    fFormula = 0;
+
+    for ( auto &r : fReaders )
+      delete r;
+    fReaders.clear();
+
+    for ( auto &r : fJagged )
+      delete r;
+    fJagged.clear();
+
+    fTree->SetBranchStatus("*", 1);
+  }
+
+  //_______________________________________________________________________________
+  //
+  void TreeReader::setColumns( const std::map<std::string, char*> &columns ) {
+
+    auto itr = fReaders.begin();
+    for ( auto it = columns.cbegin(); it != columns.cend(); ++it, ++itr )
+      (*itr)->setColumn(it->second);
+  }
+
+  //_______________________________________________________________________________
+  //
+  std::vector<Long64_t> TreeReader::getClusters( TTree *tree ) {
+
+    const Long64_t nentries = tree->GetEntries();
+    
+    std::vector<Long64_t> bounds(1, 0);
+    
+    TTree::TClusterIterator clusters = tree->GetClusterIterator(0);
+    while ( clusters() < nentries )
+      bounds.push_back(std::min(clusters.GetNextEntry(), nentries));
+
+    return bounds;
+  }
+
+}
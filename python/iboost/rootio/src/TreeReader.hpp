@@ -0,0 +1,116 @@
+//////////////////////////////////////////////////////////////////////////////////
+//
+//  Python wrappers
+//
+// -------------------------------------------------------------------------------
+//
+//  AUTHOR: Miguel Ramos Pernas
+//  e-mail: miguel.ramos.pernas@cern.ch
+//
+//  Last update: 18/10/2026
+//
+// -------------------------------------------------------------------------------
+//
+//  Description:
+//
+//  Define the class to read a set of branches of a Root tree in the columns of
+//  a numpy structured array, applying a set of cuts. Only the branches needed
+//  are enabled. For each block of entries, the cuts are evaluated first (the
+//  formula reads by itself the branches it depends on), and then each branch
+//  is read for all the selected entries at once. The entries must be
+//  requested in increasing order, and preferably within the same cluster, so
+//  the baskets are read only once.
+//
+// -------------------------------------------------------------------------------
+//////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef TREE_READER_H
+#define TREE_READER_H
+
+#include "ColumnReader.hpp"
+#include "JaggedReader.hpp"
+
+#include "Definitions.hpp"
+
+#include "TTree.h"
+#include "TTreeFormula.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+
+//_______________________________________________________________________________
+
+namespace iboost {
+
+  class TreeReader {
+
+  public:
+
+    // Constructor given the tree, the columns where to write the branches
+    // (whose elements are separated by < stride > bytes) and the cuts.
+    // Branches holding several values per entry can also be read, and their
+    // values are kept by the readers (see < JaggedReader >).
+    TreeReader( TTree *tree,
+		const std::map<std::string, char*> &columns,
+		const size_t &stride,
+		const std::string &cuts = std::string(),
+		const isis::Strings &jagged = isis::Strings() );
+
+    // Destructor. The branches of the tree are enabled again.
+    ~TreeReader();
+
+    // Read the entries from < first > to < last > (not included) satisfying
+    // the cuts, writing them in the columns starting at position < pos >. The
+    // reading stops when < nmax > entries are selected. Returns the number of
+    // entries written, and < first > is set to the next entry to process.
+    size_t read( Long64_t &first,
+		 const Long64_t &last,
+		 const size_t &pos,
+		 const size_t &nmax = size_t(-1) );
+
+    // Return the readers of the branches with several values per entry
+    inline const std::vector<JaggedReader*>& getJagged() const;
+
+    // Set the columns where to write the values. They must be the same as
+    // those given on construction.
+    void setColumns( const std::map<std::string, char*> &columns );
+
+    // Return the boundaries of the clusters of the given tree
+    static std::vector<Long64_t> getClusters( TTree *tree );
+
+  protected:
+
+    // Formula to evaluate the cuts
+    TTreeFormula *fFormula;
+
+    // Readers of the branches with several values per entry
+    std::vector<JaggedReader*> fJagged;
+
+    // Readers of each branch, in the same order as the columns
+    std::vector<ColumnReader*> fReaders;
+
+    // Selected entries in the last call to < read >
+    std::vector<Long64_t> fSelected;
+
+    // Tree to read
+    TTree *fTree;
+
+    // Delete the formula and the readers, and enable again all the branches of
+    // the tree
+    void release();
+
+  };
+
+  //_______________________________________________________________________________
+  //
+  inline const std::vector<JaggedReader*>& TreeReader::getJagged() const {
+
+    return fJagged;
+  }
+
+}
+
+#endif
@@ -7,7 +7,7 @@
 //  AUTHOR: Miguel Ramos Pernas
 //  e-mail: miguel.ramos.pernas@cern.ch
 //
-//  Last update: 19/10/2017
+//  Last update: 18/10/2026
 //
 // ----------------------------------------------------------------
 ///////////////////////////////////////////////////////////////////
@@ -15,6 +15,7 @@
 
 #include "GlobalWrappers.hpp"
 #include "NumpyUtils.hpp"
+#include "TreeReader.hpp"
 #include "TreeWrapper.hpp"
 
 #include <Python.h>
@@ -26,24 +27,25 @@
 #include <boost/python/object_operators.hpp>
 #include <boost/python/tuple.hpp>
 
-#include "BufferVariable.hpp"
 #include "Definitions.hpp"
 #include "Messenger.hpp"
+#include "Parallel.hpp"
 #include "RootUtils.hpp"
-#include "TreeBuffer.hpp"
 #include "TreeManagement.hpp"
 #include "Utils.hpp"
 
 #include "TBranch.h"
-#include "TDirectory.h"
-#include "TEventList.h"
 #include "TFile.h"
 #include "TObject.h"
 #include "TPython.h"
+#include "TROOT.h"
 #include "TTree.h"
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -54,27 +56,14 @@ namespace iboost {
 
   //_______________________________________________________________
   //
-  np::ndarray treeToNumpyArray( std::string fpath,
-				std::string tpath,
-				py::object &vars,
-				std::string cuts,
-				bool use_regex ) {
-    
-    // Open the Root file and access the tree
-    TFile *ifile = TFile::Open(fpath.c_str());
-    TTree *itree = static_cast<TTree*>(isis::getSafeObject(ifile, tpath));
-
-    // Extracts the list of events to be used
-    itree->Draw(">>evtlist", cuts.c_str());
-    TEventList *evtlist = (TEventList*) gDirectory->Get("evtlist");
-
-    // Get the branch names to be used
-    itree->SetBranchStatus("*", 0);
+  isis::Strings findBranches( TTree *tree,
+			      py::object &vars,
+			      const bool &use_regex ) {
     
     isis::Strings brnames;
     const py::ssize_t nvars = py::len(vars);
     if ( !nvars )
-      isis::getBranchNames(brnames, itree);
+      isis::getBranchNames(brnames, tree);
     else
       for ( py::ssize_t i = 0; i < nvars; ++i ) {
 
@@ -82,9 +71,9 @@ namespace iboost {
 
 	bool s = true;
 	if ( use_regex )
-	  s = isis::getBranchNames(brnames, itree, var);
+	  s = isis::getBranchNames(brnames, tree, var);
 	else {
-	  if ( itree->GetBranch(var.c_str()) )
+	  if ( tree->GetBranch(var.c_str()) )
 	    brnames.push_back(var);
 	  else
 	    s = false;
@@ -94,49 +83,160 @@ namespace iboost {
 	  IWarning << "No variables have been found following expression < "
 		   << var << " >" << IEndMsg;
       }
+
+    // Remove the duplicated names
+    std::sort(brnames.begin(), brnames.end());
+    brnames.erase(std::unique(brnames.begin(), brnames.end()), brnames.end());
     
-    // Do not swap these two lines, since the path must be set after the
-    // variable is enabled
-    isis::TreeBuffer buffer(itree);
-    for ( const auto br : brnames ) {
+    return brnames;
+  }
+
+  //_______________________________________________________________
+  //
+  std::map<std::string, char> getBranchTypes( TTree *tree,
+					      py::object &vars,
+					      const bool &use_regex ) {
+
+    std::map<std::string, char> types;
+    for ( const auto &br : findBranches(tree, vars, use_regex) ) {
+
+      if ( isis::isScalarBranch(tree, br) )
+	types[br] = isis::getVarType(tree, br);
+      else
+	IWarning << "Branch < " << br << " > does not hold a single value; "
+		 << "use < treeToJaggedArrays > to read it" << IEndMsg;
+    }
+
+    return types;
+  }
+
+  //_______________________________________________________________
+  //
+  py::dict treeToJaggedArrays( std::string fpath,
+			       std::string tpath,
+			       py::object &vars,
+			       std::string cuts,
+			       bool use_regex ) {
+
+    // Open the Root file and access the tree
+    TFile *ifile = TFile::Open(fpath.c_str());
+    TTree *itree = static_cast<TTree*>(isis::getSafeObject(ifile, tpath));
+
+    auto brnames = findBranches(itree, vars, use_regex);
+
+    // The tree is read cluster by cluster
+    auto bounds = TreeReader::getClusters(itree);
+    
+    TreeReader reader(itree, {}, 0, cuts, brnames);
+
+    for ( size_t ic = 0; ic + 1 < bounds.size(); ++ic ) {
+      Long64_t first = bounds[ic];
+      reader.read(first, bounds[ic + 1], 0);
+    }
+
+    // Build the output arrays
+    py::dict output;
+    for ( const auto &r : reader.getJagged() ) {
+
+      const auto &content = r->getContent();
+      const auto &offsets = r->getOffsets();
       
-      itree->SetBranchStatus(br.c_str(), 1);
+      Py_intptr_t csize[1] = {Py_intptr_t(content.size()/r->getSize())};
+      Py_intptr_t osize[1] = {Py_intptr_t(offsets.size())};
+
+      auto carr = np::empty(1, csize, NUMPY_TYPE_CONVERTER.parse_root_type(r->getType()));
+      auto oarr = np::empty(1, osize, np::dtype::get_builtin<isis::llInt>());
+
+      std::memcpy(carr.get_data(), content.data(), content.size());
+      std::memcpy(oarr.get_data(), offsets.data(), offsets.size()*sizeof(Long64_t));
       
-      buffer.loadVariable(br);
+      output[r->getName()] = py::make_tuple(carr, oarr);
     }
+
+    ifile->Close();
+
+    return output;
+  }
+
+  //_______________________________________________________________
+  //
+  np::ndarray treeToNumpyArray( std::string fpath,
+				std::string tpath,
+				py::object &vars,
+				std::string cuts,
+				bool use_regex,
+				size_t nthreads ) {
     
-    // Make the output array
-    auto output = void_ndarray(evtlist->GetN(), buffer);
-    const int nbytes = output.get_dtype().get_itemsize();
+    // Open the Root file and access the tree
+    TFile *ifile = TFile::Open(fpath.c_str());
+    TTree *itree = static_cast<TTree*>(isis::getSafeObject(ifile, tpath));
+
+    auto types = getBranchTypes(itree, vars, use_regex);
+
+    // Make the output array. If cuts are specified, it has space for all
+    // the entries and it is shrunk at the end.
+    const Long64_t nentries = itree->GetEntries();
     
-    // Build the writers
-    std::vector<BuffVarWriter*> outvec;
-    const size_t n = brnames.size();
-    outvec.reserve(n);
-    for ( const auto el: buffer.getMap() ) {
+    auto output = void_ndarray(nentries, types);
+    const size_t nbytes = output.get_dtype().get_itemsize();
 
-      np::ndarray a = py::extract<np::ndarray>(output[el.first]);
-      
-      outvec.push_back(new BuffVarWriter(el.second, a));
-    }
+    auto columns = struct_array_columns(output);
+
+    // The clusters are split among the threads, each of them filling a
+    // different slice of the output array. The values of each cluster are
+    // written starting at the position of its first entry. The calling
+    // thread uses the tree already opened, while the rest open the file
+    // again.
+    auto bounds = TreeReader::getClusters(itree);
     
-    // Calling to < append > is faster than assigning by index
-    for ( int i = 0; i < evtlist->GetN(); ++i ) {
+    const size_t nclusters = bounds.size() - 1;
+    const size_t nt = isis::getNthreads(nthreads, nclusters);
 
-      Long64_t ievt = evtlist->GetEntry(i);
-      itree->GetEntry(ievt);
+    std::vector<size_t> counts(nclusters);
+    
+    if ( nt > 1 )
+      ROOT::EnableThreadSafety();
+    
+    isis::parallelFor(nclusters, nt, [&] ( size_t it, size_t cfirst, size_t clast ) {
+
+	std::unique_ptr<TFile> file;
+
+	TTree *tree = itree;
+	if ( it + 1 != nt ) {
+	  file.reset(TFile::Open(fpath.c_str()));
+	  tree = static_cast<TTree*>(isis::getSafeObject(file.get(), tpath));
+	}
+	
+	{
+	  TreeReader reader(tree, columns, nbytes, cuts);
+
+	  for ( size_t ic = cfirst; ic < clast; ++ic ) {
+	    Long64_t first = bounds[ic];
+	    counts[ic] = reader.read(first, bounds[ic + 1], bounds[ic]);
+	  }
+	}
+	
+	if ( file )
+	  file->Close();
+      });
+
+    // The selected entries of each cluster are moved after those of the
+    // previous clusters, and the array is shrunk
+    char *data = output.get_data();
+    
+    size_t nsel = 0;
+    for ( size_t ic = 0; ic < nclusters; ++ic ) {
+
+      if ( size_t(bounds[ic]) != nsel )
+	std::memmove(data + nsel*nbytes, data + bounds[ic]*nbytes, counts[ic]*nbytes);
       
-      for ( auto &el : outvec )
-	el->appendToArray(i, nbytes);
+      nsel += counts[ic];
     }
 
-    // The branches are enabled again
-    itree->SetBranchStatus("*", 1);
+    if ( Long64_t(nsel) != nentries )
+      resize_ndarray(output, nsel);
+    
     ifile->Close();
-
-    // Delete allocated memory
-    for ( auto &v : outvec )
-      delete v;
     
     return output;
   }
@@ -190,10 +290,6 @@ namespace iboost {
     else if ( !tname.empty() )
       IWarning << "The given tree name is not being used" << IEndMsg;
   
-    // Prepare the variables to iterate with. The vector keeps
-    // track of the types for each variable.
-    isis::TreeBuffer buffer(tree);
-
     auto vars = boostListToStdCont<std::vector, std::string>(variables);
     auto vec_keys = boostListToStdCont<std::vector, std::string>(varkeys);
 
@@ -207,31 +303,48 @@ namespace iboost {
 	brnames.push_back(exp);
     }
 
-    std::vector<BuffVarWriter*> varvec;
-    const size_t n = brnames.size();
-    varvec.reserve(n);
-    for ( const auto &br : brnames )
-      varvec.push_back(new BuffVarWriter( buffer, br,
-					  py::extract<np::ndarray>(vartup[br]))
-		       );
-    
-    // Loop over all the events in the array, the whole number of variables
-    // in the input array must be used to access correctly to the data
-    const py::ssize_t nvals = py::len(vartup);
-    const int nbytes = vartup.get_dtype().get_itemsize();
+    // The branches point to a buffer with the layout of a row of the array,
+    // so each entry is filled copying a whole row, with no dependence on the
+    // types of the variables
+    np::dtype dtype = vartup.get_dtype();
+    py::dict fields = py::extract<py::dict>(dtype.attr("fields"));
+    
+    const size_t nbytes = dtype.get_itemsize();
+    std::vector<char> row(nbytes);
+
+    std::vector<TBranch*> branches;
+    isis::Strings done;
+    for ( const auto &br : brnames ) {
+
+      if ( std::find(done.begin(), done.end(), br) != done.end() )
+	continue;
+      
+      py::tuple field = py::extract<py::tuple>(fields[br]);
+      
+      const char type     = NUMPY_TYPE_CONVERTER.parse_numpy_type(py::extract<np::dtype>(field[0]));
+      const size_t offset = py::extract<size_t>(field[1]);
+
+      branches.push_back(tree->Branch(br.c_str(), row.data() + offset,
+				      (br + '/' + type).c_str()));
+      done.push_back(br);
+    }
+    
+    // Loop over all the events in the array. The array does not need to be
+    // contiguous.
+    const char *data         = vartup.get_data();
+    const Py_intptr_t stride = vartup.strides(0);
+    const py::ssize_t nvals  = py::len(vartup);
     for ( py::ssize_t ievt = 0; ievt < nvals; ++ievt ) {
 
-      // Loop over all the variables in the array
-      for ( auto &v : varvec )
-	v->appendToVar(ievt, nbytes);
+      std::memcpy(row.data(), data + ievt*stride, nbytes);
       
       tree->Fill();
     }
     tree->AutoSave();
 
-    // Delete the allocated memory
-    for ( auto &v : varvec )
-      delete v;
+    // The buffer is going to be deleted
+    for ( auto &b : branches )
+      b->ResetAddress();
     
     // Returns "None"
     return py::object();
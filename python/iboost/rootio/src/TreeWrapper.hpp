@@ -7,7 +7,7 @@
 //  AUTHOR: Miguel Ramos Pernas
 //  e-mail: miguel.ramos.pernas@cern.ch
 //
-//  Last update: 20/09/2017
+//  Last update: 18/10/2026
 //
 // -------------------------------------------------------------------------------
 //
@@ -23,14 +23,12 @@
 #ifndef TREE_WRAPPER_H
 #define TREE_WRAPPER_H
 
-#include "BuffVarWriter.hpp"
 #include "GlobalWrappers.hpp"
 
 #include <boost/python/dict.hpp>
 #include <boost/python/list.hpp>
 #include <boost/python/tuple.hpp>
 
-#include "BufferVariable.hpp"
 #include "Definitions.hpp"
 #include "ValueTypeDef.hpp"
 
@@ -39,6 +37,7 @@
 #include "TTree.h"
 
 #include <iostream>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -47,13 +46,43 @@
 
 namespace iboost {
   
+  // Return the names of the branches of a tree matching the given variables
+  // (all of them if the list is empty)
+  isis::Strings findBranches( TTree *tree,
+			      py::object &vars,
+			      const bool &use_regex );
+  
+  // Return the names and types of the branches of a tree matching the given
+  // variables (all of them if the list is empty). Branches not holding a
+  // single value per entry are skipped.
+  std::map<std::string, char> getBranchTypes( TTree *tree,
+					      py::object &vars,
+					      const bool &use_regex );
+  
+  // Read the branches of a tree with several values per entry (fixed-size
+  // arrays, variable-length arrays and std::vector objects). The result is a
+  // dictionary with a tuple for each branch, with the values of all the
+  // entries one after the other (content) and the position where the values
+  // of each entry start (offsets), which has one more element than the
+  // number of entries. The values of entry < i > are content[offsets[i]:
+  // offsets[i + 1]].
+  py::dict treeToJaggedArrays( std::string fpath,
+			       std::string tpath,
+			       py::object &vars,
+			       std::string cuts = std::string(),
+			       bool use_regex = false );
+  
   // Store in a dictionary the lists with the values for each of the given
-  // variables stored in a Root tree. A set of cuts can be specified.
+  // variables stored in a Root tree. A set of cuts can be specified. The
+  // clusters of the tree can be split among several threads, each of them
+  // opening the file again. If the number of threads is zero, the number of
+  // concurrent threads supported by the machine is used.
   np::ndarray treeToNumpyArray( std::string fpath,
 				std::string tpath,
 				py::object &vars,
 				std::string cuts = std::string(),
-				bool use_regex = false );
+				bool use_regex = false,
+				size_t nthreads = 1 );
   
   // Write a python dictionary to a Root tree. Since in python there are only four
   // numeric types: bool, int, long and float; only the associated c++ types
@@ -7,7 +7,7 @@
 //  AUTHOR: Miguel Ramos Pernas
 //  e-mail: miguel.ramos.pernas@cern.ch
 //
-//  Last update: 20/09/2017
+//  Last update: 18/10/2026
 //
 // -------------------------------------------------------------------------------
 //
@@ -22,12 +22,14 @@
 
 #include "GlobalWrappers.hpp"
 #include "InitModule.hpp"
+#include "TreeChunkIterator.hpp"
 #include "TreeWrapper.hpp"
 
 #include <boost/python.hpp>
 #include <boost/python/dict.hpp>
 #include <boost/python/list.hpp>
 #include <boost/python/numpy.hpp>
+#include <boost/python/object/iterator_core.hpp>
 #include <boost/python/object.hpp>
 #include <boost/python/raw_function.hpp>
 
@@ -39,7 +41,9 @@ namespace ib = iboost;
 //_______________________________________________________________________________
 
 BOOST_PYTHON_FUNCTION_OVERLOADS(treeToNumpyArray_Overloads,
-				ib::treeToNumpyArray, 3, 5);
+				ib::treeToNumpyArray, 3, 6);
+BOOST_PYTHON_FUNCTION_OVERLOADS(treeToJaggedArrays_Overloads,
+				ib::treeToJaggedArrays, 3, 5);
 
 // Definition of the python module
 BOOST_PYTHON_MODULE( rootio ) {
@@ -48,6 +52,18 @@ BOOST_PYTHON_MODULE( rootio ) {
   I_INIT_MODULE;
   
   py::def("treeToArray", ib::treeToNumpyArray, treeToNumpyArray_Overloads());
+  py::def("treeToJaggedArrays", ib::treeToJaggedArrays, treeToJaggedArrays_Overloads());
   py::def("arrayToTree", py::raw_function(ib::numpyArrayToTree, 2));
+
+  // The arrays returned by the iterator remain valid while they are kept,
+  // since a buffer is only reused once no array refers to it
+  py::class_<ib::TreeChunkIterator, boost::noncopyable>
+    ("TreeChunkIterator",
+     py::init<py::object, std::string,
+     py::optional<py::object, size_t, std::string, bool> >())
+    .def("__iter__", py::objects::identity_function())
+    .def("__next__", &ib::TreeChunkIterator::next)
+    .def("next", &ib::TreeChunkIterator::next)
+    ;
   
 }
@@ -7,7 +7,7 @@
 //  AUTHOR: Miguel Ramos Pernas
 //  e-mail: miguel.ramos.pernas@cern.ch
 //
-//  Last update: 19/10/2017
+//  Last update: 18/10/2026
 //
 // -------------------------------------------------------------------------------
 //
@@ -37,6 +37,7 @@
 
 #include <algorithm>
 #include <iostream>
+#include <memory>
 #include <vector>
 
 
@@ -65,6 +66,18 @@ namespace iboost {
     return output;
   }
 
+  //_______________________________________________________________________________
+  // Return a C-contiguous array with the values of the given array converted to
+  // the given type. No copy is done if the array already satisfies these
+  // conditions.
+  template<class type>
+  inline np::ndarray numpyArrayAsContiguous( const np::ndarray &array ) {
+
+    return np::from_object(array, np::dtype::get_builtin<type>(), 0, 0,
+			   np::ndarray::bitflag(np::ndarray::C_CONTIGUOUS |
+						np::ndarray::ALIGNED));
+  }
+
   //_______________________________________________________________________________
   // Transform a python list into a standard container
   template<template<class ...> class cont, class type>
@@ -137,6 +150,36 @@ namespace iboost {
 
     return result;
   }
+
+  //_______________________________________________________________________________
+  // Return a read-only numpy ndarray pointing to the data of the vector held by
+  // the given shared pointer. The array owns a copy of the pointer, so the vector
+  // is kept alive while the array exists. The vector must not be modified while
+  // it is shared.
+  template<class type>
+  inline np::ndarray stdVectorToNumpyView( const std::shared_ptr<const std::vector<type> > &vector ) {
+
+    typedef std::shared_ptr<const std::vector<type> > Pointer;
+
+    Pointer *ptr = new Pointer(vector);
+
+    PyObject *capsule = PyCapsule_New(ptr, 0, [] ( PyObject *obj ) {
+	delete static_cast<Pointer*>(PyCapsule_GetPointer(obj, 0));
+      });
+
+    if ( !capsule ) {
+      delete ptr;
+      py::throw_error_already_set();
+    }
+
+    py::object owner{py::handle<>(capsule)};
+
+    return np::from_data(vector->data(),
+			 np::dtype::get_builtin<type>(),
+			 py::make_tuple(vector->size()),
+			 py::make_tuple(sizeof(type)),
+			 owner);
+  }
 }
 
 #endif
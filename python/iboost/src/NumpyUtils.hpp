@@ -7,7 +7,7 @@
 //  AUTHOR: Miguel Ramos Pernas
 //  e-mail: miguel.ramos.pernas@cern.ch
 //
-//  Last update: 20/09/2017
+//  Last update: 18/10/2026
 //
 // -------------------------------------------------------------------------
 //
@@ -32,6 +32,7 @@
 #include "ValueTypeDef.hpp"
 #include "TreeBuffer.hpp"
 
+#include <map>
 #include <string>
 
 
@@ -61,14 +62,45 @@ namespace iboost {
   }
 
   //_______________________________________________________________________
-  // Return a void (zero filled) numpy array given the size and a tree
-  // buffer
-  inline np::ndarray void_ndarray( const int &n,
-				   const isis::TreeBuffer &buffer ) {
+  // Return the position of the first element of each of the fields of a
+  // structured array
+  inline std::map<std::string, char*> struct_array_columns( const np::ndarray &arr ) {
+
+    std::map<std::string, char*> columns;
+
+    py::list keys = struct_array_keys(arr);
+    for ( py::ssize_t i = 0; i < py::len(keys); ++i ) {
+      
+      std::string name = py::extract<std::string>(keys[i]);
+
+      np::ndarray field = py::extract<np::ndarray>(arr[name]);
+
+      columns[name] = field.get_data();
+    }
+
+    return columns;
+  }
+
+  //_______________________________________________________________________
+  // Resize a one-dimensional array in place. It must own its data and no
+  // other array can be referencing it.
+  inline void resize_ndarray( np::ndarray &arr, const size_t &n ) {
+
+    py::dict kwargs;
+    kwargs["refcheck"] = false;
+      
+    arr.attr("resize")(*py::make_tuple(n), **kwargs);
+  }
+
+  //_______________________________________________________________________
+  // Return a void (zero filled) numpy array given the size and a map with
+  // the names and the types of the fields
+  inline np::ndarray void_ndarray( const Py_intptr_t &n,
+				   const std::map<std::string, char> &types ) {
 
     py::list dtypes;
-    for ( const auto &el : buffer.getMap() ) {
-      auto t = NUMPY_TYPE_CONVERTER.parse_root_type(el.second->getType());
+    for ( const auto &el : types ) {
+      auto t = NUMPY_TYPE_CONVERTER.parse_root_type(el.second);
       dtypes.append(py::make_tuple(el.first, t));
     }
     
@@ -77,6 +109,19 @@ namespace iboost {
     
     return np::zeros(1, shape, tp);
   }
+
+  //_______________________________________________________________________
+  // Return a void (zero filled) numpy array given the size and a tree
+  // buffer
+  inline np::ndarray void_ndarray( const Py_intptr_t &n,
+				   const isis::TreeBuffer &buffer ) {
+
+    std::map<std::string, char> types;
+    for ( const auto &el : buffer.getMap() )
+      types[el.first] = el.second->getType();
+    
+    return void_ndarray(n, types);
+  }
 }
 
 #endif